@@ -0,0 +1,63 @@
+/*
+ * Throughput of ComputeBatch() on many small independent diagrams, from one
+ * worker up to one per hardware thread.
+ *
+ * $ ./bin/batch_benchmark [diagrams] [sites per diagram]
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <voronoi/voronoi.hh>
+
+using namespace voronoi;
+
+static double frand(double fmin, double fmax)
+{
+	double f = (double) rand() / RAND_MAX;
+	return fmin + f * (fmax - fmin);
+}
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now()
+			- start;
+	return elapsed.count();
+}
+
+int main(int argc, char* argv[])
+{
+	size_t diagrams = argc > 1 ? atol(argv[1]) : 20000;
+	size_t sites = argc > 2 ? atol(argv[2]) : 100;
+	unsigned int cores = std::thread::hardware_concurrency();
+	std::vector<std::vector<Point> > inputs(diagrams);
+	double base = 0;
+
+	srand(1);
+	for (size_t i = 0; i < diagrams; i++)
+		for (size_t j = 0; j < sites; j++)
+			inputs[i].push_back(Point(frand(0, 1000), frand(0, 1000)));
+	std::vector<Span<const Point> > spans(inputs.begin(), inputs.end());
+
+	printf("%8s %16s %8s\n", "threads", "diagrams/s", "speedup");
+	for (unsigned int threads = 1; threads <= (cores ? cores : 1);
+			threads *= 2) {
+		BatchEngine batch(threads);
+		std::vector<VoronoiDCEL> outputs;
+
+		/* Warm up the engines and the outputs once. */
+		batch.Compute(spans, outputs);
+		std::chrono::steady_clock::time_point start =
+				std::chrono::steady_clock::now();
+		batch.Compute(spans, outputs);
+		double rate = diagrams / Seconds(start);
+		if (threads == 1)
+			base = rate;
+		printf("%8u %16.0f %7.2fx\n", threads, rate, rate / base);
+		if (threads < cores && threads * 2 > cores)
+			threads = cores / 2;
+	}
+	return 0;
+}
@@ -0,0 +1,166 @@
+/*
+ * Cost of the three beach line operations, finding the arc above a site,
+ * inserting a site and removing an arc at a circle event, for the
+ * red-black tree and the flat array, over a few site distributions.  The
+ * band keeps nearly every site on the beach line, which is quadratic for
+ * the flat array: keep the count moderate.  Each site event is located
+ * twice, by ArcAbove() and then by the insertion, as in an incremental
+ * build that looks before it inserts.
+ *
+ * $ ./bin/beachline_benchmark [sites]
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <voronoi/voronoi.hh>
+
+using namespace voronoi;
+
+static double frand(double fmin, double fmax)
+{
+	double f = (double) rand() / RAND_MAX;
+	return fmin + f * (fmax - fmin);
+}
+
+static void Uniform(std::vector<Point>& sites, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		sites.push_back(Point(frand(0, 1000), frand(0, 1000)));
+}
+
+/*
+ * Twenty blobs, each a sum of uniforms around its center.
+ */
+static void Clustered(std::vector<Point>& sites, size_t count)
+{
+	std::vector<Point> centers;
+
+	for (size_t i = 0; i < 20; i++)
+		centers.push_back(Point(frand(100, 900), frand(100, 900)));
+	for (size_t i = 0; i < count; i++) {
+		const Point& c = centers[i % centers.size()];
+		double dx = frand(-20, 20) + frand(-20, 20) + frand(-20, 20);
+		double dy = frand(-20, 20) + frand(-20, 20) + frand(-20, 20);
+		sites.push_back(Point(c.x() + dx, c.y() + dy));
+	}
+}
+
+static void Diagonal(std::vector<Point>& sites, size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		double t = frand(0, 1000);
+		sites.push_back(Point(t + frand(-1, 1), t + frand(-1, 1)));
+	}
+}
+
+/*
+ * Sites in a thin horizontal band: most of them stay on the beach line.
+ */
+static void Band(std::vector<Point>& sites, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		sites.push_back(Point(frand(0, 1000), frand(0, 1)));
+}
+
+/*
+ * Sites on a hundred rows, as snapped or gridded data gives: the sites of
+ * a row share the sweep position of every search.
+ */
+static void Rows(std::vector<Point>& sites, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		sites.push_back(Point(frand(0, 1000), (double) (rand() % 100) * 10));
+}
+
+struct Timing {
+	double locate; /**< Nanoseconds per ArcAbove() */
+	double insert; /**< Nanoseconds per site event */
+	double remove; /**< Nanoseconds per circle event */
+	size_t circles;
+	size_t splits; /**< Sites below the arc they split, not beside it */
+};
+
+static double Nanoseconds(std::chrono::steady_clock::time_point start)
+{
+	std::chrono::duration<double, std::nano> elapsed =
+			std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+/*
+ * Drive the sweep by hand so that each operation is timed on its own.
+ * The clock is read around each call, so every figure includes its cost.
+ */
+template <class Backend>
+static Timing Run(std::vector<Point>& sites)
+{
+	std::vector<Point*> pointers;
+	Timing timing = { 0, 0, 0, 0, 0 };
+
+	for (size_t i = 0; i < sites.size(); i++)
+		pointers.push_back(&sites[i]);
+	VoronoiQueue queue(pointers);
+	VoronoiDCEL dcel;
+	Backend line(&queue, &dcel);
+	line.set_sites(&sites[0]);
+	line.ReserveNodes(4 * sites.size());
+
+	while (!queue.empty()) {
+		std::chrono::steady_clock::time_point start;
+		if (queue.isSiteNext()) {
+			Point* site = queue.site();
+			queue.pop();
+			start = std::chrono::steady_clock::now();
+			const Point* above = line.ArcAbove(site);
+			timing.locate += Nanoseconds(start);
+			if (above != NULL && above->y() != site->y())
+				timing.splits++;
+			start = std::chrono::steady_clock::now();
+			line.InsertParabola(site);
+			timing.insert += Nanoseconds(start);
+		} else {
+			CircleEvent event = queue.circle();
+			queue.pop();
+			start = std::chrono::steady_clock::now();
+			line.RemoveParabola(event);
+			timing.remove += Nanoseconds(start);
+			timing.circles++;
+		}
+	}
+	line.FinishEdges();
+	timing.locate /= sites.size();
+	timing.insert /= sites.size();
+	timing.remove /= timing.circles ? timing.circles : 1;
+	return timing;
+}
+
+static void Report(const char* name, const char* backend, const Timing& t)
+{
+	printf("%10s %6s %10.1f %10.1f %10.1f %10lu %10lu\n", name, backend,
+			t.locate, t.insert, t.remove, (unsigned long) t.circles,
+			(unsigned long) t.splits);
+}
+
+int main(int argc, char* argv[])
+{
+	size_t count = argc > 1 ? atol(argv[1]) : 20000;
+	struct {
+		const char* name;
+		void (*generate)(std::vector<Point>&, size_t);
+	} inputs[] = { { "uniform", Uniform }, { "clustered", Clustered }, {
+			"diagonal", Diagonal }, { "band", Band }, { "rows", Rows } };
+
+	printf("%10s %6s %10s %10s %10s %10s %10s\n", "input", "line",
+			"locate ns", "insert ns", "remove ns", "circles", "splits");
+	for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+		std::vector<Point> sites;
+
+		srand(1);
+		inputs[i].generate(sites, count);
+		Report(inputs[i].name, "tree", Run<VoronoiTree>(sites));
+		Report(inputs[i].name, "flat", Run<FlatBeachLine>(sites));
+	}
+	return 0;
+}
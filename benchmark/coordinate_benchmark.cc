@@ -0,0 +1,100 @@
+/*
+ * Size of a diagram in double and in float, and the time of a pass that
+ * reads every edge the way a renderer would, over each of them.
+ *
+ * $ ./bin/coordinate_benchmark [sites] [passes]
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <voronoi/voronoi.hh>
+
+using namespace voronoi;
+
+static double frand(double fmin, double fmax)
+{
+	double f = (double) rand() / RAND_MAX;
+	return fmin + f * (fmax - fmin);
+}
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now()
+			- start;
+	return elapsed.count();
+}
+
+/*
+ * Total length of the finite edges, read straight from the flat arrays.
+ */
+template <class Coordinate>
+static double DrawEdges(const BasicVoronoiDCEL<Coordinate>& diagram)
+{
+	const std::vector<DiagramEdge>& edges = diagram.edges();
+	const Coordinate* xy = &diagram.coordinates()[0];
+	double length = 0;
+
+	for (size_t i = 0; i < edges.size(); i++) {
+		if (edges[i].origin_at_infinity || edges[i].destination_at_infinity)
+			continue;
+		Coordinate dx = xy[2 * edges[i].destination] - xy[2 * edges[i].origin];
+		Coordinate dy = xy[2 * edges[i].destination + 1]
+				- xy[2 * edges[i].origin + 1];
+		length += std::sqrt(dx * dx + dy * dy);
+	}
+	return length;
+}
+
+/*
+ * Print one row and return the seconds per pass.
+ */
+template <class Coordinate>
+static double Report(const char* name,
+		const BasicVoronoiDCEL<Coordinate>& diagram, size_t passes,
+		double base)
+{
+	size_t bytes = diagram.coordinates().size() * sizeof(Coordinate)
+			+ diagram.edges().size() * sizeof(DiagramEdge)
+			+ diagram.vertex_sites().size() * sizeof(VertexSites);
+	double length = 0;
+
+	std::chrono::steady_clock::time_point start =
+			std::chrono::steady_clock::now();
+	for (size_t i = 0; i < passes; i++)
+		length += DrawEdges(diagram);
+	double seconds = Seconds(start) / passes;
+	printf("%8s %12.1f %12.3f %7.2fx %16.1f\n", name, bytes / 1048576.0,
+			seconds * 1000, base > 0 ? base / seconds : 1.0,
+			length / passes);
+	return seconds;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t count = argc > 1 ? atol(argv[1]) : 1000000;
+	size_t passes = argc > 2 ? atol(argv[2]) : 20;
+	std::vector<Point> sites;
+	Engine engine;
+	FloatCopyDCEL narrow;
+
+	srand(1);
+	for (size_t i = 0; i < count; i++)
+		sites.push_back(Point(frand(0, 1000), frand(0, 1000)));
+
+	std::chrono::steady_clock::time_point start =
+			std::chrono::steady_clock::now();
+	const VoronoiDCEL& diagram = engine.compute(Span<const Point>(sites));
+	printf("sweep %.3f s", Seconds(start));
+	start = std::chrono::steady_clock::now();
+	narrow.Assign(diagram);
+	printf(", to float %.3f s\n", Seconds(start));
+
+	printf("%8s %12s %12s %8s %16s\n", "type", "MiB", "ms/pass", "speedup",
+			"edge length");
+	double base = Report("double", diagram, passes, 0);
+	Report("float", narrow, passes, base);
+	return 0;
+}
@@ -0,0 +1,69 @@
+/*
+ * Cost of adding and taking out single sites of a large diagram, against
+ * sweeping it again from scratch.
+ *
+ * $ ./bin/dynamic_benchmark [sites] [changes]
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <voronoi/voronoi.hh>
+
+using namespace voronoi;
+
+static double frand(double fmin, double fmax)
+{
+	double f = (double) rand() / RAND_MAX;
+	return fmin + f * (fmax - fmin);
+}
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now()
+			- start;
+	return elapsed.count();
+}
+
+int main(int argc, char* argv[])
+{
+	size_t count = argc > 1 ? atol(argv[1]) : 1000000;
+	size_t changes = argc > 2 ? atol(argv[2]) : 10000;
+	std::vector<Point> sites;
+	DynamicDiagram dynamic;
+	Engine engine;
+	size_t changed = 0;
+
+	srand(1);
+	for (size_t i = 0; i < count; i++)
+		sites.push_back(Point(frand(0, 1000), frand(0, 1000)));
+
+	std::chrono::steady_clock::time_point start =
+			std::chrono::steady_clock::now();
+	engine.compute(Span<const Point>(sites));
+	double sweep = Seconds(start);
+	start = std::chrono::steady_clock::now();
+	dynamic.Build(Span<const Point>(sites));
+	double build = Seconds(start);
+
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < changes; i++) {
+		dynamic.InsertSite(Point(frand(0, 1000), frand(0, 1000)));
+		changed += dynamic.changed_sites().size();
+	}
+	double insert = Seconds(start) / changes;
+
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < changes; i++) {
+		dynamic.RemoveSite(rand() % dynamic.site_count());
+		changed += dynamic.changed_sites().size();
+	}
+	double remove = Seconds(start) / changes;
+
+	printf("sweep %.3f s, build %.3f s\n", sweep, build);
+	printf("insert %.2f us, remove %.2f us, %.1f cells changed each, "
+			"%.0fx faster than a sweep\n", insert * 1e6, remove * 1e6,
+			(double) changed / (2 * changes), sweep * 2 / (insert + remove));
+	return 0;
+}
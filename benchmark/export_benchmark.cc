@@ -0,0 +1,71 @@
+/*
+ * SVG and GeoJSON export of a clipped diagram, on one thread and on every
+ * thread.
+ *
+ * $ ./bin/export_benchmark [sites] [file]
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+#include <voronoi/voronoi.hh>
+
+using namespace voronoi;
+
+static double frand(double fmin, double fmax)
+{
+	double f = (double) rand() / RAND_MAX;
+	return fmin + f * (fmax - fmin);
+}
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now()
+			- start;
+	return elapsed.count();
+}
+
+static double Megabytes(const char* path)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	return file.tellg() / 1e6;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t count = argc > 1 ? atol(argv[1]) : 1000000;
+	const char* path = argc > 2 ? argv[2] : "export_benchmark.out";
+	std::vector<Point> sites;
+	Engine engine;
+	ClippedDiagram clipped;
+	BoundingBox box(0, 0, 1000, 1000);
+
+	srand(1);
+	for (size_t i = 0; i < count; i++)
+		sites.push_back(Point(frand(0, 1000), frand(0, 1000)));
+	engine.compute(Span<const Point>(sites));
+	clipped.Clip(engine.diagram(), Span<const Point>(sites), box);
+
+	printf("%-8s %8s %12s %12s\n", "", "MB", "1 thread", "threads");
+	for (int format = 0; format < 2; format++) {
+		double seconds[2];
+		for (int parallel = 0; parallel < 2; parallel++) {
+			std::chrono::steady_clock::time_point start =
+					std::chrono::steady_clock::now();
+			if (format == 0)
+				WriteSvg(path, clipped, box, Span<const Point>(sites),
+						parallel ? 0 : 1);
+			else
+				WriteGeoJson(path, clipped, parallel ? 0 : 1);
+			seconds[parallel] = Seconds(start);
+		}
+		double megabytes = Megabytes(path);
+		printf("%-8s %8.1f %9.0f MB/s %7.0f MB/s\n",
+				format == 0 ? "svg" : "geojson", megabytes,
+				megabytes / seconds[0], megabytes / seconds[1]);
+	}
+	remove(path);
+	return 0;
+}
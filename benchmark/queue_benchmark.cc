@@ -0,0 +1,143 @@
+/*
+ * Compares the cost per event of the sweep schedulers.  The legacy one keeps
+ * every site and circle event in a single pointer heap; VoronoiQueue sorts
+ * the sites once and only heaps the circle events.
+ *
+ * $ ./bin/queue_benchmark [max sites]
+ *
+ * Each popped site pushes two circle events a little below the sweep line,
+ * which is about the traffic Fortune's algorithm generates.
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include <voronoi/voronoi.hh>
+
+using namespace voronoi;
+
+typedef std::priority_queue<Point*, std::vector<Point*>, ComparePoint>
+		LegacyQueue;
+
+static double frand(double fmin, double fmax)
+{
+	double f = (double) rand() / RAND_MAX;
+	return fmin + f * (fmax - fmin);
+}
+
+static void Push(LegacyQueue& queue, std::vector<Point>& circles,
+		const Point& event)
+{
+	/* The legacy queue holds pointers: keep the events alive outside. */
+	circles.push_back(event);
+	queue.push(&circles.back());
+}
+
+static void Push(VoronoiQueue& queue, std::vector<Point>& /*circles*/,
+		const Point& event)
+{
+	CircleEvent circle = { event.x(), event.y(), kNullNode };
+	queue.push(circle);
+}
+
+/*
+ * Pop the next event into |y| and tell whether it was a site.  The legacy
+ * queue cannot say: its circle events are the ones kept in |circles|.
+ */
+static bool PopSite(LegacyQueue& queue, const std::vector<Point>& circles,
+		double& y)
+{
+	const Point* p = queue.top();
+	std::less<const Point*> before;
+	bool site = circles.empty() || before(p, &circles.front())
+			|| before(&circles.back(), p);
+
+	y = p->y();
+	queue.pop();
+	return site;
+}
+
+static bool PopSite(VoronoiQueue& queue, const std::vector<Point>& /*circles*/,
+		double& y)
+{
+	bool site = queue.isSiteNext();
+
+	y = queue.top().y();
+	queue.pop();
+	return site;
+}
+
+/*
+ * Drain the queue, feeding circle events back as the sites go by.  The
+ * circle event storage is preallocated so only the scheduler is measured.
+ */
+template<class Queue>
+static size_t Drain(Queue& queue, std::vector<Point>& circles, double spacing)
+{
+	size_t events = 0;
+	Point circle;
+
+	while (!queue.empty()) {
+		double y;
+		bool site = PopSite(queue, circles, y);
+		events++;
+		if (!site)
+			continue;
+		for (int i = 0; i < 2; i++) {
+			circle.set_y(y - frand(0, 8 * spacing));
+			Push(queue, circles, circle);
+		}
+	}
+	return events;
+}
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now()
+			- start;
+	return elapsed.count();
+}
+
+int main(int argc, char* argv[])
+{
+	size_t max_sites = argc > 1 ? atol(argv[1]) : 10000000;
+
+	printf("%10s %14s %14s %8s\n", "sites", "legacy ns/ev", "sorted ns/ev",
+			"speedup");
+	for (size_t n = 100000; n <= max_sites; n *= 10) {
+		std::vector<Point*> sites;
+		std::vector<Point> circles;
+		double spacing = 1000.0 / n;
+
+		srand(n);
+		sites.reserve(n);
+		circles.reserve(2 * n);
+		for (size_t i = 0; i < n; i++)
+			sites.push_back(new Point(frand(0, 1000), frand(0, 1000)));
+
+		srand(1);
+		std::chrono::steady_clock::time_point start =
+				std::chrono::steady_clock::now();
+		LegacyQueue legacy;
+		for (size_t i = 0; i < n; i++)
+			legacy.push(sites[i]);
+		size_t events = Drain(legacy, circles, spacing);
+		double legacy_ns = Seconds(start) * 1e9 / events;
+
+		srand(1);
+		start = std::chrono::steady_clock::now();
+		VoronoiQueue sorted(sites);
+		events = Drain(sorted, circles, spacing);
+		double sorted_ns = Seconds(start) * 1e9 / events;
+
+		printf("%10zu %14.1f %14.1f %7.2fx\n", n, legacy_ns, sorted_ns,
+				legacy_ns / sorted_ns);
+
+		for (size_t i = 0; i < n; i++)
+			delete sites[i];
+	}
+	return 0;
+}
@@ -0,0 +1,123 @@
+/*
+ * Load on a DiagramServer: each client thread keeps one request in flight
+ * on its own connection.  Prints the latency percentiles and throughput.
+ * Without a socket, a server is started in this process first.
+ *
+ * $ ./bin/server_benchmark [clients] [requests per client] [sites] [socket]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include <voronoi/voronoi.hh>
+
+using namespace voronoi;
+
+static double frand(double fmin, double fmax)
+{
+	double f = (double) rand() / RAND_MAX;
+	return fmin + f * (fmax - fmin);
+}
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now()
+			- start;
+	return elapsed.count();
+}
+
+static void Client(const char* path, const std::vector<Point>* sites,
+		size_t requests, std::vector<double>* latencies, char* failed)
+{
+	DiagramClient client;
+
+	if (!client.Connect(path)) {
+		*failed = 1;
+		return;
+	}
+	for (size_t i = 0; i < requests; i++) {
+		std::chrono::steady_clock::time_point start =
+				std::chrono::steady_clock::now();
+		if (!client.Compute(*sites)) {
+			*failed = 1;
+			return;
+		}
+		latencies->push_back(Seconds(start));
+	}
+}
+
+static void Serve(DiagramServer* server)
+{
+	server->Run();
+}
+
+int main(int argc, char* argv[])
+{
+	size_t clients = argc > 1 ? atol(argv[1]) : 16;
+	size_t requests = argc > 2 ? atol(argv[2]) : 2000;
+	size_t count = argc > 3 ? atol(argv[3]) : 100;
+	std::string path = argc > 4 ? argv[4]
+			: "/tmp/voronoi_benchmark." + std::to_string(getpid());
+	DiagramServer server;
+	std::thread serving;
+
+	if (argc <= 4) {
+		if (!server.Listen(path.c_str())) {
+			fprintf(stderr, "%s: cannot listen\n", path.c_str());
+			return 1;
+		}
+		serving = std::thread(Serve, &server);
+	}
+
+	srand(1);
+	std::vector<std::vector<Point> > sites(clients);
+	for (size_t i = 0; i < clients; i++)
+		for (size_t j = 0; j < count; j++)
+			sites[i].push_back(Point(frand(0, 1000), frand(0, 1000)));
+
+	std::vector<std::vector<double> > latencies(clients);
+	std::vector<char> failed(clients);
+	std::vector<std::thread> threads;
+	std::chrono::steady_clock::time_point start =
+			std::chrono::steady_clock::now();
+	for (size_t i = 0; i < clients; i++)
+		threads.push_back(std::thread(Client, path.c_str(), &sites[i],
+				requests, &latencies[i], &failed[i]));
+	for (size_t i = 0; i < clients; i++)
+		threads[i].join();
+	double elapsed = Seconds(start);
+
+	if (serving.joinable()) {
+		server.Stop();
+		serving.join();
+	}
+
+	std::vector<double> all;
+	for (size_t i = 0; i < clients; i++) {
+		if (failed[i])
+			fprintf(stderr, "client %zu failed\n", i);
+		all.insert(all.end(), latencies[i].begin(), latencies[i].end());
+	}
+	if (all.empty())
+		return 1;
+	std::sort(all.begin(), all.end());
+
+	printf("%zu clients, %zu sites per request\n", clients, count);
+	printf("%12s %12s %12s %12s\n", "requests/s", "p50 (us)", "p99 (us)",
+			"max (us)");
+	printf("%12.0f %12.1f %12.1f %12.1f\n", all.size() / elapsed,
+			all[all.size() / 2] * 1e6, all[all.size() * 99 / 100] * 1e6,
+			all.back() * 1e6);
+	if (argc <= 4) {
+		ServerStats stats = server.stats();
+		printf("%zu batches, %.1f requests per batch, largest %zu\n",
+				stats.batches, (double) stats.requests / stats.batches,
+				stats.largest_batch);
+	}
+	return all.size() == clients * requests ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+/*
+ * Streaming sweep over sites that arrive already sorted, against Engine over
+ * the same sites held in memory.  Prints the time per site and the most
+ * beach line nodes, points and sites held at once.
+ *
+ * $ ./bin/stream_benchmark [sites] [width]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <voronoi/voronoi.hh>
+
+using namespace voronoi;
+
+static double frand(double fmin, double fmax)
+{
+	double f = (double) rand() / RAND_MAX;
+	return fmin + f * (fmax - fmin);
+}
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now()
+			- start;
+	return elapsed.count();
+}
+
+static bool SweepOrder(const Point& a, const Point& b)
+{
+	if (a.y() != b.y())
+		return a.y() > b.y();
+	return a.x() < b.x();
+}
+
+int main(int argc, char* argv[])
+{
+	size_t count = argc > 1 ? atol(argv[1]) : 1000000;
+	double width = argc > 2 ? atof(argv[2]) : 1000;
+	std::vector<Point> sites;
+	size_t edges = 0;
+	size_t beach_line = 0;
+	size_t held = 0;
+
+	/* One site per unit of area, in a band |width| wide. */
+	srand(1);
+	for (size_t i = 0; i < count; i++)
+		sites.push_back(Point(frand(0, width), frand(0, count / width)));
+	std::sort(sites.begin(), sites.end(), SweepOrder);
+
+	StreamingSweep stream([](uint64_t, const Point&, const VertexSites&) {},
+			[&edges](const StreamEdge&) { edges++; });
+	std::chrono::steady_clock::time_point start =
+			std::chrono::steady_clock::now();
+	for (size_t i = 0; i < count; i++) {
+		stream.AddSite(sites[i]);
+		beach_line = std::max(beach_line, stream.beach_line_size());
+		held = std::max(held, stream.held_points() + stream.held_sites());
+	}
+	stream.Finish();
+	double streamed = Seconds(start);
+
+	Engine engine;
+	start = std::chrono::steady_clock::now();
+	engine.compute(Span<const Point>(sites));
+	double swept = Seconds(start);
+
+	printf("%-8s %10s %10s %12s %12s\n", "", "ns/site", "edges",
+			"beach line", "held");
+	printf("%-8s %10.1f %10zu %12zu %12zu\n", "stream", streamed * 1e9 / count,
+			edges, beach_line, held);
+	printf("%-8s %10.1f %10zu %12zu %12zu\n", "engine", swept * 1e9 / count,
+			engine.diagram().edges().size(), (size_t) 0,
+			engine.diagram().point_count() + count);
+	return 0;
+}
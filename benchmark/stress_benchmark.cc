@@ -0,0 +1,181 @@
+/*
+ * Latency of each event of the tree sweep over inputs that are hard on the
+ * beach line: sorted diagonals and near-collinear lines keep every site on
+ * it, and a circle sends every arc to the same vertex.  Prints the median,
+ * tail and worst event and the deepest arc found, then runs each input
+ * again on a thread with a small stack.
+ *
+ * $ ./bin/stress_benchmark [sites] [stack KiB]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <pthread.h>
+#include <vector>
+
+#include <voronoi/voronoi.hh>
+
+using namespace voronoi;
+
+static double frand(double fmin, double fmax)
+{
+	double f = (double) rand() / RAND_MAX;
+	return fmin + f * (fmax - fmin);
+}
+
+static void Uniform(std::vector<Point>& sites, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		sites.push_back(Point(frand(0, 1000), frand(0, 1000)));
+}
+
+static void Diagonal(std::vector<Point>& sites, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		sites.push_back(Point(i, i));
+}
+
+/*
+ * Almost flat line, each site a hair off it.
+ */
+static void NearLine(std::vector<Point>& sites, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		sites.push_back(Point(i, i * 1e-3 + frand(0, 1e-9)));
+}
+
+static void Horizontal(std::vector<Point>& sites, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		sites.push_back(Point(i, 0));
+}
+
+static void Circle(std::vector<Point>& sites, size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		double angle = 2 * M_PI * i / count;
+		sites.push_back(Point(1000 * cos(angle), 1000 * sin(angle)));
+	}
+}
+
+static double Nanoseconds(std::chrono::steady_clock::time_point start)
+{
+	std::chrono::duration<double, std::nano> elapsed =
+			std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+static size_t Depth(const Node* node)
+{
+	size_t depth = 0;
+
+	for (; !node->isRoot(); node = node->parent())
+		depth++;
+	return depth;
+}
+
+static void Sweep(std::vector<Point>& sites, std::vector<double>& latency,
+		size_t* depth)
+{
+	std::vector<Point*> pointers;
+
+	for (size_t i = 0; i < sites.size(); i++)
+		pointers.push_back(&sites[i]);
+	VoronoiQueue queue(pointers);
+	VoronoiDCEL dcel;
+	VoronoiTree tree(&queue, &dcel);
+	tree.set_sites(&sites[0]);
+	tree.ReserveNodes(4 * sites.size());
+
+	*depth = 0;
+	while (!queue.empty()) {
+		std::chrono::steady_clock::time_point start =
+				std::chrono::steady_clock::now();
+		if (queue.isSiteNext()) {
+			Point* site = queue.site();
+			Status status(site);
+			queue.pop();
+			if (!tree.isEmpty())
+				*depth = std::max(*depth, Depth(tree.FindParabola(status)));
+			start = std::chrono::steady_clock::now();
+			tree.InsertParabola(site);
+		} else {
+			CircleEvent event = queue.circle();
+			queue.pop();
+			tree.RemoveParabola(event);
+		}
+		latency.push_back(Nanoseconds(start));
+	}
+	tree.FinishEdges();
+}
+
+struct Job {
+	std::vector<Point>* sites;
+	size_t edges;
+};
+
+static void* Compute(void* argument)
+{
+	Job* job = static_cast<Job*>(argument);
+	Engine engine;
+
+	job->edges = engine.compute(Span<const Point>(*job->sites)).edges().size();
+	return NULL;
+}
+
+/*
+ * Sweep |sites| with an Engine on a thread whose stack is |bytes| long.
+ */
+static bool ComputeOnSmallStack(std::vector<Point>& sites, size_t bytes)
+{
+	Job job = { &sites, 0 };
+	pthread_attr_t attributes;
+	pthread_t thread;
+
+	pthread_attr_init(&attributes);
+	pthread_attr_setstacksize(&attributes, bytes);
+	int error = pthread_create(&thread, &attributes, Compute, &job);
+	pthread_attr_destroy(&attributes);
+	if (error != 0)
+		return false;
+	pthread_join(thread, NULL);
+	return job.edges > 0;
+}
+
+static double Percentile(const std::vector<double>& sorted, double fraction)
+{
+	return sorted[(size_t) (fraction * (sorted.size() - 1))];
+}
+
+int main(int argc, char* argv[])
+{
+	size_t count = argc > 1 ? atol(argv[1]) : 200000;
+	size_t stack = (argc > 2 ? atol(argv[2]) : 64) * 1024;
+	struct {
+		const char* name;
+		void (*generate)(std::vector<Point>&, size_t);
+	} inputs[] = { { "uniform", Uniform }, { "diagonal", Diagonal }, {
+			"nearline", NearLine }, { "horizontal", Horizontal }, { "circle",
+			Circle } };
+
+	printf("%10s %9s %9s %9s %11s %6s %6s\n", "input", "p50 ns", "p99 ns",
+			"p99.9 ns", "max ns", "depth", "stack");
+	for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+		std::vector<Point> sites;
+		std::vector<double> latency;
+		size_t depth;
+
+		srand(1);
+		inputs[i].generate(sites, count);
+		Sweep(sites, latency, &depth);
+		std::sort(latency.begin(), latency.end());
+		printf("%10s %9.0f %9.0f %9.0f %11.0f %6lu %6s\n", inputs[i].name,
+				Percentile(latency, 0.5), Percentile(latency, 0.99),
+				Percentile(latency, 0.999), latency.back(),
+				(unsigned long) depth,
+				ComputeOnSmallStack(sites, stack) ? "ok" : "failed");
+	}
+	return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * Wall time of one large diagram swept in parallel strips against the
+ * sequential sweep, from one strip up to one per hardware thread.
+ *
+ * $ ./bin/strip_benchmark [sites]
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <voronoi/voronoi.hh>
+
+using namespace voronoi;
+
+static double frand(double fmin, double fmax)
+{
+	double f = (double) rand() / RAND_MAX;
+	return fmin + f * (fmax - fmin);
+}
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now()
+			- start;
+	return elapsed.count();
+}
+
+int main(int argc, char* argv[])
+{
+	size_t count = argc > 1 ? atol(argv[1]) : 1000000;
+	unsigned int cores = std::thread::hardware_concurrency();
+	std::vector<Point> sites;
+	Engine sequential;
+
+	srand(1);
+	for (size_t i = 0; i < count; i++)
+		sites.push_back(Point(frand(0, 1000), frand(0, 1000)));
+	Span<const Point> input(sites);
+
+	std::chrono::steady_clock::time_point start =
+			std::chrono::steady_clock::now();
+	sequential.compute(input);
+	double base = Seconds(start);
+	printf("%8s %10s %8s %8s %8s\n", "threads", "seconds", "speedup",
+			"sweeps", "same");
+	printf("%8s %10.3f %7.2fx %8u %8s\n", "seq", base, 1.0, 1U, "-");
+
+	for (unsigned int threads = 1; threads <= (cores ? cores : 1);
+			threads *= 2) {
+		StripEngine strips(threads);
+		VoronoiDCEL output;
+
+		start = std::chrono::steady_clock::now();
+		strips.Compute(input, output);
+		double seconds = Seconds(start);
+		printf("%8u %10.3f %7.2fx %8lu %8s\n", threads, seconds,
+				base / seconds, (unsigned long) strips.stats().sweeps,
+				EquivalentDiagrams(output, sequential.diagram(), 1e-9) ? "yes"
+						: "NO");
+		if (threads < cores && threads * 2 > cores)
+			threads = cores / 2;
+	}
+	return 0;
+}
@@ -0,0 +1,79 @@
+/*
+ * Text coordinate files: writing with std::to_chars and reading with
+ * std::from_chars on one and on every thread, against std::stringstream.
+ *
+ * $ ./bin/text_benchmark [coordinates] [file]
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <voronoi/voronoi.hh>
+
+using namespace voronoi;
+
+static double frand(double fmin, double fmax)
+{
+	double f = (double) rand() / RAND_MAX;
+	return fmin + f * (fmax - fmin);
+}
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now()
+			- start;
+	return elapsed.count();
+}
+
+int main(int argc, char* argv[])
+{
+	size_t count = argc > 1 ? atol(argv[1]) : 20000000;
+	const char* path = argc > 2 ? argv[2] : "text_benchmark.txt";
+	std::vector<double> values, loaded;
+
+	srand(1);
+	for (size_t i = 0; i < count; i++)
+		values.push_back(frand(0, 1000));
+
+	std::chrono::steady_clock::time_point start =
+			std::chrono::steady_clock::now();
+	if (!WriteNumbers(path, &values[0], count, 2)) {
+		fprintf(stderr, "%s: cannot write\n", path);
+		return 1;
+	}
+	double write = Seconds(start);
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	double megabytes = file.tellg() / 1e6;
+
+	start = std::chrono::steady_clock::now();
+	ReadNumbers(path, loaded, 1);
+	double single = Seconds(start);
+	loaded.clear();
+	start = std::chrono::steady_clock::now();
+	ReadNumbers(path, loaded);
+	double parallel = Seconds(start);
+
+	start = std::chrono::steady_clock::now();
+	file.seekg(0);
+	std::stringstream text;
+	text << file.rdbuf();
+	std::vector<double> streamed;
+	double value;
+	while (text >> value)
+		streamed.push_back(value);
+	double stringstream = Seconds(start);
+
+	printf("%.1f MB, %zu coordinates, read back %s\n", megabytes, count,
+			loaded == values && streamed.size() == count ? "equal"
+					: "DIFFERENT");
+	printf("%-16s %10s\n", "", "MB/s");
+	printf("%-16s %10.0f\n", "write", megabytes / write);
+	printf("%-16s %10.0f\n", "read, 1 thread", megabytes / single);
+	printf("%-16s %10.0f\n", "read, threads", megabytes / parallel);
+	printf("%-16s %10.0f\n", "stringstream", megabytes / stringstream);
+	remove(path);
+	return 0;
+}
@@ -0,0 +1,66 @@
+/**
+ *  @file
+ *  @brief Thread-parallel computation of many independent diagrams.
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#ifndef _BATCH_HH_
+#define _BATCH_HH_
+
+#include <vector>
+#include "diagram.hh"
+#include "engine.hh"
+#include "point.hh"
+#include "span.hh"
+
+namespace voronoi {
+
+/**
+ * Computes batches of small diagrams on a fixed number of workers.  Each
+ * worker owns an Engine, so its queue, tree and buffers are reused from one
+ * diagram to the next and from one batch to the next.
+ *
+ * Work is split in contiguous ranges, one per worker.  A worker that runs
+ * out of diagrams steals half of the remaining range of a busier one, which
+ * keeps the load balanced when diagram sizes vary.
+ */
+class BatchEngine {
+public:
+	/**
+	 * |threads| == 0 uses one worker per hardware thread.
+	 */
+	explicit BatchEngine(unsigned int threads = 0);
+	~BatchEngine();
+
+	/**
+	 * Compute the diagram of every input into the output with the same
+	 * index.  |outputs| is resized to match; diagrams already in it are
+	 * cleared and their memory reused.  An exception thrown by a worker is
+	 * rethrown here once every worker has stopped.
+	 */
+	void Compute(const std::vector<Span<const Point> >& inputs,
+			std::vector<VoronoiDCEL>& outputs);
+
+	unsigned int threads() const;
+
+private:
+	BatchEngine(const BatchEngine&);
+	BatchEngine& operator=(const BatchEngine&);
+
+	std::vector<Engine*> _engines;
+};
+
+/**
+ * One-shot form of BatchEngine::Compute().
+ */
+void ComputeBatch(const std::vector<Span<const Point> >& inputs,
+		std::vector<VoronoiDCEL>& outputs, unsigned int threads = 0);
+
+void ComputeBatch(const std::vector<std::vector<Point> >& inputs,
+		std::vector<VoronoiDCEL>& outputs, unsigned int threads = 0);
+
+}
+
+#endif /* _BATCH_HH_ */
@@ -0,0 +1,226 @@
+/**
+ *  @file
+ *  @brief 
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#ifndef _BEACHLINE_HH_
+#define _BEACHLINE_HH_
+
+#include <cstddef>
+#include <vector>
+#include <stdint.h>
+#include "diagram.hh"
+#include "point.hh"
+#include "pool.hh"
+#include "queue.hh"
+
+namespace voronoi {
+
+class Status;
+
+/**
+ * What every beach line does besides keeping its arcs in order.  A backend
+ * finds the arc above each site and the neighbors of each arc; this class
+ * schedules the circle events and turns what happens to the breakpoints
+ * (Status) between the arcs into edges of the diagram and, when asked,
+ * into the half-edge mesh.
+ *
+ * A backend is usable by BasicEngine if it is built from a queue and a
+ * diagram and offers Reset(), ReserveNodes(), Sweep() and ArcAbove() next
+ * to the methods below.  VoronoiTree and FlatBeachLine are the two there
+ * are.
+ */
+class BeachLine {
+public:
+	VoronoiQueue* queue;
+	VoronoiDCEL* dcel;
+
+	BeachLine(VoronoiQueue* queue, VoronoiDCEL* dcel);
+
+	/**
+	 * First of the sites, which are stored one after the other: the id of
+	 * a site is its offset from |sites|.  Set it before the sweep.
+	 */
+	void set_sites(const Point* sites);
+
+	typedef int (*SiteIdFunction)(const Point* site);
+
+	/**
+	 * Name sites with |id| instead of their offset from the first, for
+	 * sites that are not stored one after the other.  NULL goes back to
+	 * offsets.
+	 */
+	void set_site_id(SiteIdFunction id);
+
+	/**
+	 * Also build |mesh| during the sweep, or stop building one if it is
+	 * NULL.  Run PrepareMesh() before each Sweep() that builds it.
+	 */
+	void set_mesh(HalfEdgeDiagram* mesh);
+
+	/**
+	 * Empty the mesh and make room for a diagram of |sites| sites, whose
+	 * ids must run from 0 to |sites| - 1.  Half-edges point at each other,
+	 * so the mesh must not reallocate once the sweep starts.
+	 */
+	void PrepareMesh(size_t sites);
+
+protected:
+	/**
+	 * Forget the edges left open by the last sweep.
+	 */
+	void ResetEdges();
+
+	/**
+	 * Account for |site| before its arc goes in.  False if it is a copy of
+	 * the site entered before it: copies get no arc and no cell.
+	 */
+	bool EnterSite(const Point* site);
+
+	/**
+	 * |site| split the arc of |arc| between the breakpoints |left| and
+	 * |right|, which trace the two halves of the same edge.
+	 */
+	void SplitArc(const Point* site, const Point* arc, Status* left,
+			Status* right);
+
+	/**
+	 * A site of the first row went right of the last arc, with |breakpoint|
+	 * between them.
+	 */
+	void PlaceBeside(Status* breakpoint);
+
+	/**
+	 * Queue the event where |arc| vanishes between the arcs of |a| and |c|,
+	 * if its breakpoints converge.  |handle| names the arc in the event.
+	 */
+	void CheckCircle(Status* arc, NodeIndex handle, const Point* a,
+			const Point* c, double sweepline_y);
+
+	/**
+	 * Take the pending circle event of |arc| out of the queue, if it has
+	 * one.
+	 */
+	void RemoveCircleEvent(Status* arc);
+
+	/**
+	 * Whether the pending event of |arc|, between |a| and |c|, comes before
+	 * |site|, which is about to split it.  A site that finds an arc with
+	 * its event pending is inside the circle, unless rounding let it out of
+	 * the queue first.  Exact.
+	 */
+	static bool Overdue(const Point* site, const Point* a, const Status* arc,
+			const Point* c);
+
+	/**
+	 * Take the pending circle event of |arc| out of the queue, to be
+	 * handled now.
+	 */
+	CircleEvent TakeCircleEvent(Status* arc);
+
+	/**
+	 * Whether |arc| has an event tied with |event| in the queue.
+	 */
+	bool IsTied(const Status* arc, const CircleEvent& event) const;
+
+	/**
+	 * Position in |_tied| of the arc to close first.  Events of arcs whose
+	 * circles nearly coincide, as around nearly cocircular sites, come out
+	 * of the queue in any order, but only those whose circles are empty are
+	 * real.  The backend lists in |_tied|, in order, the arcs around the
+	 * one at |taken|, up to the last ones with an event tied with its own
+	 * and two more on each side where there are.  Exact.
+	 */
+	size_t FirstOfTied(size_t taken) const;
+
+	/**
+	 * Put |event|, just taken from the queue for |arc|, back, and take the
+	 * pending one of |neighbor| instead.
+	 */
+	CircleEvent Postpone(const CircleEvent& event, Status* arc,
+			Status* neighbor);
+
+	/**
+	 * Arcs on each side of a closing one that FirstOfTied() looks at.
+	 */
+	static const size_t kLookAround = 8;
+
+	struct TiedArc {
+		const Point* site;
+		bool tied; /**< Has an event tied with the one taken */
+	};
+	std::vector<TiedArc> _tied;
+	std::vector<EventHandle> _tied_events; /**< For the sweep loop */
+
+	/**
+	 * The arc of |b| vanished between the breakpoints |left| and |right|.
+	 * Add the vertex, close both edges and start the one of |merged|,
+	 * which is |left| or |right| and now separates |a| from |c|.
+	 */
+	void CloseArc(const Point* a, const Point* b, const Point* c,
+			Status* left, Status* right, Status* merged);
+
+	/**
+	 * Start of FinishEdges(): emit the edges of the first row.
+	 */
+	void FinishUpwardEdges();
+
+	/**
+	 * Emit the edge of a breakpoint still on the beach line when the sweep
+	 * ends.  Each one moves away from its start along the bisector of its
+	 * sites, turned so that the left site stays on the left.
+	 */
+	void FinishBreakpoint(const Status* data);
+
+	/**
+	 * End of FinishEdges(), once every breakpoint is finished.
+	 */
+	void FinishMesh();
+
+	/**
+	 * Drop the edges and ends at infinity of the diagram, and the vertices
+	 * nothing refers to any more.  The backend marks the vertices its open
+	 * edges start at with renumber[v] != kNoVertex, and must then rename
+	 * each of them v to renumber[v].  The vertices left keep their order;
+	 * |kept| gets the old index of each.
+	 */
+	void CompactVertices(std::vector<uint32_t>& renumber,
+			std::vector<uint32_t>& kept);
+
+	int SiteId(const Point* site) const;
+
+private:
+	void CloseEdge(Status* data, uint32_t end);
+	Point FarPoint(const Point* from, double dx, double dy) const;
+	uint32_t AddFarPoint(const Point& at);
+	Point InsertionPoint(const Status* twin) const;
+	void AddEdge(const DiagramEdge& edge);
+
+	unsigned int CreateMeshEdge(const Point* left, const Point* right);
+	void AddMeshVertex(const Point* center, const Status* left,
+			const Status* right, Status* merged);
+	void SetMeshEndAtInfinity(unsigned int leaving, const Point* at);
+	void CloseMeshFrame();
+
+	struct UpwardEdge {
+		uint32_t end;
+		int left_site;
+		int right_site;
+		unsigned int half_edge; /**< Half-edge that comes down to |end| */
+	};
+
+	const Point* _sites;
+	SiteIdFunction _site_id;
+	const Point* _last_site;
+	std::vector<UpwardEdge> _upward_edges; /**< First-row edges */
+	BoundingBox _bounds; /**< Sites and vertices seen so far */
+	HalfEdgeDiagram* _mesh;
+	size_t _finite_vertices; /**< Mesh vertices made by circle events */
+};
+
+}
+
+#endif /* _BEACHLINE_HH_ */
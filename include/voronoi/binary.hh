@@ -0,0 +1,57 @@
+/**
+ *  @file
+ *  @brief Binary diagram files, as gerar_voronoi writes them.
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#ifndef _BINARY_HH_
+#define _BINARY_HH_
+
+#include <cstddef>
+#include <vector>
+#include <stdint.h>
+#include "diagram.hh"
+
+namespace voronoi {
+
+/*
+ * A diagram file is a header of eight uint64_t, in native byte order:
+ *
+ *   magic ("VORONOI1"), sites, points, vertices, edges, neighbors, and two
+ *   zeros,
+ *
+ * followed by these arrays, each the raw buffer of the sweep output:
+ *
+ *   double   coordinates[2 * points]     x, y; vertices first
+ *   int32_t  vertex_sites[3 * vertices]  VertexSites
+ *   edge     edges[edges]                DiagramEdge: uint32_t origin,
+ *                                        destination; int32_t left_site,
+ *                                        right_site; uint8_t origin and
+ *                                        destination at infinity; 2 bytes
+ *                                        reserved, zero
+ *   uint32_t first_neighbor[sites + 1]   cell adjacency: the neighbors of
+ *   int32_t  neighbors[neighbors]        site i are neighbors[first[i]] to
+ *                                        neighbors[first[i + 1] - 1]
+ */
+const char kDiagramMagic[] = "VORONOI1";
+
+/**
+ * Cells are neighbors when an edge separates them.  Fills |first| and
+ * |neighbors| as in the file, for |sites| sites.
+ */
+void FindNeighbors(const VoronoiDCEL& diagram, size_t sites,
+		std::vector<uint32_t>& first, std::vector<int32_t>& neighbors);
+
+/**
+ * Write |diagram| of |sites| sites, with the adjacency from
+ * FindNeighbors(), to a file at |path|.  Returns false on I/O errors.
+ */
+bool WriteDiagramFile(const char* path, const VoronoiDCEL& diagram,
+		size_t sites, const std::vector<uint32_t>& first,
+		const std::vector<int32_t>& neighbors);
+
+}
+
+#endif /* _BINARY_HH_ */
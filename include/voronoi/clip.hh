@@ -0,0 +1,98 @@
+/**
+ *  @file
+ *  @brief 
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#ifndef _CLIP_HH_
+#define _CLIP_HH_
+
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+
+#include "diagram.hh"
+#include "point.hh"
+#include "span.hh"
+
+namespace voronoi {
+
+/**
+ * A diagram cut down to a rectangle.  Every edge, ray and line is clipped
+ * to it, and cell i is the part of the cell of site i inside it: a convex
+ * polygon in counterclockwise order, ready to draw or measure.  Clip()
+ * keeps every buffer for the next run.
+ */
+class ClippedDiagram {
+public:
+	ClippedDiagram();
+
+	/**
+	 * Clip |diagram| to |rectangle|, replacing what was held.  |sites| are
+	 * the sites the diagram was computed from, indexed by id.  Rays and
+	 * lines are followed as far as the rectangle reaches, whatever the
+	 * placement of their ends at infinity.
+	 */
+	void Clip(const VoronoiDCEL& diagram, Span<const Point> sites,
+			const BoundingBox& rectangle);
+
+	/**
+	 * Edges of the diagram that reach into the rectangle, as indices into
+	 * its edges(), in their order there.
+	 */
+	const std::vector<uint32_t>& edges() const;
+
+	/**
+	 * Ends of the i-th clipped edge, in the direction of the diagram edge.
+	 */
+	Point origin(size_t i) const;
+	Point destination(size_t i) const;
+
+	size_t cell_count() const;
+
+	/**
+	 * Corners of every cell, x and y one after the other.  Cell i has the
+	 * corners cell_offsets()[i] to cell_offsets()[i + 1] - 1.
+	 */
+	const std::vector<double>& cell_coordinates() const;
+	const std::vector<uint32_t>& cell_offsets() const;
+
+	/**
+	 * Corners of cell |cell|, empty if the cell meets the rectangle in
+	 * less than an area.
+	 */
+	std::vector<Point> Cell(size_t cell) const;
+
+	double CellArea(size_t cell) const;
+
+private:
+	void ClipEdges(const VoronoiDCEL& diagram, const BoundingBox& rectangle);
+	void BuildCells(const VoronoiDCEL& diagram, Span<const Point> sites,
+			const BoundingBox& rectangle);
+
+	std::vector<uint32_t> _edges;
+	/* Clipped ends, one array per coordinate. */
+	std::vector<double> _x0;
+	std::vector<double> _y0;
+	std::vector<double> _x1;
+	std::vector<double> _y1;
+	std::vector<uint8_t> _inside;
+	std::vector<double> _cell_coordinates;
+	std::vector<uint32_t> _cell_offsets;
+};
+
+/**
+ * Clip the segments from (x0[i], y0[i]) to (x1[i], y1[i]) to |rectangle|,
+ * in place, with the Liang-Barsky test run over whole arrays: two segments
+ * at a time with SSE2 where available, one at a time otherwise.
+ * |inside|[i] is set to whether anything of segment i is left.  Clipped
+ * ends that were not moved keep their exact coordinates.
+ */
+void ClipSegments(size_t count, double* x0, double* y0, double* x1,
+		double* y1, uint8_t* inside, const BoundingBox& rectangle);
+
+}
+
+#endif /* _CLIP_HH_ */
@@ -0,0 +1,45 @@
+/**
+ *  @file
+ *  @brief 
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#ifndef _DELAUNAY_HH_
+#define _DELAUNAY_HH_
+
+#include <dcel/dcel.hh>
+
+#include "diagram.hh"
+#include "face.hh"
+#include "point.hh"
+#include "span.hh"
+
+namespace voronoi {
+
+/**
+ * Delaunay triangulation.  Vertex i is the site with id i and face i is the
+ * triangle of the i-th Voronoi vertex, with its id set to i.  Half-edges
+ * outside the convex hull have a NULL face and are linked around the hull;
+ * their data is unused.
+ */
+typedef dcel::DCEL<Point, int, FaceInfo> DelaunayDCEL;
+
+/**
+ * Build the triangulation dual to |diagram| into |out|, replacing what it
+ * held.  Every Voronoi vertex already names the three sites of its
+ * triangle, so this only links the triangles up: one sort of their sides
+ * pairs each side with its twin.  |sites| are the sites the diagram was
+ * computed from, indexed by id.
+ *
+ * Throws dcel::Exception if a side is shared by more than two triangles,
+ * which a diagram with four or more sites on a circle merged from separate
+ * sweeps can lead to.
+ */
+void BuildDelaunay(const VoronoiDCEL& diagram, Span<const Point> sites,
+		DelaunayDCEL& out);
+
+}
+
+#endif /* _DELAUNAY_HH_ */
@@ -9,41 +9,260 @@
 #ifndef _DIAGRAM_HH_
 #define _DIAGRAM_HH_
 
-#include <list>
+#include <vector>
+#include <cassert>
 #include <cstddef>
+#include <stdint.h>
+#include <dcel/dcel.hh>
+#include "face.hh"
+#include "point.hh"
 
 namespace voronoi {
 
-struct FaceInfo;
 struct Point;
 
+/**
+ * Half-edge form of the diagram, built by the sweep on request.  Face i is
+ * the cell of the site with id i.  The first vertices are the Voronoi
+ * vertices, in the order of VoronoiDCEL; the rest stand for
+ * the open ends of rays and lines, and are joined by a frame of edges so
+ * that every cell has a closed boundary.  Half-edges outside the frame
+ * have a NULL face.  The frame only closes the topology: a cell bounded by
+ * a single line gets a frame edge that runs back along it.  Half-edge data
+ * is unused.
+ */
+typedef dcel::DCEL<Point, Point, FaceInfo> HalfEdgeDiagram;
+
+/**
+ * Voronoi edge between two sites, named by their id().  Its ends are
+ * indices of points of the diagram.  Walking from |origin| to
+ * |destination|, |left_site| is on the left.  Ends marked as at infinity
+ * are stand-ins for the open end of a ray or line, placed outside the box
+ * around every site and vertex.
+ *
+ * Edges are written to files and to other processes whole, so the record
+ * has no padding: its last two bytes are reserved and always zero.
+ */
 struct DiagramEdge {
-	const Point* origin;
-	const Point* destination;
+	uint32_t origin;
+	uint32_t destination;
+	int left_site;
+	int right_site;
+	bool origin_at_infinity;
+	bool destination_at_infinity;
+	uint8_t reserved[2];
 
-	DiagramEdge(const Point* origin, const Point* destination) :
-		origin(origin), destination(destination)
+	DiagramEdge(uint32_t origin, uint32_t destination, int left_site,
+			int right_site, bool origin_at_infinity,
+			bool destination_at_infinity) :
+		origin(origin), destination(destination), left_site(left_site),
+				right_site(right_site),
+				origin_at_infinity(origin_at_infinity),
+				destination_at_infinity(destination_at_infinity),
+				reserved()
 	{
 
 	}
 };
 
-class VoronoiDCEL {
+static_assert(sizeof(DiagramEdge) == 20, "DiagramEdge has no padding");
+
+/**
+ * Ids of the three sites around a Voronoi vertex, in the left to right
+ * order of their arcs when the middle one vanished.  They make a clockwise
+ * turn.
+ */
+struct VertexSites {
+	int left;
+	int middle;
+	int right;
+
+	VertexSites() :
+		left(-1), middle(-1), right(-1)
+	{
+
+	}
+
+	VertexSites(int left, int middle, int right) :
+		left(left), middle(middle), right(right)
+	{
+
+	}
+};
+
+/**
+ * Output of the sweep, in flat arrays.  Every point is stored once, as two
+ * coordinates: the Voronoi vertices first, then the stand-ins for open
+ * ends.  Edges refer to points by index.  Clear() keeps every buffer for
+ * the next run.
+ *
+ * The sweep always works in double and fills a VoronoiDCEL: its exact
+ * predicates and breakpoints need the precision.  There is no float sweep.
+ * Assign() copies a finished diagram into a FloatCopyDCEL, with half the
+ * bytes per point, for pipelines that only draw it.
+ */
+template <class Coordinate>
+class BasicVoronoiDCEL {
 public:
-	VoronoiDCEL();
+	BasicVoronoiDCEL();
+	BasicVoronoiDCEL(BasicVoronoiDCEL&& other);
+
+	~BasicVoronoiDCEL();
+
+	BasicVoronoiDCEL& operator=(BasicVoronoiDCEL&& other);
+
+	/**
+	 * Replace what was held by |other|, with its coordinates converted.
+	 */
+	template <class Other>
+	void Assign(const BasicVoronoiDCEL<Other>& other);
+
+	/**
+	 * Add a Voronoi vertex and return its index.  Every vertex must be
+	 * added before the first end at infinity.
+	 */
+	uint32_t addVertex(double x, double y, const VertexSites& sites);
+
+	/**
+	 * Add the stand-in for an open end and return its index.
+	 */
+	uint32_t addFarPoint(double x, double y);
+
+	void addEdge(const DiagramEdge& edge);
+
+	/**
+	 * Forget every edge and point, keeping the memory.
+	 */
+	void Clear();
+
+	/**
+	 * Make room for the diagram of |sites| sites: at most 2n - 5 vertices
+	 * and 3n - 6 edges, plus one end at infinity per site.
+	 */
+	void reserve(size_t sites);
+
+	const std::vector<DiagramEdge>& edges() const;
 
-	~VoronoiDCEL();
+	/**
+	 * x and y of every point, one after the other.
+	 */
+	const std::vector<Coordinate>& coordinates() const;
 
-	void addEdge(const Point* origin, const Point* destination);
-	void addVertex(const Point* point);
+	Point point(size_t index) const;
 
-	const std::list<const DiagramEdge*>& edges() const;
-	const std::list<const Point*>& vertices() const;
+	/**
+	 * Number of points, vertices and ends at infinity together.
+	 */
+	size_t point_count() const;
+
+	/**
+	 * Number of Voronoi vertices: points 0 to vertex_count() - 1.
+	 */
+	size_t vertex_count() const;
+
+	/**
+	 * Sites around each vertex, in the order of the vertices.
+	 */
+	const std::vector<VertexSites>& vertex_sites() const;
 private:
-	std::list<const DiagramEdge*> _edges;
-	std::list<const Point*> _vertices;
+	std::vector<DiagramEdge> _edges;
+	std::vector<Coordinate> _coordinates;
+	std::vector<VertexSites> _vertex_sites;
 };
 
+typedef BasicVoronoiDCEL<double> VoronoiDCEL;
+typedef BasicVoronoiDCEL<float> FloatCopyDCEL;
+
+template <class Coordinate>
+template <class Other>
+inline void BasicVoronoiDCEL<Coordinate>::Assign(const BasicVoronoiDCEL<Other>& other)
+{
+	_edges = other.edges();
+	_coordinates.assign(other.coordinates().begin(),
+			other.coordinates().end());
+	_vertex_sites = other.vertex_sites();
+}
+
+/* The sweep adds to and reads the diagram all the time. */
+template <class Coordinate>
+inline uint32_t BasicVoronoiDCEL<Coordinate>::addVertex(double x, double y,
+		const VertexSites& sites)
+{
+	assert(_coordinates.size() == 2 * _vertex_sites.size());
+	_vertex_sites.push_back(sites);
+	return addFarPoint(x, y);
+}
+
+template <class Coordinate>
+inline uint32_t BasicVoronoiDCEL<Coordinate>::addFarPoint(double x, double y)
+{
+	_coordinates.push_back(static_cast<Coordinate>(x));
+	_coordinates.push_back(static_cast<Coordinate>(y));
+	return _coordinates.size() / 2 - 1;
+}
+
+template <class Coordinate>
+inline void BasicVoronoiDCEL<Coordinate>::addEdge(const DiagramEdge& edge)
+{
+	_edges.push_back(edge);
+}
+
+template <class Coordinate>
+inline const std::vector<DiagramEdge>&
+BasicVoronoiDCEL<Coordinate>::edges() const
+{
+	return _edges;
+}
+
+template <class Coordinate>
+inline const std::vector<Coordinate>&
+BasicVoronoiDCEL<Coordinate>::coordinates() const
+{
+	return _coordinates;
+}
+
+template <class Coordinate>
+inline Point BasicVoronoiDCEL<Coordinate>::point(size_t index) const
+{
+	return Point(_coordinates[2 * index], _coordinates[2 * index + 1]);
+}
+
+template <class Coordinate>
+inline size_t BasicVoronoiDCEL<Coordinate>::point_count() const
+{
+	return _coordinates.size() / 2;
+}
+
+template <class Coordinate>
+inline size_t BasicVoronoiDCEL<Coordinate>::vertex_count() const
+{
+	return _vertex_sites.size();
+}
+
+template <class Coordinate>
+inline const std::vector<VertexSites>&
+BasicVoronoiDCEL<Coordinate>::vertex_sites() const
+{
+	return _vertex_sites;
+}
+
+/**
+ * Whether |a| and |b| have the same edges and vertices, in any order, with
+ * coordinates equal up to |tolerance| (relative to their magnitude once it
+ * passes 1).  Edges shorter than |tolerance| are ignored.  Vertices are
+ * matched by their sites, so four or more sites on a circle can make two
+ * correct diagrams compare unequal.
+ */
+bool EquivalentDiagrams(const VoronoiDCEL& a, const VoronoiDCEL& b,
+		double tolerance);
+
+/**
+ * Ends of |edge| of |diagram|, with the ends at infinity moved along the
+ * edge until they are out of |box|.
+ */
+void EdgeEnds(const VoronoiDCEL& diagram, const DiagramEdge& edge,
+		const BoundingBox& box, Point& origin, Point& destination);
+
 }
 
 
@@ -0,0 +1,129 @@
+/**
+ *  @file
+ *  @brief 
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#ifndef _DYNAMIC_HH_
+#define _DYNAMIC_HH_
+
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+
+#include "diagram.hh"
+#include "point.hh"
+#include "span.hh"
+
+namespace voronoi {
+
+/**
+ * Diagram that takes sites in and out after it is built, repairing only
+ * the cells around each change.  It is kept as its dual, the Delaunay
+ * triangulation, whose triangles are the Voronoi vertices: a new site
+ * replaces the triangles whose circles hold it, and a removed one leaves
+ * a hole that is filled again one ear at a time.  Both cost the size of
+ * the region that changes; a new site also needs a walk of about n^(1/3)
+ * triangles to find where it goes.  The hull is closed by triangles with a vertex at
+ * infinity, so sites outside it need no special case.
+ *
+ * Ids are handed out in order and never reused: Build() numbers the sites
+ * by their position and every InsertSite() takes the next id.
+ *
+ * Export() writes the same diagram as a sweep over the current sites would,
+ * up to the order of its edges and vertices and, for four or more sites
+ * on a circle, the choice among vertices at the same place.
+ */
+class DynamicDiagram {
+public:
+	DynamicDiagram();
+
+	/**
+	 * Sweep |sites| and keep their diagram, replacing what was held.
+	 * Sites must be distinct.  Returns false, keeping nothing, if they do
+	 * not span the plane: fewer than three, or all on one line.
+	 */
+	bool Build(Span<const Point> sites);
+
+	/**
+	 * Add |site| and return its id, or kNoSite if there is a site there
+	 * already or nothing was built yet.
+	 */
+	int InsertSite(const Point& site);
+
+	/**
+	 * Take out the site with id |id|.  Returns false if there is no such
+	 * site, or if the sites left would all be on one line.
+	 */
+	bool RemoveSite(int id);
+
+	/**
+	 * Write the whole diagram into |out|, replacing what it held.  Edges
+	 * and vertices name the sites by id.
+	 */
+	void Export(VoronoiDCEL& out) const;
+
+	/**
+	 * Ids handed out so far, removed sites included.
+	 */
+	size_t site_count() const;
+
+	bool has_site(int id) const;
+
+	const Point& site(int id) const;
+
+	/**
+	 * Sites whose cells changed in the last InsertSite() or RemoveSite():
+	 * the new site and its neighbors, or the old neighbors of the removed
+	 * one.
+	 */
+	const std::vector<int>& changed_sites() const;
+
+	static const int kNoSite = -1;
+
+private:
+	struct Triangle {
+		int v[3]; /**< Counterclockwise; kInfinity is always last */
+		uint32_t n[3]; /**< Across the side opposite v[i] */
+		Point center;
+		uint32_t mark;
+	};
+
+	/* One side of a region being rebuilt, seen from inside. */
+	struct Side {
+		int a;
+		int b;
+		uint32_t outside;
+	};
+
+	bool isGhost(uint32_t t) const;
+	uint32_t CreateTriangle(int a, int b, int c);
+	void DestroyTriangle(uint32_t t);
+	void Glue(uint32_t t, uint32_t u);
+	uint32_t Locate(const Point& p) const;
+	bool Conflicts(uint32_t t, const Point& p) const;
+	bool OutsideSide(int a, int b, const Point& p) const;
+	bool ValidEar(const std::vector<Side>& hole, size_t i) const;
+	void Touch(int site);
+
+	static const int kInfinity = -1;
+	static const uint32_t kNoTriangle = -1U;
+
+	std::vector<Point> _sites;
+	std::vector<uint32_t> _site_triangle; /**< kNoTriangle once removed */
+	std::vector<Triangle> _triangles;
+	std::vector<uint32_t> _free; /**< Dead triangles to reuse */
+	size_t _finite; /**< Triangles without a vertex at infinity */
+	uint32_t _hint; /**< Where the next walk starts */
+	uint32_t _mark;
+	std::vector<int> _changed;
+	std::vector<uint32_t> _stack;
+	std::vector<uint32_t> _region;
+	std::vector<Side> _sides;
+};
+
+}
+
+#endif /* _DYNAMIC_HH_ */
@@ -0,0 +1,131 @@
+/**
+ *  @file
+ *  @brief Reusable sweep engine.
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#ifndef _ENGINE_HH_
+#define _ENGINE_HH_
+
+#include <vector>
+#include "diagram.hh"
+#include "flat.hh"
+#include "point.hh"
+#include "queue.hh"
+#include "span.hh"
+#include "status.hh"
+#include "tree.hh"
+
+namespace voronoi {
+
+class StripEngine;
+
+enum SweepAlgorithm {
+	kSequentialSweep, /**< One sweep over all sites */
+	kStripSweep /**< One sweep per thread over vertical strips */
+};
+
+/**
+ * Runs the sweep over and over without giving memory back.  The sites are
+ * copied into the engine, and the queue, tree and output buffers keep their
+ * capacity between runs, so once the engine has seen a point set of a given
+ * size, further runs of that size do not touch the heap.  Inputs with more
+ * than VoronoiQueue::kParallelSortThreshold sites are the exception: their
+ * parallel sort allocates per-thread state.
+ *
+ * Unlike Voronoi, the engine never takes ownership of the caller's sites.
+ *
+ * |Backend| keeps the beach line during the sequential sweep: VoronoiTree
+ * (Engine) or FlatBeachLine (FlatEngine), or any other class that meets
+ * the requirements listed with BeachLine.  Strip sweeps always use the
+ * tree.
+ */
+template <class Backend>
+class BasicEngine {
+public:
+	BasicEngine();
+	~BasicEngine();
+
+	/**
+	 * Compute the diagram of |sites|.  Edges and vertices name the sites
+	 * by their position in |sites|.  The result stays valid until the next
+	 * compute(), reset() or TakeDiagram().
+	 */
+	const VoronoiDCEL& compute(Span<const Point> sites);
+
+	/**
+	 * Forget the last run, keeping every buffer.
+	 */
+	void reset();
+
+	/**
+	 * Grow the buffers for a run over |sites| sites ahead of time.
+	 */
+	void reserve(size_t sites);
+
+	/**
+	 * Pick how compute() runs.  With kStripSweep, inputs of at least
+	 * kMinStripSites sites are split among |threads| strips (one per
+	 * hardware thread when 0); smaller ones are swept sequentially.  The
+	 * diagram is the same either way, up to the order of its edges and
+	 * vertices.
+	 */
+	void set_algorithm(SweepAlgorithm algorithm, unsigned int threads = 0);
+
+	SweepAlgorithm algorithm() const;
+
+	/**
+	 * Also build the half-edge mesh() of the diagram during the sweep.
+	 * Inputs that need it are always swept sequentially.
+	 */
+	void set_build_mesh(bool build);
+
+	bool build_mesh() const;
+
+	const VoronoiDCEL& diagram() const;
+
+	/**
+	 * Mesh of the last run, if set_build_mesh() was on.
+	 */
+	const HalfEdgeDiagram& mesh() const;
+
+	/**
+	 * Counters of the last sequential sweep.
+	 */
+	const QueueStats& stats() const;
+
+	/**
+	 * Move the last diagram out of the engine.  The engine continues with
+	 * an empty diagram; give the old one back with Recycle() to reuse its
+	 * memory.
+	 */
+	VoronoiDCEL TakeDiagram();
+
+	void Recycle(VoronoiDCEL&& diagram);
+
+	static const size_t kMinStripSites = 1 << 14;
+
+private:
+	BasicEngine(const BasicEngine&);
+	BasicEngine& operator=(const BasicEngine&);
+
+	std::vector<Point> _sites;
+	std::vector<Point*> _site_pointers;
+	VoronoiQueue _queue;
+	VoronoiDCEL _dcel;
+	HalfEdgeDiagram _mesh;
+	Backend _tree;
+	SweepAlgorithm _algorithm;
+	StripEngine* _strips; /**< Created on the first strip sweep */
+	unsigned int _threads;
+	bool _build_mesh;
+};
+
+typedef BasicEngine<VoronoiTree> Engine;
+typedef BasicEngine<FlatBeachLine> FlatEngine;
+
+}
+
+#endif /* _ENGINE_HH_ */
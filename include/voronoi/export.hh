@@ -0,0 +1,43 @@
+/**
+ *  @file
+ *  @brief SVG and GeoJSON files of a clipped diagram.
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#ifndef _EXPORT_HH_
+#define _EXPORT_HH_
+
+#include <cstddef>
+#include "clip.hh"
+#include "point.hh"
+#include "span.hh"
+
+namespace voronoi {
+
+/**
+ * Edges or cells formatted by each thread at a time.  The exporters hold
+ * one buffer of this many per thread, whatever the size of the diagram.
+ */
+extern const size_t kExportChunk;
+
+/**
+ * Write the edges of |clipped| and, unless empty, |sites| as an SVG image
+ * of |rectangle|, y up.  Chunks of edges are formatted on |threads|
+ * threads (one per hardware thread when 0) and written in order.
+ */
+bool WriteSvg(const char* path, const ClippedDiagram& clipped,
+		const BoundingBox& rectangle, Span<const Point> sites,
+		unsigned int threads = 0);
+
+/**
+ * Write the cells of |clipped| as a GeoJSON FeatureCollection: a Polygon
+ * per cell with area, with the id of its site as the "site" property.
+ */
+bool WriteGeoJson(const char* path, const ClippedDiagram& clipped,
+		unsigned int threads = 0);
+
+}
+
+#endif /* _EXPORT_HH_ */
@@ -0,0 +1,99 @@
+/**
+ *  @file
+ *  @brief 
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#ifndef _FLAT_HH_
+#define _FLAT_HH_
+
+#include <cstddef>
+#include <vector>
+#include "beachline.hh"
+#include "diagram.hh"
+#include "point.hh"
+#include "pool.hh"
+#include "status.hh"
+
+namespace voronoi {
+
+struct CircleEvent;
+class VoronoiQueue;
+
+/**
+ * Beach line kept in one array of arcs, sorted from left to right.  The
+ * arc above a site is found by binary search over the breakpoints, and the
+ * neighbors of an arc are the next entries.  Inserting or removing an arc
+ * shifts the entries after it, which is cheap while the beach line is
+ * short, as with about sqrt(n) arcs for sites spread over the plane, and
+ * quadratic when nearly every site stays on it.
+ *
+ * Arcs and breakpoints are Status records in a pool, so that twins can
+ * point at each other and circle events can name their arc however the
+ * array moves.
+ */
+class FlatBeachLine: public BeachLine {
+public:
+	FlatBeachLine(VoronoiQueue* queue, VoronoiDCEL* dcel);
+
+	void InsertParabola(Point* parabola);
+
+	void RemoveParabola(const CircleEvent& taken);
+
+	/**
+	 * Emit the edges that are still open when the sweep ends.
+	 */
+	void FinishEdges();
+
+	/**
+	 * Run the whole sweep: drain the queue and close the edges left on
+	 * the beach line.
+	 */
+	void Sweep();
+
+	/**
+	 * Drop the beach line and every edge left open by the sweep.  The
+	 * memory is kept for the next run.
+	 */
+	void Reset();
+
+	/**
+	 * Make room for |count| arcs and breakpoints.
+	 */
+	void ReserveNodes(size_t count);
+
+	/**
+	 * Site of the arc right above |site|, or NULL if there is no arc yet.
+	 */
+	const Point* ArcAbove(const Point* site) const;
+
+	/**
+	 * Number of arcs on the beach line.
+	 */
+	size_t size() const;
+
+private:
+	struct Entry {
+		Point* site;
+		NodeIndex arc;
+		NodeIndex right; /**< Breakpoint with the next arc */
+	};
+
+	size_t Locate(const Point* site) const;
+	size_t Find(const CircleEvent& event) const;
+	void InsertBeside(size_t nearest, Point* parabola);
+	size_t FirstTied(size_t k, const CircleEvent& event);
+	bool EventFirst(const CircleEvent& event, const Point* site) const;
+	void CheckCircle(size_t position, double sweepline_y);
+	NodeIndex CreateStatus(const Status& status);
+	Status* status(NodeIndex index) const;
+
+	std::vector<Entry> _arcs; /**< From left to right */
+	NodePool<Status> _statuses;
+};
+
+}
+
+#endif /* _FLAT_HH_ */
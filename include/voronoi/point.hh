@@ -9,63 +9,171 @@
 #ifndef _POINT_HH_
 #define _POINT_HH_
 
+#include <cmath>
+#include <cstddef>
 #include <functional>
+#include <limits>
 #include <string>
 
 namespace voronoi {
 
-template <class T>
-class RBTreeNode;
-
-class Status;
-
+/**
+ * Two coordinates and nothing else, so that sites pack 16 bytes apart.
+ * The sweep tells sites apart by their offset in the input, circle events
+ * have their own record in the queue and vertices go straight to the flat
+ * output.
+ */
 struct Point {
 public:
 	Point();
-	Point(const Point& p);
 	Point(double x, double y);
 
-	void set_id(int id);
 	void set_coordinates(double x, double y);
 	void set_x(double x);
 	void set_y(double y);
-	void set_face(unsigned int face);
-	void set_circle_lowest_circle_parabola_node(RBTreeNode<Status>* node);
 
 	double x() const;
 	double y() const;
-	int id() const;
-	unsigned int face() const;
-	RBTreeNode<Status>* lowest_circle_parabola_node() const;
 
 	bool operator <(const Point& b) const;
 	bool operator >(const Point& b) const;
 	bool operator ==(const Point& b) const;
 
 	double GetXOfParabolaIntersection(const Point* q, double sweep_y) const;
-	double GetYOfParabolaInsersection(Point* other) const;
+	double GetYOfParabolaInsersection(const Point* other) const;
 
 	void SetCoordinatesToTheCircleCenter(const Point* a, const Point* b,
 			const Point* c);
 	void SetCoordinatesToTheCircleBottom(const Point* a, const Point* b,
 			const Point* c);
-
-	bool isCircleEvent() const;
-	bool isFalseAlarm() const;
-	void MarkAsFalseAlarm();
+	/**
+	 * Same, with |orientation| = Orientation(*a, *b, *c) already known.
+	 */
+	void SetCoordinatesToTheCircleBottom(const Point* a, const Point* b,
+			const Point* c, double orientation);
 
 	std::string str() const;
 
 private:
 	double _x;
 	double _y;
-	int _id;
-	bool _false_alarm;
-	unsigned int _face;
-	RBTreeNode<Status>* _lowest_circle_parabola_node;
 };
 
-struct ComparePoint: public std::binary_function<Point*, Point*, bool> {
+/* Defined here: the sweep copies and compares points all the time. */
+inline Point::Point() :
+		_x(0.0), _y(0.0)
+{
+}
+
+inline Point::Point(double x, double y) :
+		_x(x), _y(y)
+{
+}
+
+inline bool Point::operator <(const Point& b) const
+{
+	double abs_a = std::fabs(y());
+	double abs_b = std::fabs(b.y());
+	double greater = abs_a < abs_b? abs_b : abs_a;
+
+	return (b.y() - y()) > greater * std::numeric_limits<double>::epsilon();
+}
+
+inline bool Point::operator >(const Point& b) const
+{
+	return y() > b.y();
+}
+
+inline bool Point::operator ==(const Point& b) const
+{
+	return x() == b.x() && y() == b.y();
+}
+
+inline void Point::set_coordinates(double x, double y)
+{
+	set_x(x);
+	set_y(y);
+}
+
+inline void Point::set_x(double x)
+{
+	_x = x;
+}
+
+inline void Point::set_y(double y)
+{
+	_y = y;
+}
+
+inline double Point::x() const
+{
+	return _x;
+}
+
+inline double Point::y() const
+{
+	return _y;
+}
+
+/**
+ * Axis-aligned box around a set of points.  Also places the far end of the
+ * edges that go to infinity.
+ */
+class BoundingBox {
+public:
+	BoundingBox();
+	BoundingBox(double min_x, double min_y, double max_x, double max_y);
+
+	void Extend(const Point& p);
+	void Extend(const BoundingBox& box);
+	void Clear();
+
+	/**
+	 * Point on the ray from |from| along (dx, dy), farther from the center
+	 * of the box than |from| by at least the diagonal of the box.
+	 */
+	Point FarPoint(const Point& from, double dx, double dy) const;
+
+	bool empty() const;
+	double min_x() const;
+	double max_x() const;
+	double min_y() const;
+	double max_y() const;
+
+private:
+	bool _empty;
+	double _min_x;
+	double _max_x;
+	double _min_y;
+	double _max_y;
+};
+
+inline bool BoundingBox::empty() const
+{
+	return _empty;
+}
+
+inline double BoundingBox::min_x() const
+{
+	return _min_x;
+}
+
+inline double BoundingBox::max_x() const
+{
+	return _max_x;
+}
+
+inline double BoundingBox::min_y() const
+{
+	return _min_y;
+}
+
+inline double BoundingBox::max_y() const
+{
+	return _max_y;
+}
+
+struct ComparePoint {
 	bool operator ()(const Point* a, const Point* b) const
 	{
 		return *a < *b;
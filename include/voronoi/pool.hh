@@ -0,0 +1,168 @@
+/**
+ *  @file
+ *  @brief Slab allocator for the beach-line tree nodes.
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#ifndef _POOL_HH_
+#define _POOL_HH_
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+namespace voronoi {
+
+/*
+ * Nodes are linked by their index in the pool instead of by pointer.  Build
+ * with VORONOI_32BIT_NODE_INDEX to use 32-bit links, which halves the size
+ * of every link at the cost of limiting the tree to 2^32 - 1 nodes.
+ */
+#ifdef VORONOI_32BIT_NODE_INDEX
+typedef uint32_t NodeIndex;
+#else
+typedef size_t NodeIndex;
+#endif
+
+const NodeIndex kNullNode = static_cast<NodeIndex>(-1);
+
+/**
+ * Hands out slots for objects of type T from contiguous blocks.  Freed slots
+ * are kept in a free list and reused before the pool grows.  Blocks are never
+ * returned to the system until the pool is destroyed, so Clear() drops every
+ * object in O(1) and the next run reuses the same memory.
+ *
+ * The pool does not construct objects: Allocate() returns an index to raw
+ * storage and the caller uses placement new on at(index).  Since Clear() does
+ * not run destructors, T must not own any resource.
+ */
+template<class T>
+class NodePool {
+public:
+	NodePool() :
+			_size(0), _free(kNullNode), _live(0)
+	{
+	}
+
+	NodePool(NodePool&& other) :
+			_blocks(std::move(other._blocks)), _size(other._size),
+					_free(other._free), _live(other._live)
+	{
+		other._blocks.clear();
+		other.Clear();
+	}
+
+	NodePool& operator=(NodePool&& other)
+	{
+		std::swap(_blocks, other._blocks);
+		_size = other._size;
+		_free = other._free;
+		_live = other._live;
+		other.Clear();
+		return *this;
+	}
+
+	~NodePool()
+	{
+		typename std::vector<T*>::iterator it;
+
+		for (it = _blocks.begin(); it != _blocks.end(); it++)
+			::operator delete(*it);
+	}
+
+	/**
+	 * Reserve a slot and return its index.  The slot is not initialized.
+	 */
+	NodeIndex Allocate()
+	{
+		NodeIndex index;
+
+		if (_free != kNullNode) {
+			index = _free;
+			_free = *reinterpret_cast<NodeIndex*>(at(index));
+		} else {
+			if (_size == capacity())
+				Grow();
+			index = _size++;
+		}
+		_live++;
+		return index;
+	}
+
+	/**
+	 * Destroy the object at |index| and put its slot in the free list.
+	 */
+	void Free(NodeIndex index)
+	{
+		T* slot = at(index);
+
+		slot->~T();
+		*reinterpret_cast<NodeIndex*>(slot) = _free;
+		_free = index;
+		_live--;
+	}
+
+	T* at(NodeIndex index) const
+	{
+		return _blocks[index >> kBlockShift] + (index & kBlockMask);
+	}
+
+	/**
+	 * Forget every object at once.  Memory is kept for reuse.
+	 */
+	void Clear()
+	{
+		_size = 0;
+		_free = kNullNode;
+		_live = 0;
+	}
+
+	void Reserve(size_t count)
+	{
+		while (capacity() < count)
+			Grow();
+	}
+
+	/**
+	 * Number of objects currently allocated.
+	 */
+	size_t size() const
+	{
+		return _live;
+	}
+
+	size_t capacity() const
+	{
+		return _blocks.size() << kBlockShift;
+	}
+
+private:
+	static const size_t kBlockShift = 10;
+	static const size_t kBlockSize = 1 << kBlockShift;
+	static const size_t kBlockMask = kBlockSize - 1;
+
+	NodePool(const NodePool&);
+	NodePool& operator=(const NodePool&);
+
+	void Grow()
+	{
+		if (capacity() + kBlockSize > static_cast<size_t>(kNullNode))
+			throw std::length_error("NodePool: node index space exhausted");
+		void* block = ::operator new(sizeof(T) * kBlockSize);
+		_blocks.push_back(static_cast<T*>(block));
+	}
+
+	std::vector<T*> _blocks;
+	NodeIndex _size; /**< Slots handed out since the last Clear() */
+	NodeIndex _free; /**< Head of the free list threaded through the slots */
+	size_t _live;
+};
+
+}
+
+#endif /* _POOL_HH_ */
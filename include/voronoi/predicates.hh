@@ -0,0 +1,71 @@
+/**
+ *  @file
+ *  @brief 
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#ifndef _PREDICATES_HH_
+#define _PREDICATES_HH_
+
+#include <stdint.h>
+
+#include "point.hh"
+
+namespace voronoi {
+
+/**
+ * Twice the signed area of the triangle abc: positive if a, b and c make a
+ * counterclockwise turn, negative if clockwise and zero if they are on a
+ * line.  The sign is always exact.  A floating-point filter settles almost
+ * every call; only when rounding could flip the sign is the determinant
+ * computed again without error.
+ */
+double Orientation(const Point& a, const Point& b, const Point& c);
+
+/**
+ * Positive if |d| is inside the circle through a, b and c, which must make
+ * a counterclockwise turn, negative if outside and zero if on it.  The
+ * sign is exact, filtered like Orientation().
+ */
+double InCircle(const Point& a, const Point& b, const Point& c,
+		const Point& d);
+
+/**
+ * Whether |s|, on the sweep line, is left of the breakpoint between the arc
+ * of |p| and, to its right, the arc of |q|.  Exact, filtered like
+ * Orientation(), so that a site an ulp from a breakpoint, or under an arc
+ * narrower than an ulp, still finds the arc above it.
+ */
+bool LeftOfBreakpoint(const Point& p, const Point& q, const Point& s);
+
+/**
+ * Whether the circle through a, b and c, which make a clockwise turn, is
+ * all above height |y|: its circle event comes before a site there.
+ * Exact, filtered like Orientation().
+ */
+bool CircleAbove(const Point& a, const Point& b, const Point& c, double y);
+
+/**
+ * How often each predicate was called and how often the filter could not
+ * decide, so that the exact fallback ran.
+ */
+struct PredicateStats {
+	uint64_t orientations;
+	uint64_t exact_orientations;
+	uint64_t incircles;
+	uint64_t exact_incircles;
+};
+
+/**
+ * Counters of the calling thread.  Each sweep runs on a single thread, so
+ * they add up what the sweeps run there did.
+ */
+const PredicateStats& predicate_stats();
+
+void ResetPredicateStats();
+
+}
+
+#endif /* _PREDICATES_HH_ */
@@ -9,20 +9,152 @@
 #ifndef _QUEUE_HH_
 #define _QUEUE_HH_
 
-#include <queue>
+#include <cstddef>
 #include <vector>
 #include "point.hh"
+#include "pool.hh"
 
 namespace voronoi {
 
-struct Point;
-struct ComparePoint;
+/**
+ * Lowest point of the circle through three consecutive sites of the beach
+ * line, where the arc named by |arc| shrinks to nothing.  The beach line
+ * picks the name, a pool index that stays put while the arc lives.  An
+ * event that turns out to be a false alarm is erased from the queue, so
+ * every event in it is valid.
+ */
+struct CircleEvent {
+	double x;
+	double y;
+	NodeIndex arc;
+};
+
+/**
+ * Stable reference to a pending circle event.  It stays valid until the
+ * event is popped or erased, however the heap moves it around.
+ */
+typedef unsigned int EventHandle;
+
+const EventHandle kNoEvent = -1U;
+
+/**
+ * Counters to measure the queue traffic of a sweep.
+ */
+struct QueueStats {
+	size_t sites;
+	size_t circle_events; /**< Circle events pushed */
+	size_t removed; /**< Circle events erased before reaching the top */
+	size_t peak_size; /**< Most circle events pending at once */
+
+	QueueStats() :
+			sites(0), circle_events(0), removed(0), peak_size(0)
+	{
+	}
+};
 
-class VoronoiQueue: public std::priority_queue<Point*, std::vector<Point*>,
-		ComparePoint> {
+/**
+ * Event scheduler for the sweep.  Sites are known up front, so they are
+ * sorted once and consumed through a cursor.  Only the events pushed during
+ * the sweep (circle events) go into a 4-ary heap, which supports erasing an
+ * event through the handle returned by push().  The next event comes from
+ * whichever of the two sources has the highest one; on a tie the site
+ * comes first.  Events too close to the next site for their rounded
+ * heights to order are left to the sweep, through tiedWithSite().
+ *
+ * Sites are referenced, circle events are copied into the queue.  A circle
+ * event returned by circle() is only valid until the next push() or pop().
+ */
+class VoronoiQueue {
 public:
+	/**
+	 * Site arrays with at least this many points are sorted on several
+	 * threads.
+	 */
+	static const size_t kParallelSortThreshold;
+
 	VoronoiQueue();
 	VoronoiQueue(std::vector<Point*>& sites);
+
+	/**
+	 * Drop every pending event and schedule |sites|, keeping the memory
+	 * of the previous run.
+	 */
+	void Reset(std::vector<Point*>& sites);
+
+	bool empty() const;
+	size_t size() const;
+
+	/**
+	 * Whether the next event is a site, to read with site(), or a circle
+	 * event, to read with circle().
+	 */
+	bool isSiteNext() const;
+	Point* site() const;
+	const CircleEvent& circle() const;
+
+	/**
+	 * Circle events too close in height to the next site for the rounding
+	 * to tell which comes first, in |handles|; none if a circle event is
+	 * clearly next.  The sweep settles the order exactly, then takes the
+	 * site with popSite() or an event with erase().
+	 */
+	void tiedWithSite(std::vector<EventHandle>& handles) const;
+	void popSite();
+
+	/**
+	 * Whether events at |a| and |b| are too close for their rounded heights
+	 * to tell which comes first.
+	 */
+	static bool Tied(const Point& a, const Point& b);
+
+	/**
+	 * Whether a pending circle event may be tied with |event|.  Cheap, and
+	 * false only when none is.
+	 */
+	bool hasTied(const CircleEvent& event) const;
+
+	/**
+	 * Coordinates of the next event, whatever its kind.
+	 */
+	Point top() const;
+
+	void pop();
+	EventHandle push(const CircleEvent& event);
+
+	/**
+	 * Take a pending event out of the queue.
+	 */
+	void erase(EventHandle handle);
+
+	const CircleEvent& event(EventHandle handle) const;
+
+	const QueueStats& stats() const;
+
+private:
+	static const size_t kArity = 4;
+
+	struct HeapEntry {
+		double y;
+		EventHandle handle;
+	};
+
+	struct EventSlot {
+		CircleEvent event;
+		size_t position; /**< Index in _heap, or next free slot */
+	};
+
+	void RemoveAt(size_t position);
+	void SiftUp(size_t position);
+	void SiftDown(size_t position);
+	void Place(size_t position, const HeapEntry& entry);
+
+	std::vector<Point*> _sites; /**< Sorted from the highest y down */
+	size_t _cursor;
+	std::vector<HeapEntry> _heap; /**< Max-heap on y */
+	std::vector<EventSlot> _slots; /**< Indexed by EventHandle */
+	EventHandle _free_slot;
+	double _scale; /**< Largest |x| + |y| of the circle events pushed */
+	QueueStats _stats;
 };
 
 }
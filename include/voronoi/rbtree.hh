@@ -12,6 +12,8 @@
 #include <tr1/functional>
 #include <cassert>
 #include <cstddef>
+#include <new>
+#include "pool.hh"
 
 namespace voronoi {
 
@@ -28,8 +30,10 @@ public:
 		kRed = true, kBlack = false
 	};
 
-	RBTreeNode(T& data, RBTree<T>* tree) :
-			_parent(NULL), _left_child(NULL), _right_child(NULL), _color(kRed),
+	RBTreeNode(T& data, RBTree<T>* tree, NodeIndex index) :
+			_parent(kNullNode), _left_child(kNullNode),
+					_right_child(kNullNode), _previous(kNullNode),
+					_next(kNullNode), _index(index), _color(kRed),
 					_data(data), _tree(tree), _id(0)
 	{
 	}
@@ -40,17 +44,27 @@ public:
 
 	void set_parent(RBTreeNode* node)
 	{
-		_parent = node;
+		_parent = node != NULL ? node->index() : kNullNode;
 	}
 
 	void set_left_child(RBTreeNode* node)
 	{
-		_left_child = node;
+		_left_child = node != NULL ? node->index() : kNullNode;
 	}
 
 	void set_right_child(RBTreeNode* node)
 	{
-		_right_child = node;
+		_right_child = node != NULL ? node->index() : kNullNode;
+	}
+
+	void set_previous(RBTreeNode* node)
+	{
+		_previous = node != NULL ? node->index() : kNullNode;
+	}
+
+	void set_next(RBTreeNode* node)
+	{
+		_next = node != NULL ? node->index() : kNullNode;
 	}
 
 	void set_color(Color color)
@@ -65,17 +79,41 @@ public:
 
 	RBTreeNode* parent() const
 	{
-		return _parent;
+		return tree()->node(_parent);
 	}
 
 	RBTreeNode* left_child() const
 	{
-		return _left_child;
+		return tree()->node(_left_child);
 	}
 
 	RBTreeNode* right_child() const
 	{
-		return _right_child;
+		return tree()->node(_right_child);
+	}
+
+	/**
+	 * Nodes before and after this one in order, kept by the tree as it
+	 * changes so that walking to a neighbor costs O(1).  Arcs and
+	 * breakpoints alternate: the next of a leaf is its right breakpoint
+	 * and the next of that is the arc on the right.
+	 */
+	RBTreeNode* previous() const
+	{
+		return tree()->node(_previous);
+	}
+
+	RBTreeNode* next() const
+	{
+		return tree()->node(_next);
+	}
+
+	/**
+	 * Position of this node in the tree's node pool.
+	 */
+	NodeIndex index() const
+	{
+		return _index;
 	}
 
 	Color color() const
@@ -115,7 +153,47 @@ public:
 
 	bool isLeaf() const
 	{
-		return left_child() == NULL && right_child() == NULL;
+		return _left_child == kNullNode && _right_child == kNullNode;
+	}
+
+	/**
+	 * Next node after this one in a pre-order walk of the subtree under
+	 * |top|, or NULL at the end.  The walk follows parent links, so it
+	 * needs no stack however deep the tree is.
+	 */
+	RBTreeNode* NextPreOrder(const RBTreeNode* top) const
+	{
+		const RBTreeNode* p = this;
+
+		if (left_child() != NULL)
+			return left_child();
+		if (right_child() != NULL)
+			return right_child();
+		while (p != top) {
+			RBTreeNode* parent = p->parent();
+			if (p->isLeftChild() && parent->right_child() != NULL)
+				return parent->right_child();
+			p = parent;
+		}
+		return NULL;
+	}
+
+	/**
+	 * Next node after this one in order, or NULL at the end.
+	 */
+	RBTreeNode* NextInOrder() const
+	{
+		const RBTreeNode* p = this;
+
+		if (right_child() != NULL) {
+			RBTreeNode* next = right_child();
+			while (next->left_child() != NULL)
+				next = next->left_child();
+			return next;
+		}
+		while (p->isRightChild())
+			p = p->parent();
+		return p->parent();
 	}
 
 	void UpdateNodeIDs(int* id)
@@ -125,20 +203,19 @@ public:
 		 * pre-order.  Useful to draw the tree with "bosque", where only
 		 * integers are accepted as key to a node.
 		 */
-		if (left_child())
-			left_child()->UpdateNodeIDs(id);
-		set_id((*id)++);
-		if (right_child())
-			right_child()->UpdateNodeIDs(id);
+		RBTreeNode* node = this;
+
+		while (node->left_child() != NULL)
+			node = node->left_child();
+		for (; node != NULL; node = node->NextInOrder())
+			node->set_id((*id)++);
 	}
 
 	void WalkPreOrder(typename RBTree<T>::Callback callback) const
 	{
-		callback(this);
-		if (left_child())
-			left_child()->WalkPreOrder(callback);
-		if (right_child())
-			right_child()->WalkPreOrder(callback);
+		for (const RBTreeNode* node = this; node != NULL;
+				node = node->NextPreOrder(this))
+			callback(node);
 	}
 
 	void RotateToLeft()
@@ -210,31 +287,9 @@ public:
 	}
 
 	/**
-	 * Special method to delete itself from the tree.
-	 * We will never delete a node that is a root of is a internal node with
-	 * both left and right childs.
-	 * The method returns itself.
+	 * Restore the red-black properties after a black node above this one
+	 * was spliced out.
 	 */
-	RBTreeNode* SelfDelete()
-	{
-		if (isRoot()) /* The root must not delete itself */
-			throw;
-		RBTreeNode* new_son;
-		if (left_child() != NULL)
-			new_son = left_child();
-		else
-			new_son = right_child();
-		if (new_son != NULL)
-			new_son->set_parent(parent());
-		if (isLeftChild())
-			parent()->set_left_child(new_son);
-		else
-			parent()->set_right_child(new_son);
-		if (isBlack() && new_son != NULL)
-			new_son->PosRemoveFixUp();
-		return this;
-	}
-
 	void PosRemoveFixUp()
 	{
 		InternalRemoveFixUp();
@@ -252,7 +307,7 @@ public:
 
 	bool isRoot() const
 	{
-		return parent() == NULL;
+		return _parent == kNullNode;
 	}
 
 	/**
@@ -281,12 +336,12 @@ public:
 	 */
 	RBTreeNode* FindNearest(T& value)
 	{
-		if (isLeaf())
-			return this;
-		if (*data() < value)
-			return left_child()->FindNearest(value);
-		else
-			return right_child()->FindNearest(value);
+		RBTreeNode* node = this;
+
+		while (!node->isLeaf())
+			node = *node->data() < value ?
+					node->left_child() : node->right_child();
+		return node;
 	}
 
 	RBTreeNode* GetFirstParentAtLeft()
@@ -335,126 +390,115 @@ public:
 		return par;
 	}
 
-	/**
-	 * Free all child nodes, without detaching them.  You should notice
-	 * the node will still have pointers to this free'd memory.  We won't
-	 * set the links to left and right to NULL.
-	 */
-	void FreeChildNodes() const
-	{
-		if (left_child())
-			left_child()->FreeChildNodes();
-		delete left_child();
-		if (right_child())
-			right_child()->FreeChildNodes();
-		delete right_child();
-	}
-
 private:
+	/*
+	 * The beach line keeps arcs in the leaves and breakpoints in the
+	 * internal nodes, so every internal node has two children.  Leaves
+	 * play the part of the black NIL nodes of the textbook algorithms:
+	 * they are never red and never rotated, which keeps the in-order
+	 * sequence of arcs intact.
+	 */
 	void InternalInsertFixUp()
 	{
-		/*
-		 * Helper method for FixUp().
-		 */
+		RBTreeNode* z = this;
 		RBTreeNode* uncle;
-		RBTreeNode* next(this);
-
-		if (isRoot() || parent()->isBlack())
-			return;
 
-		if (parent()->isLeftChild()) {
-			uncle = grandparent()->right_child();
-			if (uncle != NULL && uncle->isRed()) {
-				parent()->set_color(kBlack);
-				uncle->set_color(kBlack);
-				grandparent()->set_color(kRed);
-				next = grandparent();
-			} else {
-				if (isRightChild()) {
-					next = parent();
-					next->RotateToLeft();
+		while (!z->isRoot() && z->parent()->isRed()) {
+			if (z->parent()->isLeftChild()) {
+				uncle = z->grandparent()->right_child();
+				if (RB_ISRED(uncle)) {
+					z->parent()->set_color(kBlack);
+					uncle->set_color(kBlack);
+					z->grandparent()->set_color(kRed);
+					z = z->grandparent();
+					continue;
 				}
-				next->parent()->set_color(kBlack);
-				next->grandparent()->set_color(kRed);
-				next->grandparent()->RotateToRight();
-			}
-		} else if (parent()->isRightChild()) {
-			uncle = grandparent()->left_child();
-			if (uncle != NULL && uncle->isRed()) {
-				parent()->set_color(kBlack);
-				uncle->set_color(kBlack);
-				grandparent()->set_color(kRed);
-				next = grandparent();
+				if (z->isRightChild()) {
+					z = z->parent();
+					z->RotateToLeft();
+				}
+				z->parent()->set_color(kBlack);
+				z->grandparent()->set_color(kRed);
+				z->grandparent()->RotateToRight();
 			} else {
-				if (isLeftChild()) {
-					next = parent();
-					next->RotateToRight();
+				uncle = z->grandparent()->left_child();
+				if (RB_ISRED(uncle)) {
+					z->parent()->set_color(kBlack);
+					uncle->set_color(kBlack);
+					z->grandparent()->set_color(kRed);
+					z = z->grandparent();
+					continue;
 				}
-				next->parent()->set_color(kBlack);
-				next->grandparent()->set_color(kRed);
-				next->grandparent()->RotateToLeft();
+				if (z->isLeftChild()) {
+					z = z->parent();
+					z->RotateToRight();
+				}
+				z->parent()->set_color(kBlack);
+				z->grandparent()->set_color(kRed);
+				z->grandparent()->RotateToLeft();
 			}
 		}
-		if (next != NULL)
-			next->InternalInsertFixUp();
 	}
 
 	void InternalRemoveFixUp()
 	{
-		if (isRed() || isRoot()) {
-			set_color(kBlack);
-			return;
-		}
-		if (isLeftChild()) {
-			RBTreeNode* sibling = parent()->right_child();
-			if (RB_ISRED(sibling)) {
-				sibling->set_color(kBlack);
-				parent()->set_color(kRed);
-				parent()->RotateToLeft();
-				sibling = parent()->right_child();
-			}
-			RBTreeNode* left = sibling->left_child();
-			RBTreeNode* right = sibling->right_child();
-			if (RB_ISBLACK(left) && RB_ISBLACK(right)) {
-				sibling->set_color(kRed);
-				sibling->InternalRemoveFixUp();
-			} else if (RB_ISBLACK(right)) {
-				sibling->left_child()->set_color(kBlack);
-				sibling->set_color(kRed);
-				sibling->RotateToRight();
-				sibling = parent()->right_child();
-				sibling->set_color(parent()->color());
-				parent()->set_color(kBlack);
-				sibling->right_child()->set_color(kBlack);
-				parent()->RotateToLeft();
-				tree()->root()->InternalRemoveFixUp();
-			}
-		} else {
-			assert(isRightChild());
-			RBTreeNode* sibling = parent()->left_child();
-			if (RB_ISRED(sibling)) {
-				sibling->set_color(kBlack);
-				parent()->set_color(kRed);
-				parent()->RotateToRight();
-				sibling = parent()->left_child();
-			}
-			RBTreeNode* left = sibling->left_child();
-			RBTreeNode* right = sibling->right_child();
-			if (RB_ISBLACK(left) && RB_ISBLACK(right)) {
-				sibling->set_color(kRed);
-				sibling->InternalRemoveFixUp();
-			} else if (RB_ISBLACK(left)) {
+		RBTreeNode* x = this;
+		RBTreeNode* sibling;
+
+		while (!x->isRoot() && x->isBlack()) {
+			RBTreeNode* p = x->parent();
+			if (x->isLeftChild()) {
+				sibling = p->right_child();
+				if (sibling->isRed()) {
+					sibling->set_color(kBlack);
+					p->set_color(kRed);
+					p->RotateToLeft();
+					sibling = p->right_child();
+				}
+				if (RB_ISBLACK(sibling->left_child())
+						&& RB_ISBLACK(sibling->right_child())) {
+					sibling->set_color(kRed);
+					x = p;
+					continue;
+				}
+				if (RB_ISBLACK(sibling->right_child())) {
+					sibling->left_child()->set_color(kBlack);
+					sibling->set_color(kRed);
+					sibling->RotateToRight();
+					sibling = p->right_child();
+				}
+				sibling->set_color(p->color());
+				p->set_color(kBlack);
 				sibling->right_child()->set_color(kBlack);
-				sibling->set_color(kRed);
-				sibling->RotateToLeft();
-				sibling = parent()->left_child();
-				sibling->set_color(parent()->color());
-				parent()->set_color(kBlack);
+				p->RotateToLeft();
+			} else {
+				sibling = p->left_child();
+				if (sibling->isRed()) {
+					sibling->set_color(kBlack);
+					p->set_color(kRed);
+					p->RotateToRight();
+					sibling = p->left_child();
+				}
+				if (RB_ISBLACK(sibling->left_child())
+						&& RB_ISBLACK(sibling->right_child())) {
+					sibling->set_color(kRed);
+					x = p;
+					continue;
+				}
+				if (RB_ISBLACK(sibling->left_child())) {
+					sibling->right_child()->set_color(kBlack);
+					sibling->set_color(kRed);
+					sibling->RotateToLeft();
+					sibling = p->left_child();
+				}
+				sibling->set_color(p->color());
+				p->set_color(kBlack);
 				sibling->left_child()->set_color(kBlack);
-				parent()->RotateToRight();
-				tree()->root()->InternalRemoveFixUp();
+				p->RotateToRight();
 			}
+			x = tree()->root();
 		}
+		x->set_color(kBlack);
 	}
 
 	void set_id(int id)
@@ -462,9 +506,12 @@ private:
 		_id = id;
 	}
 
-	RBTreeNode* _parent;
-	RBTreeNode* _left_child;
-	RBTreeNode* _right_child;
+	NodeIndex _parent;
+	NodeIndex _left_child;
+	NodeIndex _right_child;
+	NodeIndex _previous; /**< In order */
+	NodeIndex _next;
+	NodeIndex _index;
 	Color _color;
 	T _data;
 	RBTree<T>* _tree;
@@ -477,6 +524,9 @@ private:
  *
  * Here, the insertion is unusual, more like an "attach" node to one side
  * instead of a real insert method.  The class VoronoiTree implements this.
+ *
+ * Nodes live in a NodePool owned by the tree and are linked by their pool
+ * index.  Use CreateNode() and DestroyNode() instead of new and delete.
  */
 template<class T>
 class RBTree {
@@ -490,7 +540,6 @@ public:
 
 	virtual ~RBTree()
 	{
-		FreeAllNodes();
 	}
 
 	bool isEmpty() const
@@ -523,16 +572,100 @@ public:
 		_root = root;
 	}
 
-private:
-	void FreeAllNodes()
+	RBTreeNode<T>* node(NodeIndex index) const
 	{
-		if (!isEmpty()) {
-			root()->FreeChildNodes();
-			delete root();
-			set_root(NULL);
-		}
+		if (index == kNullNode)
+			return NULL;
+		return _pool.at(index);
+	}
+
+	/**
+	 * Number of nodes currently in use, internal nodes included.
+	 */
+	size_t size() const
+	{
+		return _pool.size();
+	}
+
+	/**
+	 * Drop the whole tree in O(1).  Node memory is kept for the next run.
+	 */
+	void Clear()
+	{
+		_pool.Clear();
+		set_root(NULL);
 	}
 
+	void ReserveNodes(size_t count)
+	{
+		_pool.Reserve(count);
+	}
+
+protected:
+	/**
+	 * Put |node| where |old_node| is.  The children of |old_node| are not
+	 * moved.
+	 */
+	void Replace(RBTreeNode<T>* old_node, RBTreeNode<T>* node)
+	{
+		RBTreeNode<T>* parent = old_node->parent();
+
+		if (parent == NULL)
+			set_root(node);
+		else if (old_node->isLeftChild())
+			parent->set_left_child(node);
+		else
+			parent->set_right_child(node);
+		node->set_parent(parent);
+		old_node->set_parent(NULL);
+	}
+
+	/**
+	 * Make |b| follow |a| in order.  Either may be NULL at the ends.
+	 */
+	void Link(RBTreeNode<T>* a, RBTreeNode<T>* b)
+	{
+		if (a != NULL)
+			a->set_next(b);
+		if (b != NULL)
+			b->set_previous(a);
+	}
+
+	/**
+	 * Remove |leaf| and its parent, moving the sibling of |leaf| up.
+	 * Both nodes are destroyed.  The parent is next to |leaf| in order,
+	 * so the two leave the order together.
+	 */
+	void RemoveLeaf(RBTreeNode<T>* leaf)
+	{
+		RBTreeNode<T>* parent = leaf->parent();
+		RBTreeNode<T>* sibling = leaf->isLeftChild() ?
+				parent->right_child() : parent->left_child();
+		bool black = parent->isBlack();
+
+		if (leaf->isLeftChild())
+			Link(leaf->previous(), parent->next());
+		else
+			Link(parent->previous(), leaf->next());
+		Replace(parent, sibling);
+		if (black)
+			sibling->PosRemoveFixUp();
+		DestroyNode(parent);
+		DestroyNode(leaf);
+	}
+
+	RBTreeNode<T>* CreateNode(T& data)
+	{
+		NodeIndex index = _pool.Allocate();
+		return new (_pool.at(index)) RBTreeNode<T>(data, this, index);
+	}
+
+	void DestroyNode(RBTreeNode<T>* node)
+	{
+		_pool.Free(node->index());
+	}
+
+private:
 	/* Workaround to walk tree InOrder updating the nodes. Used before
 	 * printing.  The IDs don't mean anything to the node as a real
 	 * identifier. */
@@ -544,6 +677,7 @@ private:
 	}
 
 	RBTreeNode<T>* _root;
+	NodePool<RBTreeNode<T> > _pool;
 };
 
 }
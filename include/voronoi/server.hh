@@ -0,0 +1,199 @@
+/**
+ *  @file
+ *  @brief Diagrams computed by a long-running process, over a UNIX socket.
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#ifndef _SERVER_HH_
+#define _SERVER_HH_
+
+#include <condition_variable>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+#include "batch.hh"
+#include "diagram.hh"
+#include "point.hh"
+#include "span.hh"
+
+namespace voronoi {
+
+/*
+ * A client sends a ServerRequest and then its sites, inline, or, with
+ * kSitesInFile, in a shared memory file whose descriptor comes with the
+ * request (SCM_RIGHTS).  The server answers with a ServerReply and a
+ * shared memory file holding the diagram: coordinates[2 * points],
+ * vertex_sites[vertices] and edges[edges], one after the other, as in
+ * VoronoiDCEL.  Requests on one connection are answered in order.
+ *
+ * Both files are memfds sealed with F_SEAL_SHRINK, so that neither side
+ * can truncate one under the other's mapping; files without the seal are
+ * refused.
+ */
+struct ServerRequest {
+	uint32_t magic;
+	uint32_t flags;
+	uint64_t sites;
+};
+
+struct ServerReply {
+	uint32_t magic;
+	uint32_t status; /**< kReplyOk, or kReplyFailed with no file */
+	uint64_t points;
+	uint64_t vertices;
+	uint64_t edges;
+	uint64_t bytes; /**< Size of the diagram in the file */
+};
+
+const uint32_t kServerMagic = 0x564f524e; /* "VORN" */
+const uint32_t kSitesInFile = 1;
+const uint32_t kReplyOk = 0;
+const uint32_t kReplyFailed = 1;
+
+/**
+ * Counters of a DiagramServer.
+ */
+struct ServerStats {
+	size_t requests;
+	size_t batches;
+	size_t largest_batch;
+	size_t refused; /**< Connections closed unserved, over the cap */
+
+	ServerStats() :
+			requests(0), batches(0), largest_batch(0), refused(0)
+	{
+	}
+};
+
+/**
+ * Computes the diagrams asked for on a UNIX socket, one thread per
+ * connection.  Requests that arrive within |window| microseconds of the
+ * first one waiting, up to kMaxBatch, go to a BatchEngine together, so
+ * the workers and their engines are shared by every client and keep their
+ * memory.  Each connection keeps its diagram and reply file from one
+ * request to the next.
+ */
+class DiagramServer {
+public:
+	/**
+	 * |threads| == 0 uses one worker per hardware thread.  Requests for
+	 * more than |max_sites| sites are answered with kReplyFailed and their
+	 * connection closed.  So are connections beyond |max_connections| open
+	 * at once, or ones no thread can be started for.
+	 */
+	explicit DiagramServer(unsigned int threads = 0,
+			unsigned int window = 100, size_t max_sites = kDefaultMaxSites,
+			size_t max_connections = kDefaultMaxConnections);
+	~DiagramServer();
+
+	/**
+	 * Listen on a socket at |path|, replacing any file there.
+	 */
+	bool Listen(const char* path);
+
+	/**
+	 * Serve until Stop(), then wait for every connection to close.
+	 */
+	void Run();
+
+	/**
+	 * Make Run() return.  Callable from any thread.
+	 */
+	void Stop();
+
+	ServerStats stats() const;
+
+	static const size_t kMaxBatch = 64;
+	static const size_t kDefaultMaxSites = 1 << 24;
+	static const size_t kDefaultMaxConnections = 256;
+
+private:
+	struct Connection;
+
+	DiagramServer(const DiagramServer&);
+	DiagramServer& operator=(const DiagramServer&);
+
+	void Serve(Connection* connection);
+	bool Receive(Connection* connection);
+	void Compute(Connection* connection);
+	bool Reply(Connection* connection);
+	void Dispatch();
+	void JoinConnections(bool all);
+	void Refuse(int client);
+
+	BatchEngine _engine;
+	unsigned int _window;
+	size_t _max_sites;
+	size_t _max_connections;
+	int _listener;
+	std::string _path;
+	bool _stopping;
+	bool _closed;
+	std::list<Connection*> _connections;
+	std::vector<Connection*> _pending;
+	std::vector<Connection*> _batch;
+	std::vector<Span<const Point> > _inputs;
+	std::vector<VoronoiDCEL> _outputs;
+	std::thread _dispatcher;
+	mutable std::mutex _mutex;
+	std::condition_variable _arrived;
+	std::condition_variable _computed;
+	ServerStats _stats;
+};
+
+/**
+ * Connection to a DiagramServer.  Sites of at least kSharedSitesBytes
+ * go in a shared memory file, reused from one request to the next;
+ * smaller ones go inline.
+ */
+class DiagramClient {
+public:
+	DiagramClient();
+	~DiagramClient();
+
+	bool Connect(const char* path);
+
+	/**
+	 * Have the server compute the diagram of |sites|.  It is mapped
+	 * read-only, with no copy, and stays valid until the next Compute().
+	 */
+	bool Compute(Span<const Point> sites);
+
+	size_t point_count() const;
+	size_t vertex_count() const;
+	size_t edge_count() const;
+	const double* coordinates() const;
+	const VertexSites* vertex_sites() const;
+	const DiagramEdge* edges() const;
+
+	/**
+	 * Copy the last diagram into |out|, replacing what it held.
+	 */
+	void CopyTo(VoronoiDCEL& out) const;
+
+	static const size_t kSharedSitesBytes = 1 << 16;
+
+private:
+	DiagramClient(const DiagramClient&);
+	DiagramClient& operator=(const DiagramClient&);
+
+	bool ShareSites(Span<const Point> sites);
+	void Unmap();
+
+	int _socket;
+	int _sites_file;
+	size_t _sites_capacity;
+	void* _sites_map;
+	void* _diagram;
+	ServerReply _reply;
+};
+
+}
+
+#endif /* _SERVER_HH_ */
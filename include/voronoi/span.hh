@@ -0,0 +1,83 @@
+/**
+ *  @file
+ *  @brief Non-owning view of a contiguous array.
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#ifndef _SPAN_HH_
+#define _SPAN_HH_
+
+#include <cstddef>
+#include <vector>
+
+namespace voronoi {
+
+/**
+ * Pointer and length pair, so the engine can read sites from any
+ * contiguous storage without copying it into a std::vector first.
+ */
+template<class T>
+class Span {
+public:
+	Span() :
+			_data(NULL), _size(0)
+	{
+	}
+
+	Span(T* data, size_t size) :
+			_data(data), _size(size)
+	{
+	}
+
+	template<class U, class A>
+	Span(const std::vector<U, A>& v) :
+			_data(v.empty() ? NULL : &v[0]), _size(v.size())
+	{
+	}
+
+	template<class U, class A>
+	Span(std::vector<U, A>& v) :
+			_data(v.empty() ? NULL : &v[0]), _size(v.size())
+	{
+	}
+
+	T* data() const
+	{
+		return _data;
+	}
+
+	size_t size() const
+	{
+		return _size;
+	}
+
+	bool empty() const
+	{
+		return _size == 0;
+	}
+
+	T* begin() const
+	{
+		return _data;
+	}
+
+	T* end() const
+	{
+		return _data + _size;
+	}
+
+	T& operator [](size_t i) const
+	{
+		return _data[i];
+	}
+
+private:
+	T* _data;
+	size_t _size;
+};
+
+}
+
+#endif /* _SPAN_HH_ */
@@ -1,9 +1,20 @@
 #ifndef __STATUS_H__
 #define __STATUS_H__
 
+#include <cassert>
+#include <limits>
+#include <stdint.h>
+#include <string>
+#include "point.hh"
+#include "predicates.hh"
+#include "queue.hh"
+
 namespace voronoi {
 
-struct Point;
+/**
+ * Breakpoint that has not met a Voronoi vertex yet.
+ */
+const uint32_t kNoVertex = -1U;
 
 class Status {
 public:
@@ -23,23 +34,131 @@ public:
 
 	std::string str() const;
 
-	Point* start() const;
-	Point* circle_event() const;
-	unsigned int face() const;
+	/**
+	 * Position of the breakpoint when the sweep line is at |sweep_y|.  The
+	 * last one is kept, so sites on the same row and the searches repeated
+	 * for one event solve each breakpoint once.
+	 */
+	double x(double sweep_y) const;
+
+	/**
+	 * Make this breakpoint the one between the arcs of |i| and |j|.
+	 */
+	void set_sites(Point* i, Point* j);
+
+	/**
+	 * Vertex, as an index in the output, where the edge traced by this
+	 * breakpoint starts.  Twins start where their site was inserted, which
+	 * is not a vertex.
+	 */
+	uint32_t start() const;
+	EventHandle circle_event_handle() const;
+
+	/**
+	 * Breakpoint tracing the other half of the same edge, if it is still
+	 * open.  A site splits an arc into two breakpoints that start at the
+	 * same point and move apart.
+	 */
+	Status* twin() const;
 
-	void set_start(Point* start);
-	void set_circle_event(Point* event);
-	void set_face(unsigned int face);
+	/**
+	 * Half-edge of the mesh traced by this breakpoint: the one that moves
+	 * with it, with the cell of |j| on its left.
+	 */
+	unsigned int half_edge() const;
+
+	void set_start(uint32_t start);
+	void set_twin(Status* twin);
+	void set_half_edge(unsigned int half_edge);
+	void set_circle_event_handle(EventHandle handle);
 	bool hasCircleEvent() const;
-	bool hasFace() const;
-	void RemoveCircleEvent();
 
 private:
-	Point* _circle_event;
-	Point* _start; /**< Edge start point */
-	unsigned int _face;
+	EventHandle _circle_event_handle; /**< Pending circle event, if any */
+	uint32_t _start;
+	Status* _twin;
+	unsigned int _half_edge;
+	mutable double _x; /**< Position at |_x_sweep| */
+	mutable double _x_sweep;
 };
 
+inline bool Status::operator <(const Status& b) const
+{
+	assert(i != NULL);
+	assert(j != NULL);
+	assert(b.arc != NULL);
+	return LeftOfBreakpoint(*i, *j, *b.arc);
+}
+
+inline bool Status::operator >(const Status& b) const
+{
+	assert(i != NULL);
+	assert(j != NULL);
+	assert(b.arc != NULL);
+	return b.arc->x() > x(b.arc->y());
+}
+
+inline double Status::x(double sweep_y) const
+{
+	if (sweep_y != _x_sweep) {
+		_x = i->GetXOfParabolaIntersection(j, sweep_y);
+		_x_sweep = sweep_y;
+	}
+	return _x;
+}
+
+inline void Status::set_sites(Point* i, Point* j)
+{
+	this->i = i;
+	this->j = j;
+	_x_sweep = std::numeric_limits<double>::quiet_NaN();
+}
+
+inline uint32_t Status::start() const
+{
+	return _start;
+}
+
+inline void Status::set_start(uint32_t start)
+{
+	_start = start;
+}
+
+inline Status* Status::twin() const
+{
+	return _twin;
+}
+
+inline void Status::set_twin(Status* twin)
+{
+	_twin = twin;
+}
+
+inline unsigned int Status::half_edge() const
+{
+	return _half_edge;
+}
+
+inline void Status::set_half_edge(unsigned int half_edge)
+{
+	_half_edge = half_edge;
+}
+
+inline EventHandle Status::circle_event_handle() const
+{
+	return _circle_event_handle;
+}
+
+inline void Status::set_circle_event_handle(EventHandle handle)
+{
+	_circle_event_handle = handle;
+}
+
+inline bool Status::hasCircleEvent() const
+{
+	return circle_event_handle() != kNoEvent;
+}
+
 }
 
 #endif 
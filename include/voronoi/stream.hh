@@ -0,0 +1,142 @@
+/**
+ *  @file
+ *  @brief 
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#ifndef _STREAM_HH_
+#define _STREAM_HH_
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <vector>
+#include <stdint.h>
+
+#include "diagram.hh"
+#include "point.hh"
+#include "queue.hh"
+#include "tree.hh"
+
+namespace voronoi {
+
+/**
+ * Edge reported by StreamingSweep: a DiagramEdge whose ends are the ids of
+ * reported points.
+ */
+struct StreamEdge {
+	uint64_t origin;
+	uint64_t destination;
+	int left_site;
+	int right_site;
+	bool origin_at_infinity;
+	bool destination_at_infinity;
+};
+
+/**
+ * Sweep that takes the sites one at a time, in the order of the sweep, and
+ * hands out the diagram as it becomes final.  Before a site goes in, every
+ * circle event above it is run; vertices are final when they are made and
+ * an edge once both of its ends are, so both are reported right away.
+ * Edges still open when Finish() is called are reported then, placed for
+ * the box around everything seen, as Engine would.
+ *
+ * Only the beach line is kept: its tree nodes and events are reused once
+ * they are behind the sweep line, and now and then the vertices no open
+ * edge needs and the sites no arc holds are dropped.  Memory is bounded by
+ * the largest beach line, not by the number of sites.
+ *
+ * Sites are named by their arrival order, from 0.  Points, vertices and
+ * ends at infinity alike, are numbered from 0 in the order they are
+ * reported; every end at infinity comes after every vertex.
+ */
+class StreamingSweep {
+public:
+	/**
+	 * Receives each point with its id.  The sites of an end at infinity
+	 * are all -1.
+	 */
+	typedef std::function<void(uint64_t id, const Point& at,
+			const VertexSites& sites)> PointCallback;
+
+	typedef std::function<void(const StreamEdge& edge)> EdgeCallback;
+
+	StreamingSweep(const PointCallback& on_point,
+			const EdgeCallback& on_edge);
+
+	/**
+	 * Sweep up to |site| and add it.  Returns its id, or kNoSite, adding
+	 * nothing, if it does not come strictly after the last site (highest y
+	 * first, left to right on ties) or Finish() was called.
+	 */
+	int AddSite(const Point& site);
+
+	/**
+	 * Run the events left and report the edges that never end.
+	 */
+	void Finish();
+
+	/**
+	 * Start a new diagram.
+	 */
+	void Reset();
+
+	/**
+	 * Arcs and breakpoints on the beach line.
+	 */
+	size_t beach_line_size() const;
+
+	size_t pending_events() const;
+
+	/**
+	 * Sites and points still held, reported or not.
+	 */
+	size_t held_sites() const;
+	size_t held_points() const;
+
+	static const int kNoSite = -1;
+
+	/**
+	 * Least held points and sites before they are compacted.
+	 */
+	static const size_t kMinCompaction = 1024;
+
+private:
+	/* |site| must come first: the tree holds pointers to it. */
+	struct Slot {
+		Point site;
+		int id;
+		uint32_t mark;
+	};
+
+	StreamingSweep(const StreamingSweep&);
+	StreamingSweep& operator=(const StreamingSweep&);
+
+	static int SlotId(const Point* site);
+	bool isAfterLast(const Point& site) const;
+	void Report();
+	void Compact();
+
+	VoronoiQueue _queue;
+	VoronoiDCEL _dcel;
+	VoronoiTree _tree;
+	std::deque<Slot> _slots; /**< Never moved, so the tree can point in */
+	std::vector<Slot*> _free_slots;
+	std::vector<uint64_t> _point_ids; /**< Of the reported points of _dcel */
+	std::vector<uint32_t> _kept;
+	size_t _reported_edges;
+	size_t _compact_at;
+	uint64_t _next_point;
+	int _next_site;
+	uint32_t _mark;
+	Point _last;
+	bool _finished;
+	PointCallback _on_point;
+	EdgeCallback _on_edge;
+};
+
+}
+
+#endif /* _STREAM_HH_ */
@@ -0,0 +1,109 @@
+/**
+ *  @file
+ *  @brief Parallel sweep over vertical strips of the sites.
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#ifndef _STRIPS_HH_
+#define _STRIPS_HH_
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "diagram.hh"
+#include "point.hh"
+#include "span.hh"
+
+namespace voronoi {
+
+/**
+ * Counters of the last StripEngine::Compute().
+ */
+struct StripStats {
+	size_t strips;
+	size_t sweeps; /**< Strip sweeps run, retries included */
+	size_t halo_sites; /**< Sites swept by a strip they do not belong to */
+	bool sequential; /**< The strips gave up for one sequential sweep */
+
+	StripStats() :
+			strips(0), sweeps(0), halo_sites(0), sequential(false)
+	{
+	}
+};
+
+/**
+ * Computes one diagram with a sweep per thread.  The sites are cut in
+ * vertical strips holding about the same number of sites, using quantiles
+ * of a sample of their x coordinates.  Each strip is swept together with a
+ * halo of the sites around it and the ends of the convex hull edges over
+ * it.
+ *
+ * An edge of the strip's diagram is right when the empty circles at both of
+ * its ends are empty among all sites, which a grid over the sites answers
+ * for the few circles that leave the halo.  Sites found inside a circle are
+ * added to the strip and it is swept again, until every edge around the
+ * sites of the strip is right.  Inputs where that costs too much, such as
+ * sites on a circle, whose empty circles hold everything, are given one
+ * sequential sweep instead.
+ *
+ * Edges on a seam are found by both strips and kept by the one on the left;
+ * the open ends of rays are placed again for the box of the whole diagram.
+ * The result matches the sequential sweep, up to the order of its edges and
+ * vertices.
+ */
+class StripEngine {
+public:
+	/**
+	 * |threads| == 0 uses one strip per hardware thread.
+	 */
+	explicit StripEngine(unsigned int threads = 0);
+	~StripEngine();
+
+	/**
+	 * Replace |out| with the diagram of |sites|, naming sites by their
+	 * position in |sites|.
+	 */
+	void Compute(Span<const Point> sites, VoronoiDCEL& out);
+
+	unsigned int threads() const;
+
+	const StripStats& stats() const;
+
+private:
+	struct Strip;
+	struct SiteGrid;
+	typedef void (StripEngine::*Phase)(size_t strip);
+
+	StripEngine(const StripEngine&);
+	StripEngine& operator=(const StripEngine&);
+
+	void RunOnStrips(Phase phase);
+	void FindHull(size_t strip);
+	void SweepStrip(size_t strip);
+	bool KeepEdges(size_t strip, double low, double high);
+	bool FindSitesInCircle(const VertexSites& sites, const Point& center,
+			double radius, double low, double high, size_t* budget,
+			std::vector<int>& found) const;
+	bool isHullEdge(int a, int b) const;
+	size_t StripOf(double x) const;
+	VertexSites GlobalSites(size_t strip, size_t vertex) const;
+	bool Merge(VoronoiDCEL& out);
+
+	std::vector<Strip*> _strips;
+	std::vector<double> _cuts; /**< x where each strip but the first starts */
+	std::vector<std::pair<int, int> > _hull_edges;
+	std::vector<int> _hull_sites;
+	SiteGrid* _grid;
+	Span<const Point> _sites;
+	BoundingBox _box;
+	double _halo;
+	std::atomic<bool> _give_up;
+	StripStats _stats;
+};
+
+}
+
+#endif /* _STRIPS_HH_ */
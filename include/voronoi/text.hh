@@ -0,0 +1,67 @@
+/**
+ *  @file
+ *  @brief Text files of coordinates, as VoronoiDrawer.py reads them.
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#ifndef _TEXT_HH_
+#define _TEXT_HH_
+
+#include <cstddef>
+#include <vector>
+#include "diagram.hh"
+#include "point.hh"
+#include "span.hh"
+
+namespace voronoi {
+
+/**
+ * Texts of at least this many bytes are parsed on several threads.
+ */
+extern const size_t kParallelParseBytes;
+
+/**
+ * Append the numbers of [|begin|, |end|), separated by any whitespace, to
+ * |out|.  Large texts are cut at line ends into one piece per thread
+ * (per hardware thread when |threads| is 0).  Returns false, leaving |out|
+ * as it was, if anything else is found.
+ */
+bool ParseNumbers(const char* begin, const char* end,
+		std::vector<double>& out, unsigned int threads = 0);
+
+/**
+ * ParseNumbers() on the whole file at |path|, which is mapped, not read.
+ */
+bool ReadNumbers(const char* path, std::vector<double>& out,
+		unsigned int threads = 0);
+
+/**
+ * Read |sites| from a file of x y pairs.  Fails on an odd count.
+ */
+bool ReadSites(const char* path, std::vector<Point>& sites,
+		unsigned int threads = 0);
+
+/**
+ * Write |count| values, |per_line| (> 0) to a line, each in the shortest
+ * form that reads back to the same double.
+ */
+bool WriteNumbers(const char* path, const double* values, size_t count,
+		size_t per_line);
+
+/**
+ * Write one x y pair per line.
+ */
+bool WriteSites(const char* path, Span<const Point> sites);
+
+/**
+ * Write |diagram| for VoronoiDrawer.py: the number of edges, one edge per
+ * line as x1 y1 x2 y2, then one site per line.
+ */
+bool WriteDrawerFile(const char* path, const VoronoiDCEL& diagram,
+		Span<const Point> sites);
+
+}
+
+#endif /* _TEXT_HH_ */
@@ -0,0 +1,133 @@
+/**
+ *  @file
+ *  @brief Binary event trace of the sweep.
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#ifndef _TRACE_HH_
+#define _TRACE_HH_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace voronoi {
+
+enum TraceEventType {
+	kTraceSite = 1, /**< Site event: a = site */
+	kTraceCircle, /**< Circle event queued: a = event point, b = arc site */
+	kTraceFalseAlarm, /**< Circle event erased: a = event point */
+	kTraceVertex, /**< Circle event handled: a = Voronoi vertex */
+	kTraceEdge /**< Edge emitted: a = origin, b = destination */
+};
+
+/**
+ * Fixed-size record, written to disk as is.
+ */
+struct TraceRecord {
+	uint32_t type;
+	uint32_t sequence; /**< Low bits of the event number */
+	double ax;
+	double ay;
+	double bx;
+	double by;
+};
+
+/**
+ * Ring buffer of the last |capacity| trace records.  Once full, the oldest
+ * records are overwritten, so a trace of any sweep costs a bounded amount of
+ * memory.
+ */
+class TraceBuffer {
+public:
+	/**
+	 * |capacity| is rounded up to a power of two.
+	 */
+	explicit TraceBuffer(size_t capacity = 1 << 16);
+
+	void Record(TraceEventType type, double ax, double ay, double bx,
+			double by)
+	{
+		TraceRecord& r = _records[_written & _mask];
+
+		r.type = type;
+		r.sequence = static_cast<uint32_t>(_written);
+		r.ax = ax;
+		r.ay = ay;
+		r.bx = bx;
+		r.by = by;
+		_written++;
+	}
+
+	void Clear();
+
+	/**
+	 * Records still in the buffer, oldest first.
+	 */
+	std::vector<TraceRecord> records() const;
+
+	size_t capacity() const;
+
+	/**
+	 * Records overwritten since the last Clear().
+	 */
+	uint64_t dropped() const;
+
+	/**
+	 * Write the buffer to |path| in binary form.  Returns false on I/O
+	 * errors.
+	 */
+	bool Save(const char* path) const;
+
+	/**
+	 * Replace the contents of the buffer with a trace written by Save().
+	 * Returns false if the file cannot be read or is not a trace.
+	 */
+	bool Load(const char* path);
+
+	/**
+	 * Human readable form of one record, for the offline decoder.
+	 */
+	static std::string Format(const TraceRecord& record);
+
+private:
+	std::vector<TraceRecord> _records;
+	size_t _mask;
+	uint64_t _written;
+};
+
+/**
+ * Runtime switch: records go to the buffer attached to the calling thread,
+ * and nowhere while none is attached.
+ */
+void SetTraceBuffer(TraceBuffer* buffer);
+
+TraceBuffer* trace_buffer();
+
+extern thread_local TraceBuffer* current_trace_buffer;
+
+inline void Trace(TraceEventType type, double ax, double ay, double bx = 0,
+		double by = 0)
+{
+	TraceBuffer* buffer = current_trace_buffer;
+
+	if (buffer != NULL)
+		buffer->Record(type, ax, ay, bx, by);
+}
+
+}
+
+/*
+ * Compile-time switch: without VORONOI_TRACE the trace points expand to
+ * nothing and their arguments are not evaluated.
+ */
+#ifdef VORONOI_TRACE
+#define VORONOI_TRACE_EVENT(...) voronoi::Trace(__VA_ARGS__)
+#else
+#define VORONOI_TRACE_EVENT(...) do { } while (0)
+#endif
+
+#endif /* _TRACE_HH_ */
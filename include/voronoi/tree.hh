@@ -9,24 +9,30 @@
 #ifndef _VORONOITREE_CC_
 #define _VORONOITREE_CC_
 
+#include <vector>
+#include <stdint.h>
+#include "beachline.hh"
+#include "diagram.hh"
+#include "point.hh"
 #include "rbtree.hh"
 
 namespace voronoi {
 
-struct Point;
 class Status;
-class VoronoiDCEL;
+struct CircleEvent;
 class VoronoiQueue;
 
 typedef RBTreeNode<Status> Node;
 
-class VoronoiTree: public RBTree<Status> {
+/**
+ * Beach line kept in a red-black tree: arcs are the leaves and the
+ * breakpoints between them the internal nodes.  Finding the arc above a
+ * site and the neighbors of an arc take O(log n).
+ */
+class VoronoiTree: public RBTree<Status>, public BeachLine {
 public:
-	VoronoiQueue* queue;
-	VoronoiDCEL* dcel;
-
 	VoronoiTree(VoronoiQueue* queue, VoronoiDCEL* dcel) :
-			queue(queue), dcel(dcel)
+			BeachLine(queue, dcel)
 	{
 	}
 
@@ -39,15 +45,48 @@ public:
 	 */
 	void InsertParabola(Point* parabola);
 
-	void RemoveParabola(Point* circle_event);
+	void RemoveParabola(const CircleEvent& taken);
 
 	void CheckCircle(Node* leaf, double sweepline_y);
 
+	/**
+	 * Emit the edges that are still open when the sweep ends.  Their open
+	 * ends are placed with BoundingBox::FarPoint() of the box around every
+	 * site and vertex.
+	 */
 	void FinishEdges();
 
+	/**
+	 * Run the whole sweep: drain the queue and close the edges left in
+	 * the tree.
+	 */
+	void Sweep();
+
+	/**
+	 * Drop the beach line and every edge left open by the sweep.  The
+	 * memory is kept for the next run.
+	 */
+	void Reset();
+
+	/**
+	 * Drop what the diagram holds besides the vertices open edges start
+	 * or end at: see BeachLine::CompactVertices().  Sweeps that never end
+	 * (StreamingSweep) read the finished edges and call this now and then
+	 * to bound their memory.
+	 */
+	void CompactDiagram(std::vector<uint32_t>& kept);
+
+	/**
+	 * Site of the arc right above |site|, or NULL if there is no arc yet.
+	 */
+	const Point* ArcAbove(const Point* site) const;
+
 	void PrintTree();
 
 private:
+	void InsertBesideParabola(Node* nearest, Point* parabola);
+	Node* FirstTied(Node* leaf, const CircleEvent& event);
+	bool EventFirst(const CircleEvent& event, const Point* site) const;
 	Node* CreateBreakpointNode(Point* i, Point* j);
 	Node* CreateParabolaNode(Point* parabola);
 
@@ -3,17 +3,28 @@
 
 #include <algorithm>
 #include <vector>
+#include "batch.hh"
+#include "binary.hh"
+#include "clip.hh"
+#include "delaunay.hh"
 #include "diagram.hh"
+#include "dynamic.hh"
+#include "engine.hh"
+#include "export.hh"
 #include "face.hh"
 #include "point.hh"
+#include "predicates.hh"
 #include "queue.hh"
+#include "server.hh"
 #include "status.hh"
+#include "stream.hh"
+#include "strips.hh"
+#include "text.hh"
 #include "tree.hh"
 
 namespace voronoi {
 
 class VoronoiQueue;
-class VoronoiDCEL;
 
 class Voronoi {
 public:
@@ -22,12 +33,10 @@ public:
 	virtual ~Voronoi();
 
 	std::vector<Point*> sites;
+	std::vector<Point> site_copies; /**< |sites|, one after the other */
 	VoronoiQueue queue;
 	VoronoiDCEL dcel;
 	VoronoiTree tree;
-private:
-	void HandleSiteEvent(Point* p);
-	void HandleCircleEvent(Point* p);
 };
 
 }
@@ -0,0 +1,98 @@
+"""Checks of the voronoi module; run with the module on PYTHONPATH.
+
+NumPy is not needed: array.array and memoryview give the buffers.
+"""
+import array
+import gc
+import random
+import unittest
+
+import voronoi
+
+
+def random_sites(count, seed):
+    generator = random.Random(seed)
+    return array.array('d', [generator.uniform(0, 1000)
+                             for _ in range(2 * count)])
+
+
+class ComputeTest(unittest.TestCase):
+
+    def test_shapes(self):
+        count = 500
+        sites = random_sites(count, 1)
+        for argument in (sites,
+                         memoryview(sites).cast('B').cast('d', [count, 2])):
+            diagram = voronoi.compute(argument)
+            vertices = diagram.vertices.shape[0]
+            edges = diagram.edges.shape[0]
+            self.assertEqual(2, diagram.points.shape[1])
+            self.assertGreaterEqual(diagram.points.shape[0], vertices)
+            self.assertEqual((vertices, 3), diagram.vertex_sites.shape)
+            self.assertEqual((edges, 2), diagram.edge_sites.shape)
+            self.assertEqual((edges, 2), diagram.edge_at_infinity.shape)
+            self.assertEqual('d', diagram.points.format)
+            self.assertEqual('I', diagram.edges.format)
+            self.assertEqual('i', diagram.edge_sites.format)
+            self.assertIsNone(diagram.cell_coordinates)
+            self.assertIsNone(diagram.cell_offsets)
+            points = diagram.points.shape[0]
+            for origin, destination in diagram.edges.tolist():
+                self.assertLess(origin, points)
+                self.assertLess(destination, points)
+            for left, right in diagram.edge_sites.tolist():
+                self.assertTrue(0 <= left < count and 0 <= right < count)
+                self.assertNotEqual(left, right)
+        self.assertEqual(0, voronoi.compute(array.array('d')).points.shape[0])
+
+    def test_read_only(self):
+        diagram = voronoi.compute(random_sites(50, 2))
+        view = diagram.points
+        self.assertTrue(view.readonly)
+        with self.assertRaises(TypeError):
+            view[0, 0] = 1.0
+        for name in ('vertex_sites', 'edges', 'edge_sites'):
+            self.assertTrue(getattr(diagram, name).readonly)
+            with self.assertRaises(TypeError):
+                getattr(diagram, name)[0, 0] = 0
+
+    def test_views_keep_the_diagram(self):
+        diagram = voronoi.compute(random_sites(200, 3))
+        points = diagram.points
+        expected = points.tolist()
+        del diagram
+        gc.collect()
+        voronoi.compute(random_sites(200, 4))
+        self.assertEqual(expected, points.tolist())
+
+    def test_box(self):
+        count = 300
+        box = (100.0, 200.0, 900.0, 800.0)
+        diagram = voronoi.compute(random_sites(count, 5), box=box)
+        offsets = diagram.cell_offsets.tolist()
+        corners = diagram.cell_coordinates.tolist()
+        self.assertEqual(count + 1, len(offsets))
+        self.assertEqual(len(corners), offsets[-1])
+        self.assertEqual(sorted(offsets), offsets)
+        slack = 1e-9 * 1000
+        for x, y in corners:
+            self.assertTrue(box[0] - slack <= x <= box[2] + slack)
+            self.assertTrue(box[1] - slack <= y <= box[3] + slack)
+
+    def test_bad_input(self):
+        bad = (array.array('f', [1, 2]), array.array('d', [1, 2, 3]),
+               memoryview(array.array('d', range(6))).cast('B').cast(
+                   'd', [2, 3]))
+        for sites in bad:
+            with self.assertRaises(ValueError):
+                voronoi.compute(sites)
+        with self.assertRaises(TypeError):
+            voronoi.compute([1.0, 2.0])
+        with self.assertRaises(TypeError):
+            voronoi.compute(array.array('d', [1, 2]), box=(0, 0, 1))
+        with self.assertRaises(TypeError):
+            voronoi.compute(array.array('d', [1, 2]), box=(0, 0, 1, 'a'))
+
+
+if __name__ == '__main__':
+    unittest.main()
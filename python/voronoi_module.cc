@@ -0,0 +1,373 @@
+/**
+ *  @file
+ *  @brief Python module: the sweep over any buffer of doubles.
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <utility>
+#include <voronoi/voronoi.hh>
+
+/*
+ * voronoi.compute(sites, box=None) sweeps |sites|, anything with the
+ * buffer protocol that holds C-contiguous doubles, shaped (n, 2) or (2n,):
+ * a NumPy float64 array is read in place.  The GIL is released during the
+ * sweep, so several threads can compute at once.
+ *
+ * The Diagram it returns owns the output of the engine, and its arrays
+ * are read-only views of it, with no copy: numpy.asarray() of any of them
+ * shares the memory and keeps the diagram alive.
+ *
+ *   points            (k, 2) float64  vertices first, then ends at
+ *                                     infinity
+ *   vertices          (v, 2) float64  the first v points
+ *   vertex_sites      (v, 3) int32
+ *   edges             (m, 2) uint32   origin and destination point
+ *   edge_sites        (m, 2) int32    left and right site
+ *   edge_at_infinity  (m, 2) bool
+ *
+ * With box = (min_x, min_y, max_x, max_y), the diagram is also clipped to
+ * it, and the corners of cell i are cell_coordinates[cell_offsets[i]:
+ * cell_offsets[i + 1]], counterclockwise; both are None otherwise.
+ */
+
+using voronoi::BoundingBox;
+using voronoi::ClippedDiagram;
+using voronoi::DiagramEdge;
+using voronoi::Point;
+using voronoi::Span;
+using voronoi::VertexSites;
+using voronoi::VoronoiDCEL;
+
+PyMODINIT_FUNC PyInit_voronoi(void);
+
+struct DiagramObject {
+	PyObject_HEAD
+	VoronoiDCEL diagram;
+	ClippedDiagram* clipped;
+	size_t sites;
+};
+
+/* Exports one array of a Diagram, which it keeps alive. */
+struct ViewObject {
+	PyObject_HEAD
+	PyObject* owner;
+	void* data;
+	const char* format;
+	Py_ssize_t itemsize;
+	Py_ssize_t shape[2];
+	Py_ssize_t strides[2];
+	int ndim;
+};
+
+static PyTypeObject* diagram_type;
+static PyTypeObject* view_type;
+
+/* Buffers may not be NULL, even empty ones. */
+static char empty_buffer;
+
+/* Instances of heap types hold a reference to their type. */
+static void DeallocView(ViewObject* self)
+{
+	PyTypeObject* type = Py_TYPE(self);
+
+	Py_XDECREF(self->owner);
+	type->tp_free(reinterpret_cast<PyObject*>(self));
+	Py_DECREF(type);
+}
+
+static int GetViewBuffer(ViewObject* self, Py_buffer* view, int flags)
+{
+	if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE) {
+		PyErr_SetString(PyExc_BufferError, "diagram arrays are read-only");
+		return -1;
+	}
+	view->buf = self->data != NULL ? self->data : &empty_buffer;
+	view->obj = reinterpret_cast<PyObject*>(self);
+	Py_INCREF(self);
+	view->len = self->itemsize;
+	for (int i = 0; i < self->ndim; i++)
+		view->len *= self->shape[i];
+	view->readonly = 1;
+	view->itemsize = self->itemsize;
+	view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>(self->format)
+			: NULL;
+	view->ndim = self->ndim;
+	view->shape = self->shape;
+	view->strides = self->strides;
+	view->suboffsets = NULL;
+	view->internal = NULL;
+	return 0;
+}
+
+/*
+ * Memoryview of |rows| rows of |columns| items of |format| from |data| on,
+ * |stride| bytes apart.
+ */
+static PyObject* CreateView(PyObject* owner, const void* data,
+		const char* format, Py_ssize_t itemsize, size_t rows, size_t columns,
+		Py_ssize_t stride)
+{
+	ViewObject* view = PyObject_New(ViewObject, view_type);
+
+	if (view == NULL)
+		return NULL;
+	Py_INCREF(owner);
+	view->owner = owner;
+	view->data = const_cast<void*>(data);
+	view->format = format;
+	view->itemsize = itemsize;
+	view->shape[0] = rows;
+	view->shape[1] = columns;
+	view->strides[0] = stride;
+	view->strides[1] = itemsize;
+	view->ndim = columns > 1 ? 2 : 1;
+	PyObject* memory = PyMemoryView_FromObject(
+			reinterpret_cast<PyObject*>(view));
+	Py_DECREF(view);
+	return memory;
+}
+
+static void DeallocDiagram(DiagramObject* self)
+{
+	PyTypeObject* type = Py_TYPE(self);
+
+	self->diagram.~VoronoiDCEL();
+	delete self->clipped;
+	type->tp_free(reinterpret_cast<PyObject*>(self));
+	Py_DECREF(type);
+}
+
+static PyObject* GetPoints(DiagramObject* self, void* vertices_only)
+{
+	const VoronoiDCEL& d = self->diagram;
+
+	return CreateView(reinterpret_cast<PyObject*>(self),
+			d.coordinates().data(), "d", sizeof(double),
+			vertices_only ? d.vertex_count() : d.point_count(), 2,
+			2 * sizeof(double));
+}
+
+static PyObject* GetVertexSites(DiagramObject* self, void*)
+{
+	return CreateView(reinterpret_cast<PyObject*>(self),
+			self->diagram.vertex_sites().data(), "i", sizeof(int),
+			self->diagram.vertex_count(), 3, sizeof(VertexSites));
+}
+
+/* The fields of DiagramEdge come in pairs of the same type. */
+static PyObject* GetEdgeFields(DiagramObject* self, void* field)
+{
+	const std::vector<DiagramEdge>& edges = self->diagram.edges();
+	size_t offset = reinterpret_cast<size_t>(field);
+	const char* base = reinterpret_cast<const char*>(edges.data());
+	const char* format = offset == offsetof(DiagramEdge, origin) ? "I"
+			: offset == offsetof(DiagramEdge, left_site) ? "i" : "?";
+	Py_ssize_t itemsize = *format == '?' ? sizeof(bool) : sizeof(uint32_t);
+
+	return CreateView(reinterpret_cast<PyObject*>(self),
+			base != NULL ? base + offset : NULL, format, itemsize,
+			edges.size(), 2, sizeof(DiagramEdge));
+}
+
+static PyObject* GetCellCoordinates(DiagramObject* self, void*)
+{
+	if (self->clipped == NULL)
+		Py_RETURN_NONE;
+	const std::vector<double>& corners = self->clipped->cell_coordinates();
+	return CreateView(reinterpret_cast<PyObject*>(self), corners.data(), "d",
+			sizeof(double), corners.size() / 2, 2, 2 * sizeof(double));
+}
+
+static PyObject* GetCellOffsets(DiagramObject* self, void*)
+{
+	if (self->clipped == NULL)
+		Py_RETURN_NONE;
+	const std::vector<uint32_t>& offsets = self->clipped->cell_offsets();
+	return CreateView(reinterpret_cast<PyObject*>(self), offsets.data(), "I",
+			sizeof(uint32_t), offsets.size(), 1, sizeof(uint32_t));
+}
+
+static PyGetSetDef diagram_getset[] = {
+	{ "points", reinterpret_cast<getter>(GetPoints), NULL, NULL, NULL },
+	{ "vertices", reinterpret_cast<getter>(GetPoints), NULL, NULL,
+			reinterpret_cast<void*>(1) },
+	{ "vertex_sites", reinterpret_cast<getter>(GetVertexSites), NULL, NULL,
+			NULL },
+	{ "edges", reinterpret_cast<getter>(GetEdgeFields), NULL, NULL,
+			reinterpret_cast<void*>(offsetof(DiagramEdge, origin)) },
+	{ "edge_sites", reinterpret_cast<getter>(GetEdgeFields), NULL, NULL,
+			reinterpret_cast<void*>(offsetof(DiagramEdge, left_site)) },
+	{ "edge_at_infinity", reinterpret_cast<getter>(GetEdgeFields), NULL,
+			NULL, reinterpret_cast<void*>(offsetof(DiagramEdge,
+					origin_at_infinity)) },
+	{ "cell_coordinates", reinterpret_cast<getter>(GetCellCoordinates), NULL,
+			NULL, NULL },
+	{ "cell_offsets", reinterpret_cast<getter>(GetCellOffsets), NULL, NULL,
+			NULL },
+	{ NULL, NULL, NULL, NULL, NULL }
+};
+
+/*
+ * Doubles in native order: "d", maybe with a byte order prefix that
+ * matches this machine.
+ */
+static bool isDoubleFormat(const char* format)
+{
+	if (format == NULL)
+		return true;
+	if (*format == '@' || *format == '=')
+		format++;
+#if PY_LITTLE_ENDIAN
+	else if (*format == '<')
+		format++;
+#else
+	else if (*format == '>' || *format == '!')
+		format++;
+#endif
+	return strcmp(format, "d") == 0;
+}
+
+static PyObject* Compute(PyObject*, PyObject* args, PyObject* keywords)
+{
+	static const char* names[] = { "sites", "box", NULL };
+	PyObject* input;
+	PyObject* box = Py_None;
+	double b[4];
+
+	if (!PyArg_ParseTupleAndKeywords(args, keywords, "O|O",
+			const_cast<char**>(names), &input, &box))
+		return NULL;
+	if (box != Py_None && !PyArg_ParseTuple(box, "dddd;box is (min_x, "
+			"min_y, max_x, max_y)", &b[0], &b[1], &b[2], &b[3]))
+		return NULL;
+
+	Py_buffer sites;
+	if (PyObject_GetBuffer(input, &sites, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT)
+			!= 0)
+		return NULL;
+	bool pairs = sites.ndim == 2 ? sites.shape[1] == 2
+			: sites.ndim == 1 && sites.len % (2 * sizeof(double)) == 0;
+	if (!isDoubleFormat(sites.format) || sites.itemsize != sizeof(double)
+			|| !pairs) {
+		PyBuffer_Release(&sites);
+		PyErr_SetString(PyExc_ValueError,
+				"sites must be float64, shaped (n, 2) or (2n,)");
+		return NULL;
+	}
+
+	DiagramObject* self = PyObject_New(DiagramObject, diagram_type);
+	if (self == NULL) {
+		PyBuffer_Release(&sites);
+		return NULL;
+	}
+	new (&self->diagram) VoronoiDCEL();
+	self->clipped = NULL;
+	self->sites = sites.len / sizeof(Point);
+	if (box != Py_None) {
+		self->clipped = new (std::nothrow) ClippedDiagram();
+		if (self->clipped == NULL) {
+			PyBuffer_Release(&sites);
+			Py_DECREF(self);
+			return PyErr_NoMemory();
+		}
+	}
+
+	/* No exception may cross the C API, nor be raised without the GIL. */
+	Span<const Point> points(static_cast<const Point*>(sites.buf),
+			self->sites);
+	PyObject* error = NULL;
+	char message[256];
+	Py_BEGIN_ALLOW_THREADS
+	try {
+		voronoi::Engine engine;
+		engine.compute(points);
+		self->diagram = engine.TakeDiagram();
+		if (self->clipped != NULL)
+			self->clipped->Clip(self->diagram, points,
+					BoundingBox(b[0], b[1], b[2], b[3]));
+	} catch (const std::bad_alloc&) {
+		error = PyExc_MemoryError;
+		message[0] = '\0';
+	} catch (const std::exception& e) {
+		error = PyExc_RuntimeError;
+		snprintf(message, sizeof(message), "%s", e.what());
+	} catch (...) {
+		error = PyExc_RuntimeError;
+		snprintf(message, sizeof(message), "sweep failed");
+	}
+	Py_END_ALLOW_THREADS
+	PyBuffer_Release(&sites);
+	if (error != NULL) {
+		Py_DECREF(self);
+		if (error == PyExc_MemoryError)
+			return PyErr_NoMemory();
+		PyErr_SetString(error, message);
+		return NULL;
+	}
+	return reinterpret_cast<PyObject*>(self);
+}
+
+static PyMethodDef methods[] = {
+	{ "compute", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(
+			void)>(Compute)), METH_VARARGS | METH_KEYWORDS,
+			"compute(sites, box=None) -> Diagram" },
+	{ NULL, NULL, 0, NULL }
+};
+
+static PyModuleDef module = {
+	PyModuleDef_HEAD_INIT, "voronoi", "Voronoi diagrams by Fortune's sweep.",
+	-1, methods, NULL, NULL, NULL, NULL
+};
+
+static PyType_Slot diagram_slots[] = {
+	{ Py_tp_dealloc, reinterpret_cast<void*>(DeallocDiagram) },
+	{ Py_tp_getset, diagram_getset },
+	{ Py_tp_doc, const_cast<char*>("Output of compute(), as read-only "
+			"arrays.") },
+	{ 0, NULL }
+};
+
+static PyType_Slot view_slots[] = {
+	{ Py_tp_dealloc, reinterpret_cast<void*>(DeallocView) },
+	{ Py_bf_getbuffer, reinterpret_cast<void*>(GetViewBuffer) },
+	{ 0, NULL }
+};
+
+static PyType_Spec diagram_spec = {
+	"voronoi.Diagram", sizeof(DiagramObject), 0, Py_TPFLAGS_DEFAULT,
+	diagram_slots
+};
+
+static PyType_Spec view_spec = {
+	"voronoi._View", sizeof(ViewObject), 0, Py_TPFLAGS_DEFAULT, view_slots
+};
+
+PyMODINIT_FUNC PyInit_voronoi(void)
+{
+	diagram_type = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(
+			&diagram_spec));
+	view_type = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(
+			&view_spec));
+	if (diagram_type == NULL || view_type == NULL)
+		return NULL;
+	PyObject* m = PyModule_Create(&module);
+	if (m == NULL)
+		return NULL;
+	Py_INCREF(diagram_type);
+	if (PyModule_AddObject(m, "Diagram",
+			reinterpret_cast<PyObject*>(diagram_type)) < 0) {
+		Py_DECREF(diagram_type);
+		Py_DECREF(m);
+		return NULL;
+	}
+	return m;
+}
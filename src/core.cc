@@ -1,8 +1,95 @@
+/**
+ *  @file
+ *  @brief Batch diagram of a binary site file into a binary diagram file.
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+#include <chrono>
 #include <iostream>
+#include <vector>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <voronoi/voronoi.hh>
 
-int main(int /*argc*/, char** /*argv*/)
+/*
+ * Sites come as packed pairs of doubles, x then y, in native byte order.
+ * The diagram goes out as described in binary.hh.
+ */
+
+static_assert(sizeof(voronoi::Point) == 2 * sizeof(double),
+		"sites are mapped straight from the file");
+
+struct Stage {
+	const char* name;
+	std::chrono::steady_clock::time_point start;
+};
+
+static void Report(Stage& stage, const char* next)
 {
-	std::cout << "Not yet implemented." << std::endl;
-	return 0;
+	std::chrono::steady_clock::time_point now =
+			std::chrono::steady_clock::now();
+	std::chrono::duration<double> elapsed = now - stage.start;
+	std::cerr << stage.name << ": " << elapsed.count() * 1e3 << " ms"
+			<< std::endl;
+	stage.name = next;
+	stage.start = now;
 }
 
+int main(int argc, char** argv)
+{
+	using namespace voronoi;
+
+	if (argc != 3 && argc != 4) {
+		std::cerr << "Usage: " << argv[0]
+				<< " <sites file> <diagram file> [threads]" << std::endl
+				<< "With threads, sweep in strips (0: one per core)."
+				<< std::endl;
+		return 2;
+	}
+
+	Stage stage = { "map", std::chrono::steady_clock::now() };
+	int in = open(argv[1], O_RDONLY);
+	struct stat status;
+	if (in < 0 || fstat(in, &status) != 0
+			|| status.st_size % sizeof(Point) != 0) {
+		std::cerr << argv[1] << ": not a readable site file" << std::endl;
+		return 1;
+	}
+	size_t count = status.st_size / sizeof(Point);
+	void* mapped = NULL;
+	if (count > 0) {
+		mapped = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, in, 0);
+		if (mapped == MAP_FAILED) {
+			std::cerr << argv[1] << ": cannot map" << std::endl;
+			return 1;
+		}
+		madvise(mapped, status.st_size, MADV_SEQUENTIAL);
+	}
+	close(in);
+	Span<const Point> sites(static_cast<const Point*>(mapped), count);
+	Report(stage, "sweep");
+
+	Engine engine;
+	if (argc == 4)
+		engine.set_algorithm(kStripSweep, atoi(argv[3]));
+	const VoronoiDCEL& diagram = engine.compute(sites);
+	if (mapped != NULL)
+		munmap(mapped, status.st_size);
+	Report(stage, "neighbors");
+
+	std::vector<uint32_t> first;
+	std::vector<int32_t> neighbors;
+	FindNeighbors(diagram, count, first, neighbors);
+	Report(stage, "write");
+
+	if (!WriteDiagramFile(argv[2], diagram, count, first, neighbors)) {
+		std::cerr << argv[2] << ": cannot write" << std::endl;
+		return 1;
+	}
+	Report(stage, NULL);
+	return 0;
+}
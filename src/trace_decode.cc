@@ -0,0 +1,31 @@
+/**
+ *  @file
+ *  @brief Print a binary sweep trace as text.
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+#include <iostream>
+#include <vector>
+#include <voronoi/trace.hh>
+
+int main(int argc, char** argv)
+{
+	using namespace voronoi;
+
+	if (argc != 2) {
+		std::cerr << "Usage: " << argv[0] << " <trace file>" << std::endl;
+		return 2;
+	}
+
+	TraceBuffer trace;
+	if (!trace.Load(argv[1])) {
+		std::cerr << argv[1] << ": not a readable trace" << std::endl;
+		return 1;
+	}
+
+	std::vector<TraceRecord> records = trace.records();
+	for (size_t i = 0; i < records.size(); i++)
+		std::cout << TraceBuffer::Format(records[i]) << "\n";
+	return 0;
+}
@@ -196,10 +196,9 @@ void DiagramViewer::DisplayCallback()
 
 	// Draw all vertices as spheres
 	glColor3f(0.5f, 0.0f, 0.1f);
-	const std::list<const Point*>& vertices = d->vertices();
-	for (std::list<const Point*>::const_iterator it = vertices.begin();
-			it != vertices.end(); it++) {
-		double x = (*it)->x() * 2, y = (*it)->y() * 2;
+	const std::vector<double>& points = d->coordinates();
+	for (size_t v = 0; v < d->vertex_count(); v++) {
+		double x = points[2 * v] * 2, y = points[2 * v + 1] * 2;
 
 		glTranslated(x, y, 0);
 		GLUquadricObj* cyl = gluNewQuadric();
@@ -216,14 +215,14 @@ void DiagramViewer::DisplayCallback()
 	glLineWidth(2);
 	glColor3f(1.3f, 1.3f, 1.7f);
 	//std::cerr << std::endl;
-	const std::list<const DiagramEdge*>& edges = d->edges();
-	for (std::list<const DiagramEdge*>::const_iterator it = edges.begin();
+	const std::vector<DiagramEdge>& edges = d->edges();
+	for (std::vector<DiagramEdge>::const_iterator it = edges.begin();
 			it != edges.end(); it++) {
-		const DiagramEdge* p = *it;
-		double x = p->origin->x() * 2;
-		double y = p->origin->y() * 2;
-		double dstx = p->destination->x() * 2;
-		double dsty = p->destination->y() * 2;
+		const DiagramEdge* p = &*it;
+		double x = points[2 * p->origin] * 2;
+		double y = points[2 * p->origin + 1] * 2;
+		double dstx = points[2 * p->destination] * 2;
+		double dsty = points[2 * p->destination + 1] * 2;
 
 		//std::cerr << x << ", " << y << " ---> " << dstx << ", " << dsty << "\n";
 
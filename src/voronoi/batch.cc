@@ -0,0 +1,167 @@
+/**
+ *  @file
+ *  @brief 
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <voronoi/batch.hh>
+
+namespace voronoi {
+
+/**
+ * Range of diagram indices still owned by one worker.  The owner takes from
+ * the front and thieves split off the back half.
+ */
+struct WorkRange {
+	std::mutex lock;
+	size_t begin;
+	size_t end;
+
+	WorkRange() :
+			begin(0), end(0)
+	{
+	}
+};
+
+static bool TakeFront(WorkRange& range, size_t& index)
+{
+	std::lock_guard<std::mutex> guard(range.lock);
+
+	if (range.begin == range.end)
+		return false;
+	index = range.begin++;
+	return true;
+}
+
+static bool StealBack(WorkRange& victim, size_t& begin, size_t& end)
+{
+	std::lock_guard<std::mutex> guard(victim.lock);
+	size_t left = victim.end - victim.begin;
+
+	if (left == 0)
+		return false;
+	end = victim.end;
+	begin = victim.end - (left + 1) / 2;
+	victim.end = begin;
+	return true;
+}
+
+static bool NextIndex(std::vector<WorkRange>& ranges, size_t self,
+		size_t& index)
+{
+	size_t begin, end;
+
+	if (TakeFront(ranges[self], index))
+		return true;
+	for (size_t i = 1; i < ranges.size(); i++) {
+		size_t victim = (self + i) % ranges.size();
+		if (!StealBack(ranges[victim], begin, end))
+			continue;
+		std::lock_guard<std::mutex> guard(ranges[self].lock);
+		index = begin;
+		ranges[self].begin = begin + 1;
+		ranges[self].end = end;
+		return true;
+	}
+	return false;
+}
+
+static void RunWorker(Engine* engine, std::vector<WorkRange>* ranges,
+		size_t self, const std::vector<Span<const Point> >* inputs,
+		std::vector<VoronoiDCEL>* outputs, std::exception_ptr* error)
+{
+	size_t index;
+
+	try {
+		while (NextIndex(*ranges, self, index)) {
+			/* Compute into the output's own buffers. */
+			engine->Recycle(std::move((*outputs)[index]));
+			engine->compute((*inputs)[index]);
+			(*outputs)[index] = engine->TakeDiagram();
+		}
+	} catch (...) {
+		*error = std::current_exception();
+		/* Let the other workers drain the remaining ranges and stop. */
+		for (size_t i = 0; i < ranges->size(); i++) {
+			std::lock_guard<std::mutex> guard((*ranges)[i].lock);
+			(*ranges)[i].end = (*ranges)[i].begin;
+		}
+	}
+}
+
+BatchEngine::BatchEngine(unsigned int threads)
+{
+	if (threads == 0)
+		threads = std::thread::hardware_concurrency();
+	if (threads == 0)
+		threads = 1;
+	for (unsigned int i = 0; i < threads; i++)
+		_engines.push_back(new Engine());
+}
+
+BatchEngine::~BatchEngine()
+{
+	for (size_t i = 0; i < _engines.size(); i++)
+		delete _engines[i];
+}
+
+void BatchEngine::Compute(const std::vector<Span<const Point> >& inputs,
+		std::vector<VoronoiDCEL>& outputs)
+{
+	size_t workers = _engines.size();
+
+	outputs.resize(inputs.size());
+	if (workers > inputs.size())
+		workers = inputs.size();
+	if (workers == 0)
+		return;
+
+	std::vector<WorkRange> ranges(workers);
+	std::vector<std::exception_ptr> errors(workers);
+	for (size_t i = 0; i < workers; i++) {
+		ranges[i].begin = inputs.size() * i / workers;
+		ranges[i].end = inputs.size() * (i + 1) / workers;
+	}
+
+	/* The calling thread is worker 0. */
+	std::vector<std::thread> pool;
+	for (size_t i = 1; i < workers; i++)
+		pool.push_back(std::thread(RunWorker, _engines[i], &ranges, i,
+				&inputs, &outputs, &errors[i]));
+	RunWorker(_engines[0], &ranges, 0, &inputs, &outputs, &errors[0]);
+	for (size_t i = 0; i < pool.size(); i++)
+		pool[i].join();
+
+	for (size_t i = 0; i < workers; i++)
+		if (errors[i])
+			std::rethrow_exception(errors[i]);
+}
+
+unsigned int BatchEngine::threads() const
+{
+	return _engines.size();
+}
+
+void ComputeBatch(const std::vector<Span<const Point> >& inputs,
+		std::vector<VoronoiDCEL>& outputs, unsigned int threads)
+{
+	BatchEngine batch(threads);
+
+	batch.Compute(inputs, outputs);
+}
+
+void ComputeBatch(const std::vector<std::vector<Point> >& inputs,
+		std::vector<VoronoiDCEL>& outputs, unsigned int threads)
+{
+	std::vector<Span<const Point> > spans(inputs.begin(), inputs.end());
+
+	ComputeBatch(spans, outputs, threads);
+}
+
+}
@@ -0,0 +1,482 @@
+/**
+ *  @file
+ *  @brief 
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <voronoi/beachline.hh>
+#include <voronoi/diagram.hh>
+#include <voronoi/face.hh>
+#include <voronoi/point.hh>
+#include <voronoi/predicates.hh>
+#include <voronoi/queue.hh>
+#include <voronoi/status.hh>
+#include <voronoi/trace.hh>
+
+namespace voronoi {
+
+BeachLine::BeachLine(VoronoiQueue* queue, VoronoiDCEL* dcel) :
+		queue(queue), dcel(dcel), _sites(NULL), _site_id(NULL),
+				_last_site(NULL), _mesh(NULL), _finite_vertices(0)
+{
+}
+
+void BeachLine::set_sites(const Point* sites)
+{
+	_sites = sites;
+}
+
+void BeachLine::set_site_id(SiteIdFunction id)
+{
+	_site_id = id;
+}
+
+int BeachLine::SiteId(const Point* site) const
+{
+	if (_site_id != NULL)
+		return _site_id(site);
+	return site - _sites;
+}
+
+void BeachLine::ResetEdges()
+{
+	_upward_edges.clear();
+	_bounds.Clear();
+	_last_site = NULL;
+}
+
+bool BeachLine::EnterSite(const Point* site)
+{
+	/* Sites come in sweep order, so copies of a site follow each other. */
+	if (_last_site != NULL && *_last_site == *site)
+		return false;
+	_last_site = site;
+	VORONOI_TRACE_EVENT(kTraceSite, site->x(), site->y());
+	_bounds.Extend(*site);
+	return true;
+}
+
+void BeachLine::SplitArc(const Point* site, const Point* arc, Status* left,
+		Status* right)
+{
+	/* Both start where the site meets the arc: see InsertionPoint(). */
+	left->set_twin(right);
+	right->set_twin(left);
+
+	if (_mesh != NULL) {
+		left->set_half_edge(CreateMeshEdge(site, arc));
+		right->set_half_edge(left->half_edge() + 1);
+	}
+}
+
+void BeachLine::PlaceBeside(Status* breakpoint)
+{
+	if (_mesh != NULL)
+		breakpoint->set_half_edge(CreateMeshEdge(breakpoint->j,
+				breakpoint->i));
+}
+
+void BeachLine::CheckCircle(Status* arc, NodeIndex handle, const Point* a,
+		const Point* c, double sweepline_y)
+{
+	const Point* b = arc->arc;
+
+	/*
+	 * The arc of |b| only shrinks to a point if the breakpoints around it
+	 * converge, that is, if a, b and c make a clockwise turn.  The sign is
+	 * exact, so nearly aligned sites neither lose nor invent an event.
+	 */
+	double turn = Orientation(*a, *b, *c);
+	if (turn >= 0)
+		return;
+
+	Point circle_bottom;
+	circle_bottom.SetCoordinatesToTheCircleBottom(a, b, c, turn);
+	/* Rounding can put the event a hair above the sweep line. */
+	if (circle_bottom.y() > sweepline_y)
+		circle_bottom.set_y(sweepline_y);
+
+	CircleEvent event = { circle_bottom.x(), circle_bottom.y(), handle };
+	arc->set_circle_event_handle(queue->push(event));
+
+	VORONOI_TRACE_EVENT(kTraceCircle, circle_bottom.x(), circle_bottom.y(),
+			b->x(), b->y());
+}
+
+void BeachLine::RemoveCircleEvent(Status* arc)
+{
+	if (!arc->hasCircleEvent())
+		return;
+	VORONOI_TRACE_EVENT(kTraceFalseAlarm,
+			queue->event(arc->circle_event_handle()).x,
+			queue->event(arc->circle_event_handle()).y);
+	queue->erase(arc->circle_event_handle());
+	arc->set_circle_event_handle(kNoEvent);
+}
+
+bool BeachLine::Overdue(const Point* site, const Point* a,
+		const Status* arc, const Point* c)
+{
+	return arc->hasCircleEvent() && InCircle(*c, *arc->arc, *a, *site) <= 0;
+}
+
+CircleEvent BeachLine::TakeCircleEvent(Status* arc)
+{
+	CircleEvent event = queue->event(arc->circle_event_handle());
+
+	queue->erase(arc->circle_event_handle());
+	arc->set_circle_event_handle(kNoEvent);
+	return event;
+}
+
+const size_t BeachLine::kLookAround;
+
+bool BeachLine::IsTied(const Status* arc, const CircleEvent& event) const
+{
+	if (!arc->hasCircleEvent())
+		return false;
+	const CircleEvent& other = queue->event(arc->circle_event_handle());
+	return VoronoiQueue::Tied(Point(other.x, other.y),
+			Point(event.x, event.y));
+}
+
+size_t BeachLine::FirstOfTied(size_t taken) const
+{
+	/* The event taken wins when its circle is empty, then the nearest. */
+	for (size_t d = 0; d < _tied.size(); d++) {
+		for (int side = 0; side < 2; side++) {
+			if (d == 0 && side == 1)
+				continue;
+			size_t k = side == 0 ? taken + d : taken - d;
+			if (k > taken + d || k == 0 || k + 1 >= _tied.size()
+					|| !_tied[k].tied)
+				continue;
+			const Point* a = _tied[k - 1].site;
+			const Point* b = _tied[k].site;
+			const Point* c = _tied[k + 1].site;
+			size_t j = 0;
+			for (; j < _tied.size(); j++) {
+				const Point* site = _tied[j].site;
+				if (site != a && site != b && site != c
+						&& InCircle(*c, *b, *a, *site) > 0)
+					break;
+			}
+			if (j == _tied.size())
+				return k;
+		}
+	}
+	return taken;
+}
+
+CircleEvent BeachLine::Postpone(const CircleEvent& event, Status* arc,
+		Status* neighbor)
+{
+	CircleEvent earlier = TakeCircleEvent(neighbor);
+
+	arc->set_circle_event_handle(queue->push(event));
+	return earlier;
+}
+
+void BeachLine::CloseArc(const Point* a, const Point* b, const Point* c,
+		Status* left, Status* right, Status* merged)
+{
+	Point center;
+	center.SetCoordinatesToTheCircleCenter(a, b, c);
+
+	VORONOI_TRACE_EVENT(kTraceVertex, center.x(), center.y());
+
+	_bounds.Extend(center);
+	uint32_t vertex = dcel->addVertex(center.x(), center.y(),
+			VertexSites(SiteId(a), SiteId(b), SiteId(c)));
+	CloseEdge(left, vertex);
+	CloseEdge(right, vertex);
+
+	merged->set_sites(const_cast<Point*>(a), const_cast<Point*>(c));
+	merged->set_start(vertex);
+	if (_mesh != NULL)
+		AddMeshVertex(&center, left, right, merged);
+}
+
+void BeachLine::CompactVertices(std::vector<uint32_t>& renumber,
+		std::vector<uint32_t>& kept)
+{
+	VoronoiDCEL compact;
+
+	for (size_t i = 0; i < _upward_edges.size(); i++)
+		renumber[_upward_edges[i].end] = 0;
+	kept.clear();
+	for (size_t v = 0; v < dcel->vertex_count(); v++) {
+		if (renumber[v] == kNoVertex)
+			continue;
+		Point at = dcel->point(v);
+		renumber[v] = compact.addVertex(at.x(), at.y(),
+				dcel->vertex_sites()[v]);
+		kept.push_back(v);
+	}
+	for (size_t i = 0; i < _upward_edges.size(); i++)
+		_upward_edges[i].end = renumber[_upward_edges[i].end];
+	*dcel = std::move(compact);
+}
+
+void BeachLine::FinishUpwardEdges()
+{
+	if (_mesh != NULL)
+		_finite_vertices = _mesh->getNumVertices();
+	for (size_t i = 0; i < _upward_edges.size(); i++) {
+		const UpwardEdge& edge = _upward_edges[i];
+		Point end = dcel->point(edge.end);
+		Point top = FarPoint(&end, 0, 1);
+		AddEdge(DiagramEdge(AddFarPoint(top), edge.end, edge.left_site,
+				edge.right_site, true, false));
+		if (_mesh != NULL)
+			SetMeshEndAtInfinity(edge.half_edge, &top);
+	}
+}
+
+void BeachLine::FinishBreakpoint(const Status* data)
+{
+	double dx = data->j->y() - data->i->y();
+	double dy = data->i->x() - data->j->x();
+	int left_site = SiteId(data->j);
+	int right_site = SiteId(data->i);
+
+	if (data->start() == kNoVertex && data->twin() == NULL) {
+		/* Two sites of the first row: the edge is a whole line. */
+		Point middle((data->i->x() + data->j->x()) / 2, data->i->y());
+		Point top = FarPoint(&middle, -dx, -dy);
+		Point bottom = FarPoint(&middle, dx, dy);
+		uint32_t origin = AddFarPoint(top);
+		AddEdge(DiagramEdge(origin, AddFarPoint(bottom), left_site,
+				right_site, true, true));
+		if (_mesh != NULL) {
+			SetMeshEndAtInfinity(data->half_edge(), &top);
+			SetMeshEndAtInfinity(data->half_edge() ^ 1, &bottom);
+		}
+		return;
+	}
+
+	Point start = data->twin() != NULL ? InsertionPoint(data)
+			: dcel->point(data->start());
+	Point end = FarPoint(&start, dx, dy);
+	if (data->twin() != NULL) {
+		/* Neither half ever ended: emit the line once, from one twin. */
+		if (std::less<const Status*>()(data, data->twin())) {
+			uint32_t origin = AddFarPoint(FarPoint(&start, -dx, -dy));
+			AddEdge(DiagramEdge(origin, AddFarPoint(end), left_site,
+					right_site, true, true));
+		}
+	} else {
+		AddEdge(DiagramEdge(data->start(), AddFarPoint(end), left_site,
+				right_site, false, true));
+	}
+	/* Each twin places the end it moves towards. */
+	if (_mesh != NULL)
+		SetMeshEndAtInfinity(data->half_edge() ^ 1, &end);
+}
+
+void BeachLine::FinishMesh()
+{
+	if (_mesh != NULL)
+		CloseMeshFrame();
+}
+
+/**
+ * Close the edge traced by |data| at |end|.  Edges of the first row have
+ * no start yet: they are emitted by FinishUpwardEdges(), once the bounds
+ * of the diagram are known.
+ */
+void BeachLine::CloseEdge(Status* data, uint32_t end)
+{
+	Status* twin = data->twin();
+
+	/* A breakpoint moves with its left site on the right. */
+	int left_site = SiteId(data->j);
+	int right_site = SiteId(data->i);
+
+	if (twin != NULL) {
+		/* The other half goes on, so the whole edge now starts here. */
+		twin->set_start(end);
+		twin->set_twin(NULL);
+		data->set_twin(NULL);
+	} else if (data->start() == kNoVertex) {
+		UpwardEdge edge = { end, left_site, right_site, data->half_edge() };
+		_upward_edges.push_back(edge);
+	} else {
+		AddEdge(DiagramEdge(data->start(), end, left_site, right_site, false,
+				false));
+	}
+}
+
+Point BeachLine::FarPoint(const Point* from, double dx, double dy) const
+{
+	return _bounds.FarPoint(*from, dx, dy);
+}
+
+uint32_t BeachLine::AddFarPoint(const Point& at)
+{
+	return dcel->addFarPoint(at.x(), at.y());
+}
+
+/**
+ * Where the edge of two twins starts: the point of the arc of the higher
+ * site right above the lower one, which split it.
+ */
+Point BeachLine::InsertionPoint(const Status* twin) const
+{
+	const Point* high = twin->i->y() > twin->j->y() ? twin->i : twin->j;
+	const Point* low = high == twin->i ? twin->j : twin->i;
+
+	return Point(low->x(), high->GetYOfParabolaInsersection(low));
+}
+
+void BeachLine::AddEdge(const DiagramEdge& edge)
+{
+	VORONOI_TRACE_EVENT(kTraceEdge, dcel->coordinates()[2 * edge.origin],
+			dcel->coordinates()[2 * edge.origin + 1],
+			dcel->coordinates()[2 * edge.destination],
+			dcel->coordinates()[2 * edge.destination + 1]);
+	dcel->addEdge(edge);
+}
+
+/**
+ * New edge of the mesh between the cells of |left| and |right|, with no
+ * ends yet.  Returns its half-edge on the side of |left|; the twin is the
+ * next one, so a half-edge and its twin only differ in the lowest bit.
+ */
+unsigned int BeachLine::CreateMeshEdge(const Point* left,
+		const Point* right)
+{
+	HalfEdgeDiagram::Face* left_face = _mesh->getFace(SiteId(left));
+	HalfEdgeDiagram::Face* right_face = _mesh->getFace(SiteId(right));
+	unsigned int half = _mesh->createEdge(NULL, left_face, NULL, right_face);
+
+	if (left_face->getBoundary() == NULL)
+		left_face->setBoundary(_mesh->getHalfEdge(half));
+	if (right_face->getBoundary() == NULL)
+		right_face->setBoundary(_mesh->getHalfEdge(half + 1));
+	return half;
+}
+
+/**
+ * Wire the vertex at |center| where the breakpoints |left| and |right|
+ * meet, and start the edge of |merged|, which now separates their outer
+ * sites.  The three cells around the vertex each get their boundary
+ * linked through it.
+ */
+void BeachLine::AddMeshVertex(const Point* center, const Status* left,
+		const Status* right, Status* merged)
+{
+	typedef HalfEdgeDiagram::HalfEdge HalfEdge;
+	HalfEdgeDiagram::Vertex* vertex = _mesh->createGetVertex();
+	HalfEdge* ab = _mesh->getHalfEdge(left->half_edge());
+	HalfEdge* bc = _mesh->getHalfEdge(right->half_edge());
+	unsigned int half = CreateMeshEdge(merged->j, merged->i);
+	HalfEdge* ac = _mesh->getHalfEdge(half);
+
+	vertex->getData() = *center;
+	vertex->setIncidentEdge(ac);
+	ab->getTwin()->setOrigin(vertex);
+	bc->getTwin()->setOrigin(vertex);
+	ac->setOrigin(vertex);
+
+	ab->setNext(bc->getTwin());
+	bc->setNext(ac);
+	ac->getTwin()->setNext(ab->getTwin());
+	merged->set_half_edge(half);
+}
+
+/**
+ * Start the half-edge |leaving| at a new vertex standing for infinity.
+ */
+void BeachLine::SetMeshEndAtInfinity(unsigned int leaving, const Point* at)
+{
+	HalfEdgeDiagram::Vertex* vertex = _mesh->createGetVertex();
+	HalfEdgeDiagram::HalfEdge* half = _mesh->getHalfEdge(leaving);
+
+	vertex->getData() = *at;
+	vertex->setIncidentEdge(half);
+	half->setOrigin(vertex);
+}
+
+/**
+ * Close the open cells.  The boundary of an open cell is one chain of
+ * half-edges from infinity back to infinity, or two for the strip between
+ * two parallel lines.  A frame edge joins the end of each chain to the
+ * start of the next one; the twins of the frame edges have no face and go
+ * around the whole diagram.
+ */
+void BeachLine::CloseMeshFrame()
+{
+	typedef HalfEdgeDiagram::HalfEdge HalfEdge;
+	typedef HalfEdgeDiagram::Vertex Vertex;
+	std::vector<HalfEdge>& halves = _mesh->getHalfEdges();
+	size_t edges = halves.size();
+	size_t faces = _mesh->getNumFaces();
+
+	if (_mesh->getNumVertices() == _finite_vertices)
+		return;
+	const Vertex* first = _mesh->getVertex(0);
+	ptrdiff_t finite = _finite_vertices;
+	std::vector<HalfEdge*> chains(faces * 4, NULL);
+	for (size_t i = 0; i < edges; i++) {
+		HalfEdge* start = &halves[i];
+		if (start->getOrigin() - first < finite)
+			continue;
+		HalfEdge* end = start;
+		while (end->getTwin()->getOrigin() - first < finite)
+			end = end->getNext();
+		size_t face = start->getFace() - _mesh->getFace(0);
+		size_t slot = chains[face * 4] == NULL ? 0 : 2;
+		chains[face * 4 + slot] = start;
+		chains[face * 4 + slot + 1] = end;
+	}
+
+	/* Frame half-edges inside the cells, by the vertex they end at. */
+	std::vector<HalfEdge*> frame(_mesh->getNumVertices(), NULL);
+	for (size_t face = 0; face < faces; face++) {
+		HalfEdge** chain = &chains[face * 4];
+		for (size_t c = 0; c < 4 && chain[c] != NULL; c += 2) {
+			/* With two chains, each one leads to the other. */
+			HalfEdge* end = chain[c + 1];
+			HalfEdge* next = chain[2] == NULL ? chain[0] : chain[2 - c];
+			HalfEdge* inner = _mesh->getHalfEdge(_mesh->createEdge(
+					end->getTwin()->getOrigin(), end->getFace(),
+					next->getOrigin(), NULL));
+			end->setNext(inner);
+			inner->setNext(next);
+			frame[next->getOrigin() - first] = inner;
+		}
+	}
+	for (size_t i = edges; i < halves.size(); i += 2) {
+		HalfEdge* outer = halves[i].getTwin();
+		outer->setNext(frame[halves[i].getOrigin() - first]->getTwin());
+	}
+}
+
+void BeachLine::set_mesh(HalfEdgeDiagram* mesh)
+{
+	_mesh = mesh;
+}
+
+void BeachLine::PrepareMesh(size_t sites)
+{
+	_mesh->clear();
+	_finite_vertices = 0;
+	/*
+	 * With the frame, every vertex has three edges and there is one face
+	 * per site plus the outside, so by Euler's formula there are at most
+	 * 2n - 2 vertices and 3n - 3 edges.
+	 */
+	_mesh->getVertices().reserve(2 * sites);
+	_mesh->getHalfEdges().reserve(6 * sites);
+	_mesh->getFaces().reserve(sites);
+	for (size_t i = 0; i < sites; i++)
+		_mesh->createGetFace(NULL)->getData().set_id(i);
+}
+
+}
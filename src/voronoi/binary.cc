@@ -0,0 +1,91 @@
+/**
+ *  @file
+ *  @brief Binary diagram files, as gerar_voronoi writes them.
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <voronoi/binary.hh>
+
+namespace voronoi {
+
+static_assert(sizeof(VertexSites) == 3 * sizeof(int32_t),
+		"vertex sites are written straight from the diagram");
+
+static char* Append(char* out, const void* data, size_t bytes)
+{
+	memcpy(out, data, bytes);
+	return out + bytes;
+}
+
+/*
+ * Counting first lets the lists go in place in two passes over the edges.
+ */
+void FindNeighbors(const VoronoiDCEL& diagram, size_t sites,
+		std::vector<uint32_t>& first, std::vector<int32_t>& neighbors)
+{
+	const std::vector<DiagramEdge>& edges = diagram.edges();
+
+	first.assign(sites + 1, 0);
+	for (size_t i = 0; i < edges.size(); i++) {
+		first[edges[i].left_site + 1]++;
+		first[edges[i].right_site + 1]++;
+	}
+	for (size_t i = 0; i < sites; i++)
+		first[i + 1] += first[i];
+	neighbors.resize(first[sites]);
+	std::vector<uint32_t> next(first.begin(), first.end() - 1);
+	for (size_t i = 0; i < edges.size(); i++) {
+		neighbors[next[edges[i].left_site]++] = edges[i].right_site;
+		neighbors[next[edges[i].right_site]++] = edges[i].left_site;
+	}
+}
+
+/*
+ * Every byte of the records is set, DiagramEdge included, so the same
+ * diagram always makes the same file.
+ */
+bool WriteDiagramFile(const char* path, const VoronoiDCEL& diagram,
+		size_t sites, const std::vector<uint32_t>& first,
+		const std::vector<int32_t>& neighbors)
+{
+	uint64_t header[8] = { 0, sites, diagram.point_count(),
+			diagram.vertex_count(), diagram.edges().size(), neighbors.size(),
+			0, 0 };
+	memcpy(header, kDiagramMagic, sizeof(header[0]));
+	size_t bytes = sizeof(header)
+			+ diagram.coordinates().size() * sizeof(double)
+			+ diagram.vertex_count() * sizeof(VertexSites)
+			+ diagram.edges().size() * sizeof(DiagramEdge)
+			+ first.size() * sizeof(uint32_t)
+			+ neighbors.size() * sizeof(int32_t);
+	int out = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	void* target = MAP_FAILED;
+	if (out < 0)
+		return false;
+	if (ftruncate(out, bytes) == 0)
+		target = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, out,
+				0);
+	close(out);
+	if (target == MAP_FAILED)
+		return false;
+
+	char* p = static_cast<char*>(target);
+	p = Append(p, header, sizeof(header));
+	p = Append(p, diagram.coordinates().data(),
+			diagram.coordinates().size() * sizeof(double));
+	p = Append(p, diagram.vertex_sites().data(),
+			diagram.vertex_count() * sizeof(VertexSites));
+	p = Append(p, diagram.edges().data(),
+			diagram.edges().size() * sizeof(DiagramEdge));
+	p = Append(p, first.data(), first.size() * sizeof(uint32_t));
+	Append(p, neighbors.data(), neighbors.size() * sizeof(int32_t));
+	return munmap(target, bytes) == 0;
+}
+
+}
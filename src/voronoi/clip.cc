@@ -0,0 +1,345 @@
+/**
+ *  @file
+ *  @brief 
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <voronoi/clip.hh>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace voronoi {
+
+/*
+ * Stand-in for 1 / 0 in the kernel.  A finite value keeps 0 / 0 out: a
+ * segment parallel to a side and lying on it gets the parameter 0, not NaN.
+ */
+static const double kHuge = 1e300;
+
+static void ClipSegmentsScalar(size_t begin, size_t end, double* x0,
+		double* y0, double* x1, double* y1, uint8_t* inside,
+		const BoundingBox& r)
+{
+	for (size_t i = begin; i < end; i++) {
+		double dx = x1[i] - x0[i], dy = y1[i] - y0[i];
+		double ix = std::min(std::max(1 / dx, -kHuge), kHuge);
+		double iy = std::min(std::max(1 / dy, -kHuge), kHuge);
+		double ax = (r.min_x() - x0[i]) * ix, bx = (r.max_x() - x0[i]) * ix;
+		double ay = (r.min_y() - y0[i]) * iy, by = (r.max_y() - y0[i]) * iy;
+		double enter = std::max(0.0, std::max(std::min(ax, bx),
+				std::min(ay, by)));
+		double exit = std::min(1.0, std::min(std::max(ax, bx),
+				std::max(ay, by)));
+
+		inside[i] = enter <= exit;
+		/* Moving each end from itself leaves an unclipped end exact. */
+		double cx = x1[i] + (exit - 1) * dx, cy = y1[i] + (exit - 1) * dy;
+		x0[i] = std::min(std::max(x0[i] + enter * dx, r.min_x()), r.max_x());
+		y0[i] = std::min(std::max(y0[i] + enter * dy, r.min_y()), r.max_y());
+		x1[i] = std::min(std::max(cx, r.min_x()), r.max_x());
+		y1[i] = std::min(std::max(cy, r.min_y()), r.max_y());
+	}
+}
+
+void ClipSegments(size_t count, double* x0, double* y0, double* x1,
+		double* y1, uint8_t* inside, const BoundingBox& rectangle)
+{
+	size_t i = 0;
+
+#if defined(__SSE2__)
+	const __m128d zero = _mm_setzero_pd(), one = _mm_set1_pd(1);
+	const __m128d huge = _mm_set1_pd(kHuge), tiny = _mm_set1_pd(-kHuge);
+	const __m128d min_x = _mm_set1_pd(rectangle.min_x());
+	const __m128d max_x = _mm_set1_pd(rectangle.max_x());
+	const __m128d min_y = _mm_set1_pd(rectangle.min_y());
+	const __m128d max_y = _mm_set1_pd(rectangle.max_y());
+
+	for (; i + 2 <= count; i += 2) {
+		__m128d px = _mm_loadu_pd(x0 + i), py = _mm_loadu_pd(y0 + i);
+		__m128d qx = _mm_loadu_pd(x1 + i), qy = _mm_loadu_pd(y1 + i);
+		__m128d dx = _mm_sub_pd(qx, px), dy = _mm_sub_pd(qy, py);
+		__m128d ix = _mm_min_pd(_mm_max_pd(_mm_div_pd(one, dx), tiny), huge);
+		__m128d iy = _mm_min_pd(_mm_max_pd(_mm_div_pd(one, dy), tiny), huge);
+		__m128d ax = _mm_mul_pd(_mm_sub_pd(min_x, px), ix);
+		__m128d bx = _mm_mul_pd(_mm_sub_pd(max_x, px), ix);
+		__m128d ay = _mm_mul_pd(_mm_sub_pd(min_y, py), iy);
+		__m128d by = _mm_mul_pd(_mm_sub_pd(max_y, py), iy);
+		__m128d enter = _mm_max_pd(zero, _mm_max_pd(_mm_min_pd(ax, bx),
+				_mm_min_pd(ay, by)));
+		__m128d exit = _mm_min_pd(one, _mm_min_pd(_mm_max_pd(ax, bx),
+				_mm_max_pd(ay, by)));
+		int mask = _mm_movemask_pd(_mm_cmple_pd(enter, exit));
+
+		inside[i] = mask & 1;
+		inside[i + 1] = (mask >> 1) & 1;
+		__m128d back = _mm_sub_pd(exit, one);
+		px = _mm_add_pd(px, _mm_mul_pd(enter, dx));
+		py = _mm_add_pd(py, _mm_mul_pd(enter, dy));
+		qx = _mm_add_pd(qx, _mm_mul_pd(back, dx));
+		qy = _mm_add_pd(qy, _mm_mul_pd(back, dy));
+		_mm_storeu_pd(x0 + i, _mm_min_pd(_mm_max_pd(px, min_x), max_x));
+		_mm_storeu_pd(y0 + i, _mm_min_pd(_mm_max_pd(py, min_y), max_y));
+		_mm_storeu_pd(x1 + i, _mm_min_pd(_mm_max_pd(qx, min_x), max_x));
+		_mm_storeu_pd(y1 + i, _mm_min_pd(_mm_max_pd(qy, min_y), max_y));
+	}
+#endif
+	ClipSegmentsScalar(i, count, x0, y0, x1, y1, inside, rectangle);
+}
+
+ClippedDiagram::ClippedDiagram()
+{
+}
+
+void ClippedDiagram::Clip(const VoronoiDCEL& diagram, Span<const Point> sites,
+		const BoundingBox& rectangle)
+{
+	ClipEdges(diagram, rectangle);
+	BuildCells(diagram, sites, rectangle);
+}
+
+void ClippedDiagram::ClipEdges(const VoronoiDCEL& diagram,
+		const BoundingBox& rectangle)
+{
+	const std::vector<DiagramEdge>& edges = diagram.edges();
+	size_t count = edges.size();
+
+	/* Ends at infinity are pushed out of the rectangle as well. */
+	BoundingBox box(rectangle);
+	for (size_t i = 0; i < diagram.vertex_count(); i++)
+		box.Extend(diagram.point(i));
+
+	_x0.resize(count);
+	_y0.resize(count);
+	_x1.resize(count);
+	_y1.resize(count);
+	_inside.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		Point origin, destination;
+		EdgeEnds(diagram, edges[i], box, origin, destination);
+		_x0[i] = origin.x();
+		_y0[i] = origin.y();
+		_x1[i] = destination.x();
+		_y1[i] = destination.y();
+	}
+
+	if (count > 0)
+		ClipSegments(count, &_x0[0], &_y0[0], &_x1[0], &_y1[0], &_inside[0],
+				rectangle);
+
+	/* Pack what is left, keeping the order of the diagram. */
+	_edges.clear();
+	for (size_t i = 0; i < count; i++) {
+		if (!_inside[i])
+			continue;
+		size_t k = _edges.size();
+		_edges.push_back(i);
+		_x0[k] = _x0[i];
+		_y0[k] = _y0[i];
+		_x1[k] = _x1[i];
+		_y1[k] = _y1[i];
+	}
+	_x0.resize(_edges.size());
+	_y0.resize(_edges.size());
+	_x1.resize(_edges.size());
+	_y1.resize(_edges.size());
+}
+
+/**
+ * Index of the site nearest to |p|, which owns it.
+ */
+static size_t NearestSite(Span<const Point> sites, const Point& p)
+{
+	size_t nearest = 0;
+	double best = std::numeric_limits<double>::infinity();
+
+	for (size_t i = 0; i < sites.size(); i++) {
+		double dx = sites[i].x() - p.x(), dy = sites[i].y() - p.y();
+		if (dx * dx + dy * dy < best) {
+			best = dx * dx + dy * dy;
+			nearest = i;
+		}
+	}
+	return nearest;
+}
+
+/**
+ * Corner of a cell, with its angle around the middle of the cell.
+ */
+struct CellPoint {
+	double angle;
+	double x;
+	double y;
+
+	CellPoint() :
+		angle(0), x(0), y(0)
+	{
+
+	}
+
+	CellPoint(double x, double y) :
+		angle(0), x(x), y(y)
+	{
+
+	}
+
+	bool operator<(const CellPoint& other) const
+	{
+		return angle < other.angle;
+	}
+};
+
+/**
+ * Stand-in for atan2(dy, dx) in [0, 4): it grows with the angle, which is
+ * all a sort needs, and is far cheaper.
+ */
+static double PseudoAngle(double dx, double dy)
+{
+	double sum = std::fabs(dx) + std::fabs(dy);
+	double p = sum > 0 ? dy / sum : 0;
+
+	if (dx < 0)
+		return 2 - p;
+	return dy < 0 ? 4 + p : p;
+}
+
+void ClippedDiagram::BuildCells(const VoronoiDCEL& diagram,
+		Span<const Point> sites, const BoundingBox& rectangle)
+{
+	const std::vector<DiagramEdge>& edges = diagram.edges();
+	Point corners[4] = { Point(rectangle.min_x(), rectangle.min_y()),
+			Point(rectangle.max_x(), rectangle.min_y()),
+			Point(rectangle.max_x(), rectangle.max_y()),
+			Point(rectangle.min_x(), rectangle.max_y()) };
+	size_t owners[4];
+
+	/*
+	 * A cell inside the rectangle is bounded by its clipped edges and by
+	 * the corners of the rectangle it holds.  Gather both, per cell.
+	 */
+	_cell_offsets.assign(sites.size() + 1, 0);
+	for (size_t i = 0; i < _edges.size(); i++) {
+		_cell_offsets[edges[_edges[i]].left_site + 1] += 2;
+		_cell_offsets[edges[_edges[i]].right_site + 1] += 2;
+	}
+	for (size_t c = 0; c < 4 && !sites.empty(); c++) {
+		owners[c] = NearestSite(sites, corners[c]);
+		_cell_offsets[owners[c] + 1]++;
+	}
+	for (size_t i = 0; i < sites.size(); i++)
+		_cell_offsets[i + 1] += _cell_offsets[i];
+
+	std::vector<CellPoint> points(_cell_offsets[sites.size()]);
+	std::vector<uint32_t> next(_cell_offsets.begin(), _cell_offsets.end() - 1);
+	for (size_t i = 0; i < _edges.size(); i++) {
+		const DiagramEdge& edge = edges[_edges[i]];
+		int ends[2] = { edge.left_site, edge.right_site };
+		for (size_t e = 0; e < 2; e++) {
+			points[next[ends[e]]++] = CellPoint(_x0[i], _y0[i]);
+			points[next[ends[e]]++] = CellPoint(_x1[i], _y1[i]);
+		}
+	}
+	for (size_t c = 0; c < 4 && !sites.empty(); c++)
+		points[next[owners[c]]++] = CellPoint(corners[c].x(), corners[c].y());
+
+	/*
+	 * The cell is convex, so sorting its points by angle around their mean
+	 * walks the boundary.  Points shared by two edges are computed once and
+	 * compare equal.
+	 */
+	_cell_coordinates.clear();
+	for (size_t s = 0; s < sites.size(); s++) {
+		size_t begin = _cell_offsets[s], end = _cell_offsets[s + 1];
+		double mx = 0, my = 0;
+
+		_cell_offsets[s] = _cell_coordinates.size() / 2;
+		for (size_t i = begin; i < end; i++) {
+			mx += points[i].x;
+			my += points[i].y;
+		}
+		mx /= std::max<size_t>(end - begin, 1);
+		my /= std::max<size_t>(end - begin, 1);
+		for (size_t i = begin; i < end; i++)
+			points[i].angle = PseudoAngle(points[i].x - mx, points[i].y - my);
+		std::sort(points.begin() + begin, points.begin() + end);
+
+		size_t first = _cell_coordinates.size();
+		for (size_t i = begin; i < end; i++) {
+			const CellPoint& p = points[i];
+			size_t last = _cell_coordinates.size();
+			if (last > first && _cell_coordinates[last - 2] == p.x
+					&& _cell_coordinates[last - 1] == p.y)
+				continue;
+			if (last > first + 2 && _cell_coordinates[first] == p.x
+					&& _cell_coordinates[first + 1] == p.y)
+				continue;
+			_cell_coordinates.push_back(p.x);
+			_cell_coordinates.push_back(p.y);
+		}
+		/* Touching the rectangle at a point or along a side is no cell. */
+		if (_cell_coordinates.size() - first < 6)
+			_cell_coordinates.resize(first);
+	}
+	_cell_offsets[sites.size()] = _cell_coordinates.size() / 2;
+}
+
+const std::vector<uint32_t>& ClippedDiagram::edges() const
+{
+	return _edges;
+}
+
+Point ClippedDiagram::origin(size_t i) const
+{
+	return Point(_x0[i], _y0[i]);
+}
+
+Point ClippedDiagram::destination(size_t i) const
+{
+	return Point(_x1[i], _y1[i]);
+}
+
+size_t ClippedDiagram::cell_count() const
+{
+	return _cell_offsets.empty() ? 0 : _cell_offsets.size() - 1;
+}
+
+const std::vector<double>& ClippedDiagram::cell_coordinates() const
+{
+	return _cell_coordinates;
+}
+
+const std::vector<uint32_t>& ClippedDiagram::cell_offsets() const
+{
+	return _cell_offsets;
+}
+
+std::vector<Point> ClippedDiagram::Cell(size_t cell) const
+{
+	std::vector<Point> corners;
+
+	for (size_t i = _cell_offsets[cell]; i < _cell_offsets[cell + 1]; i++)
+		corners.push_back(Point(_cell_coordinates[2 * i],
+				_cell_coordinates[2 * i + 1]));
+	return corners;
+}
+
+double ClippedDiagram::CellArea(size_t cell) const
+{
+	size_t begin = _cell_offsets[cell], end = _cell_offsets[cell + 1];
+	double area = 0;
+
+	for (size_t i = begin; i < end; i++) {
+		size_t j = i + 1 < end ? i + 1 : begin;
+		area += _cell_coordinates[2 * i] * _cell_coordinates[2 * j + 1]
+				- _cell_coordinates[2 * j] * _cell_coordinates[2 * i + 1];
+	}
+	return area / 2;
+}
+
+}
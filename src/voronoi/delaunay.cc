@@ -0,0 +1,152 @@
+/**
+ *  @file
+ *  @brief 
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#include <algorithm>
+#include <vector>
+#include <voronoi/delaunay.hh>
+
+namespace voronoi {
+
+/**
+ * Side |side| % 3 of triangle |side| / 3, keyed by its sites in increasing
+ * order so that a side and its twin sort next to each other.
+ */
+struct TriangleSide {
+	int low;
+	int high;
+	size_t side;
+
+	bool operator<(const TriangleSide& other) const
+	{
+		if (low != other.low)
+			return low < other.low;
+		if (high != other.high)
+			return high < other.high;
+		return side < other.side;
+	}
+};
+
+/**
+ * Sites of |triangle| in counterclockwise order.
+ */
+static void Corners(const VertexSites& triangle, int corners[3])
+{
+	corners[0] = triangle.right;
+	corners[1] = triangle.middle;
+	corners[2] = triangle.left;
+}
+
+void BuildDelaunay(const VoronoiDCEL& diagram, Span<const Point> sites,
+		DelaunayDCEL& out)
+{
+	typedef DelaunayDCEL::HalfEdge HalfEdge;
+	const std::vector<VertexSites>& triangles = diagram.vertex_sites();
+	std::vector<TriangleSide> sides(triangles.size() * 3);
+	std::vector<size_t> bucket(sites.size() + 1, 0);
+	int corners[3];
+
+	/* Bucket the sides by their lower site; each bucket is a handful. */
+	for (size_t t = 0; t < triangles.size(); t++) {
+		Corners(triangles[t], corners);
+		for (size_t k = 0; k < 3; k++)
+			bucket[std::min(corners[k], corners[(k + 1) % 3]) + 1]++;
+	}
+	for (size_t i = 0; i < sites.size(); i++)
+		bucket[i + 1] += bucket[i];
+	std::vector<size_t> next(bucket.begin(), bucket.end() - 1);
+	for (size_t t = 0; t < triangles.size(); t++) {
+		Corners(triangles[t], corners);
+		for (size_t k = 0; k < 3; k++) {
+			int low = std::min(corners[k], corners[(k + 1) % 3]);
+			TriangleSide& side = sides[next[low]++];
+			side.low = low;
+			side.high = std::max(corners[k], corners[(k + 1) % 3]);
+			side.side = t * 3 + k;
+		}
+	}
+	for (size_t i = 0; i < sites.size(); i++)
+		std::sort(sides.begin() + bucket[i], sides.begin() + bucket[i + 1]);
+	size_t edges = 0;
+	for (size_t i = 0; i < sides.size(); i++)
+		if (i == 0 || sides[i].low != sides[i - 1].low
+				|| sides[i].high != sides[i - 1].high)
+			edges++;
+
+	/* Half-edges are linked by pointer, so they must never move. */
+	out.clear();
+	out.getVertices().reserve(sites.size());
+	out.getHalfEdges().reserve(edges * 2);
+	out.getFaces().reserve(triangles.size());
+	for (size_t i = 0; i < sites.size(); i++)
+		out.createGetVertex()->getData() = sites[i];
+	for (size_t t = 0; t < triangles.size(); t++)
+		out.createGetFace(NULL)->getData().set_id(t);
+
+	std::vector<unsigned int> half(sides.size());
+	for (size_t i = 0; i < sides.size();) {
+		size_t twin = i + 1;
+		size_t a = sides[i].side;
+
+		Corners(triangles[a / 3], corners);
+		DelaunayDCEL::Vertex* origin = out.getVertex(corners[a % 3]);
+		DelaunayDCEL::Vertex* destination = out.getVertex(
+				corners[(a % 3 + 1) % 3]);
+		if (twin < sides.size() && sides[twin].low == sides[i].low
+				&& sides[twin].high == sides[i].high) {
+			size_t b = sides[twin].side;
+			Corners(triangles[b / 3], corners);
+			if (twin + 1 < sides.size() && sides[twin + 1].low == sides[i].low
+					&& sides[twin + 1].high == sides[i].high)
+				throw dcel::Exception("Side shared by three triangles.");
+			if (out.getVertex(corners[b % 3]) != destination)
+				throw dcel::Exception("Twin triangles with the same winding.");
+			half[a] = out.createEdge(origin, out.getFace(a / 3), destination,
+					out.getFace(b / 3));
+			half[b] = half[a] + 1;
+			i = twin + 1;
+		} else {
+			/* On the hull: the twin runs along the outside. */
+			half[a] = out.createEdge(origin, out.getFace(a / 3), destination,
+					NULL);
+			i = twin;
+		}
+	}
+
+	for (size_t t = 0; t < triangles.size(); t++) {
+		for (size_t k = 0; k < 3; k++) {
+			HalfEdge* edge = out.getHalfEdge(half[t * 3 + k]);
+			edge->setNext(out.getHalfEdge(half[t * 3 + (k + 1) % 3]));
+			edge->getOrigin()->setIncidentEdge(edge);
+		}
+		out.getFace(t)->setBoundary(out.getHalfEdge(half[t * 3]));
+	}
+
+	/* Hull vertices start at their outside half-edge, which links the hull. */
+	std::vector<HalfEdge*> outside(sites.size(), NULL);
+	std::vector<HalfEdge>& halves = out.getHalfEdges();
+	const DelaunayDCEL::Vertex* first = sites.size() ? out.getVertex(0) : NULL;
+	for (size_t i = 0; i < halves.size(); i++) {
+		if (halves[i].getFace() != NULL)
+			continue;
+		DelaunayDCEL::Vertex* origin = halves[i].getOrigin();
+		if (outside[origin - first] != NULL)
+			throw dcel::Exception("Hull passes twice through a site.");
+		outside[origin - first] = &halves[i];
+		origin->setIncidentEdge(&halves[i]);
+	}
+	for (size_t i = 0; i < halves.size(); i++) {
+		if (halves[i].getFace() != NULL)
+			continue;
+		HalfEdge* next = outside[halves[i].getTwin()->getOrigin() - first];
+		if (next == NULL)
+			throw dcel::Exception("Hull ends at a site.");
+		halves[i].setNext(next);
+	}
+}
+
+}
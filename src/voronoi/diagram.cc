@@ -1,42 +1,178 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <voronoi/diagram.hh>
 #include <voronoi/point.hh>
 #include <voronoi/face.hh>
 
-#include <iostream>
 namespace voronoi {
 
-VoronoiDCEL::VoronoiDCEL()
+template <class Coordinate>
+BasicVoronoiDCEL<Coordinate>::BasicVoronoiDCEL()
 {
 }
 
-VoronoiDCEL::~VoronoiDCEL()
+template <class Coordinate>
+BasicVoronoiDCEL<Coordinate>::BasicVoronoiDCEL(BasicVoronoiDCEL&& other) =
+		default;
+
+template <class Coordinate>
+BasicVoronoiDCEL<Coordinate>::~BasicVoronoiDCEL()
 {
-	while (!_edges.empty()) {
-		delete _edges.front();
-		_edges.pop_front();
+}
+
+template <class Coordinate>
+BasicVoronoiDCEL<Coordinate>& BasicVoronoiDCEL<Coordinate>::operator=(
+		BasicVoronoiDCEL&& other) = default;
+
+template <class Coordinate>
+void BasicVoronoiDCEL<Coordinate>::Clear()
+{
+	_edges.clear();
+	_coordinates.clear();
+	_vertex_sites.clear();
+}
+
+template <class Coordinate>
+void BasicVoronoiDCEL<Coordinate>::reserve(size_t sites)
+{
+	_edges.reserve(3 * sites);
+	_coordinates.reserve(2 * 3 * sites);
+	_vertex_sites.reserve(2 * sites);
+}
+
+template class BasicVoronoiDCEL<double>;
+template class BasicVoronoiDCEL<float>;
+
+/* Edge of one diagram in a form that does not depend on the sweep order. */
+struct EdgeKey {
+	int low_site;
+	int high_site;
+	double x[2];
+	double y[2];
+
+	bool operator <(const EdgeKey& b) const
+	{
+		if (low_site != b.low_site)
+			return low_site < b.low_site;
+		return high_site < b.high_site;
+	}
+};
+
+struct VertexKey {
+	int sites[3];
+	double x;
+	double y;
+
+	bool operator <(const VertexKey& b) const
+	{
+		return std::lexicographical_compare(sites, sites + 3, b.sites,
+				b.sites + 3);
 	}
+};
+
+static bool Near(double a, double b, double tolerance)
+{
+	double scale = std::max(1.0, std::max(std::fabs(a), std::fabs(b)));
+
+	return std::fabs(a - b) <= tolerance * scale;
 }
 
-void VoronoiDCEL::addEdge(const Point* origin, const Point* destination)
+static void EdgeKeys(const VoronoiDCEL& diagram, double tolerance,
+		std::vector<EdgeKey>& keys)
 {
-	std::cerr << "push back "<< origin->str() << ", " << destination->str() << std::endl;
-	_edges.push_back(new DiagramEdge(new Point(*origin), new Point(*destination)));
+	for (size_t i = 0; i < diagram.edges().size(); i++) {
+		const DiagramEdge& e = diagram.edges()[i];
+		Point origin = diagram.point(e.origin);
+		Point destination = diagram.point(e.destination);
+		if (std::hypot(destination.x() - origin.x(),
+				destination.y() - origin.y()) <= tolerance)
+			continue;
+		/* Walk every edge with the lower site on its left. */
+		bool flip = e.left_site > e.right_site;
+		const Point& from = flip ? destination : origin;
+		const Point& to = flip ? origin : destination;
+		EdgeKey key = { std::min(e.left_site, e.right_site),
+				std::max(e.left_site, e.right_site),
+				{ from.x(), to.x() }, { from.y(), to.y() } };
+		keys.push_back(key);
+	}
+	std::sort(keys.begin(), keys.end());
 }
 
-void VoronoiDCEL::addVertex(const Point* point)
+static void VertexKeys(const VoronoiDCEL& diagram, std::vector<VertexKey>& keys)
 {
-	_vertices.push_back(new Point(*point));
+	for (size_t i = 0; i < diagram.vertex_count(); i++) {
+		const VertexSites& s = diagram.vertex_sites()[i];
+		int sites[3] = { s.left, s.middle, s.right };
+		/* Rotate the smallest id first, keeping the turn. */
+		int first = std::min_element(sites, sites + 3) - sites;
+		VertexKey key = { { sites[first], sites[(first + 1) % 3],
+				sites[(first + 2) % 3] }, diagram.coordinates()[2 * i],
+				diagram.coordinates()[2 * i + 1] };
+		keys.push_back(key);
+	}
+	std::sort(keys.begin(), keys.end());
 }
 
-const std::list<const DiagramEdge*>& VoronoiDCEL::edges() const
+bool EquivalentDiagrams(const VoronoiDCEL& a, const VoronoiDCEL& b,
+		double tolerance)
 {
-	return _edges;
+	std::vector<EdgeKey> edges_a, edges_b;
+	std::vector<VertexKey> vertices_a, vertices_b;
+
+	EdgeKeys(a, tolerance, edges_a);
+	EdgeKeys(b, tolerance, edges_b);
+	if (edges_a.size() != edges_b.size())
+		return false;
+	for (size_t i = 0; i < edges_a.size(); i++) {
+		const EdgeKey& ea = edges_a[i];
+		const EdgeKey& eb = edges_b[i];
+		if (ea.low_site != eb.low_site || ea.high_site != eb.high_site)
+			return false;
+		for (int j = 0; j < 2; j++)
+			if (!Near(ea.x[j], eb.x[j], tolerance)
+					|| !Near(ea.y[j], eb.y[j], tolerance))
+				return false;
+	}
+
+	VertexKeys(a, vertices_a);
+	VertexKeys(b, vertices_b);
+	if (vertices_a.size() != vertices_b.size())
+		return false;
+	for (size_t i = 0; i < vertices_a.size(); i++) {
+		const VertexKey& va = vertices_a[i];
+		const VertexKey& vb = vertices_b[i];
+		if (!std::equal(va.sites, va.sites + 3, vb.sites)
+				|| !Near(va.x, vb.x, tolerance)
+				|| !Near(va.y, vb.y, tolerance))
+			return false;
+	}
+	return true;
 }
 
-const std::list<const Point*>& VoronoiDCEL::vertices() const
+void EdgeEnds(const VoronoiDCEL& diagram, const DiagramEdge& edge,
+		const BoundingBox& box, Point& origin, Point& destination)
 {
-	return _vertices;
+	Point o = diagram.point(edge.origin);
+	Point d = diagram.point(edge.destination);
+	double dx = d.x() - o.x(), dy = d.y() - o.y();
+
+	if (edge.origin_at_infinity && edge.destination_at_infinity) {
+		Point middle((o.x() + d.x()) / 2, (o.y() + d.y()) / 2);
+		origin = box.FarPoint(middle, -dx, -dy);
+		destination = box.FarPoint(middle, dx, dy);
+	} else if (edge.origin_at_infinity) {
+		origin = box.FarPoint(d, -dx, -dy);
+		destination = d;
+	} else if (edge.destination_at_infinity) {
+		origin = o;
+		destination = box.FarPoint(o, dx, dy);
+	} else {
+		origin = o;
+		destination = d;
+	}
 }
 
 }
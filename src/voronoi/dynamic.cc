@@ -0,0 +1,500 @@
+/**
+ *  @file
+ *  @brief 
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <voronoi/dynamic.hh>
+#include <voronoi/engine.hh>
+#include <voronoi/predicates.hh>
+
+namespace voronoi {
+
+const int DynamicDiagram::kNoSite;
+const int DynamicDiagram::kInfinity;
+const uint32_t DynamicDiagram::kNoTriangle;
+
+DynamicDiagram::DynamicDiagram() :
+		_finite(0), _hint(kNoTriangle), _mark(0)
+{
+}
+
+/**
+ * Side of a triangle, keyed by its sites in increasing order so that a
+ * side and its twin sort next to each other.
+ */
+struct SharedSide {
+	int low;
+	int high;
+	uint32_t triangle;
+
+	bool operator<(const SharedSide& other) const
+	{
+		if (low != other.low)
+			return low < other.low;
+		return high < other.high;
+	}
+};
+
+bool DynamicDiagram::Build(Span<const Point> sites)
+{
+	Engine engine;
+	const VoronoiDCEL& diagram = engine.compute(sites);
+	const std::vector<VertexSites>& vertices = diagram.vertex_sites();
+
+	_sites.assign(sites.data(), sites.data() + sites.size());
+	_site_triangle.assign(sites.size(), kNoTriangle);
+	_triangles.clear();
+	_free.clear();
+	_finite = 0;
+	_hint = kNoTriangle;
+	_changed.clear();
+	if (vertices.empty()) {
+		_sites.clear();
+		_site_triangle.clear();
+		return false;
+	}
+
+	/* Every vertex names its sites clockwise: turn them around. */
+	std::vector<SharedSide> sides;
+	sides.reserve(vertices.size() * 3);
+	for (size_t i = 0; i < vertices.size(); i++) {
+		const VertexSites& s = vertices[i];
+		uint32_t t = CreateTriangle(s.right, s.middle, s.left);
+		_triangles[t].center = diagram.point(i);
+		for (int k = 0; k < 3; k++) {
+			int a = _triangles[t].v[(k + 1) % 3];
+			int b = _triangles[t].v[(k + 2) % 3];
+			SharedSide side = { std::min(a, b), std::max(a, b), t };
+			sides.push_back(side);
+		}
+	}
+	std::sort(sides.begin(), sides.end());
+
+	/* Sides without a twin are on the hull and get a triangle outside. */
+	std::vector<uint32_t> outside(sites.size(), kNoTriangle);
+	for (size_t i = 0; i < sides.size();) {
+		size_t twin = i + 1;
+		if (twin < sides.size() && sides[twin].low == sides[i].low
+				&& sides[twin].high == sides[i].high) {
+			Glue(sides[i].triangle, sides[twin].triangle);
+			i = twin + 1;
+			continue;
+		}
+		const Triangle& inside = _triangles[sides[i].triangle];
+		int k = 0;
+		while (inside.v[k] == sides[i].low || inside.v[k] == sides[i].high)
+			k++;
+		int a = inside.v[(k + 1) % 3], b = inside.v[(k + 2) % 3];
+		uint32_t ghost = CreateTriangle(b, a, kInfinity);
+		Glue(sides[i].triangle, ghost);
+		outside[b] = ghost;
+		i = twin;
+	}
+	for (size_t i = 0; i < outside.size(); i++)
+		if (outside[i] != kNoTriangle)
+			Glue(outside[i], outside[_triangles[outside[i]].v[1]]);
+	_hint = 0;
+	return true;
+}
+
+int DynamicDiagram::InsertSite(const Point& site)
+{
+	_changed.clear();
+	if (_hint == kNoTriangle)
+		return kNoSite;
+
+	uint32_t start = Locate(site);
+	const Triangle& found = _triangles[start];
+	for (int k = 0; k < 3; k++)
+		if (found.v[k] != kInfinity && _sites[found.v[k]] == site)
+			return kNoSite;
+
+	int id = _sites.size();
+	_sites.push_back(site);
+	_site_triangle.push_back(kNoTriangle);
+
+	/* Every triangle whose circle holds the site goes. */
+	_mark++;
+	_region.clear();
+	_sides.clear();
+	_stack.assign(1, start);
+	_triangles[start].mark = _mark;
+	while (!_stack.empty()) {
+		uint32_t t = _stack.back();
+		_stack.pop_back();
+		_region.push_back(t);
+		for (int k = 0; k < 3; k++) {
+			uint32_t u = _triangles[t].n[k];
+			if (_triangles[u].mark == _mark)
+				continue;
+			if (Conflicts(u, site)) {
+				_triangles[u].mark = _mark;
+				_stack.push_back(u);
+			} else {
+				Side side = { _triangles[t].v[(k + 1) % 3],
+						_triangles[t].v[(k + 2) % 3], u };
+				_sides.push_back(side);
+			}
+		}
+	}
+	for (size_t i = 0; i < _region.size(); i++)
+		DestroyTriangle(_region[i]);
+
+	/* The region is a star around the site: fan it out from there. */
+	Touch(id);
+	_region.clear();
+	for (size_t i = 0; i < _sides.size(); i++) {
+		uint32_t t = CreateTriangle(id, _sides[i].a, _sides[i].b);
+		Glue(t, _sides[i].outside);
+		_region.push_back(t);
+		if (_sides[i].a != kInfinity)
+			Touch(_sides[i].a);
+	}
+	for (size_t i = 0; i < _sides.size(); i++)
+		for (size_t j = 0; j < _sides.size(); j++)
+			if (_sides[j].a == _sides[i].b) {
+				Glue(_region[i], _region[j]);
+				break;
+			}
+	return id;
+}
+
+bool DynamicDiagram::RemoveSite(int id)
+{
+	_changed.clear();
+	if (!has_site(id))
+		return false;
+
+	/* Walk around the site, collecting the rim of its triangles. */
+	_region.clear();
+	_sides.clear();
+	uint32_t t = _site_triangle[id];
+	size_t finite = 0;
+	do {
+		const Triangle& triangle = _triangles[t];
+		int k = triangle.v[0] == id ? 0 : triangle.v[1] == id ? 1 : 2;
+		Side side = { triangle.v[(k + 1) % 3], triangle.v[(k + 2) % 3],
+				triangle.n[k] };
+		_sides.push_back(side);
+		_region.push_back(t);
+		if (!isGhost(t))
+			finite++;
+		t = triangle.n[(k + 1) % 3];
+	} while (t != _site_triangle[id]);
+
+	/* Without other triangles, the rim is every site left. */
+	if (finite == _finite) {
+		int first = kInfinity, second = kInfinity;
+		bool flat = true;
+		for (size_t i = 0; i < _sides.size() && flat; i++) {
+			int s = _sides[i].a;
+			if (s == kInfinity)
+				continue;
+			if (first == kInfinity)
+				first = s;
+			else if (second == kInfinity)
+				second = s;
+			else
+				flat = Orientation(_sites[first], _sites[second],
+						_sites[s]) == 0;
+		}
+		if (flat)
+			return false;
+	}
+
+	for (size_t i = 0; i < _region.size(); i++)
+		DestroyTriangle(_region[i]);
+	_site_triangle[id] = kNoTriangle;
+	for (size_t i = 0; i < _sides.size(); i++)
+		if (_sides[i].a != kInfinity)
+			Touch(_sides[i].a);
+
+	_stack.clear();
+	for (size_t i = 0; i < _sides.size(); i++)
+		_stack.push_back(_sides[i].outside);
+
+	/* Cut ears off the hole until it is a triangle itself. */
+	while (_sides.size() > 3) {
+		size_t i = 0;
+		while (!ValidEar(_sides, i))
+			i++;
+		assert(i < _sides.size());
+		size_t before = (i + _sides.size() - 1) % _sides.size();
+		uint32_t ear = CreateTriangle(_sides[before].a, _sides[i].a,
+				_sides[i].b);
+		Glue(ear, _sides[before].outside);
+		Glue(ear, _sides[i].outside);
+		_sides[before].b = _sides[i].b;
+		_sides[before].outside = ear;
+		_sides.erase(_sides.begin() + i);
+	}
+	uint32_t last = CreateTriangle(_sides[0].a, _sides[1].a, _sides[2].a);
+	for (size_t i = 0; i < 3; i++)
+		Glue(last, _sides[i].outside);
+
+	/* A hull corner may leave only triangles outside: walk from the rim. */
+	for (size_t i = 0; i < _stack.size() && isGhost(_hint); i++)
+		_hint = _stack[i];
+	return true;
+}
+
+void DynamicDiagram::Export(VoronoiDCEL& out) const
+{
+	std::vector<uint32_t> vertex(_triangles.size(), kNoTriangle);
+	BoundingBox bounds;
+
+	out.Clear();
+	for (size_t i = 0; i < _sites.size(); i++)
+		if (has_site(i))
+			bounds.Extend(_sites[i]);
+	for (size_t t = 0; t < _triangles.size(); t++) {
+		const Triangle& triangle = _triangles[t];
+		if (triangle.v[0] == kInfinity || isGhost(t))
+			continue;
+		vertex[t] = out.addVertex(triangle.center.x(), triangle.center.y(),
+				VertexSites(triangle.v[2], triangle.v[1], triangle.v[0]));
+		bounds.Extend(triangle.center);
+	}
+
+	/*
+	 * Each side a to b of a triangle is crossed by an edge with b on its
+	 * left, going out of the triangle.  Sides on the hull give rays, set
+	 * up the way the sweep sets them.
+	 */
+	for (size_t t = 0; t < _triangles.size(); t++) {
+		if (vertex[t] == kNoTriangle)
+			continue;
+		const Triangle& triangle = _triangles[t];
+		for (int k = 0; k < 3; k++) {
+			uint32_t u = triangle.n[k];
+			int a = triangle.v[(k + 1) % 3], b = triangle.v[(k + 2) % 3];
+			if (vertex[u] != kNoTriangle) {
+				if (t < u)
+					out.addEdge(DiagramEdge(vertex[t], vertex[u], b, a, false,
+							false));
+				continue;
+			}
+			double dx = _sites[b].y() - _sites[a].y();
+			double dy = _sites[a].x() - _sites[b].x();
+			Point end = bounds.FarPoint(triangle.center, dx, dy);
+			out.addEdge(DiagramEdge(vertex[t], out.addFarPoint(end.x(),
+					end.y()), b, a, false, true));
+		}
+	}
+}
+
+size_t DynamicDiagram::site_count() const
+{
+	return _sites.size();
+}
+
+bool DynamicDiagram::has_site(int id) const
+{
+	return id >= 0 && (size_t) id < _sites.size()
+			&& _site_triangle[id] != kNoTriangle;
+}
+
+const Point& DynamicDiagram::site(int id) const
+{
+	return _sites[id];
+}
+
+const std::vector<int>& DynamicDiagram::changed_sites() const
+{
+	return _changed;
+}
+
+bool DynamicDiagram::isGhost(uint32_t t) const
+{
+	return _triangles[t].v[2] == kInfinity;
+}
+
+/**
+ * New triangle a, b, c, turned so that a vertex at infinity comes last.
+ * Its neighbors are left for Glue().
+ */
+uint32_t DynamicDiagram::CreateTriangle(int a, int b, int c)
+{
+	uint32_t t;
+
+	if (a == kInfinity) {
+		a = b;
+		b = c;
+		c = kInfinity;
+	} else if (b == kInfinity) {
+		b = a;
+		a = c;
+		c = kInfinity;
+	}
+	if (_free.empty()) {
+		t = _triangles.size();
+		_triangles.push_back(Triangle());
+	} else {
+		t = _free.back();
+		_free.pop_back();
+	}
+
+	Triangle& triangle = _triangles[t];
+	triangle.v[0] = a;
+	triangle.v[1] = b;
+	triangle.v[2] = c;
+	triangle.n[0] = triangle.n[1] = triangle.n[2] = kNoTriangle;
+	triangle.mark = 0;
+	if (c != kInfinity) {
+		triangle.center.SetCoordinatesToTheCircleCenter(&_sites[a],
+				&_sites[b], &_sites[c]);
+		_finite++;
+		_hint = t;
+	}
+	for (int k = 0; k < 3; k++)
+		if (triangle.v[k] != kInfinity)
+			_site_triangle[triangle.v[k]] = t;
+	return t;
+}
+
+void DynamicDiagram::DestroyTriangle(uint32_t t)
+{
+	if (!isGhost(t))
+		_finite--;
+	_triangles[t].v[0] = _triangles[t].v[1] = _triangles[t].v[2] =
+			kInfinity;
+	_free.push_back(t);
+}
+
+/**
+ * Link |t| and |u|, which share a side.
+ */
+void DynamicDiagram::Glue(uint32_t t, uint32_t u)
+{
+	Triangle& a = _triangles[t];
+	Triangle& b = _triangles[u];
+	int i = 0, j = 0;
+
+	while (a.v[i] == b.v[0] || a.v[i] == b.v[1] || a.v[i] == b.v[2])
+		i++;
+	while (b.v[j] == a.v[0] || b.v[j] == a.v[1] || b.v[j] == a.v[2])
+		j++;
+	assert(i < 3 && j < 3);
+	a.n[i] = u;
+	b.n[j] = t;
+}
+
+static double Distance2(const Point& a, const Point& b)
+{
+	double dx = a.x() - b.x(), dy = a.y() - b.y();
+
+	return dx * dx + dy * dy;
+}
+
+/**
+ * Triangle that holds |p|, or one outside the hull that sees it.  The walk
+ * steps across any side with |p| beyond it, which ends on a Delaunay
+ * triangulation.
+ */
+uint32_t DynamicDiagram::Locate(const Point& p) const
+{
+	uint32_t t = _hint;
+
+	/*
+	 * Start next to the nearest of about n^(1/3) sites spread over the
+	 * ids, or the last change, which leaves a walk of about n^(1/3) steps.
+	 */
+	const Point& last = _sites[_triangles[t].v[0]];
+	double best = Distance2(last, p);
+	size_t samples = std::cbrt((double) _sites.size());
+	for (size_t i = 0; i < samples; i++) {
+		size_t id = i * _sites.size() / samples;
+		if (!has_site(id) || Distance2(_sites[id], p) >= best)
+			continue;
+		best = Distance2(_sites[id], p);
+		t = _site_triangle[id];
+	}
+	if (isGhost(t))
+		t = _triangles[t].n[2];
+
+	for (;;) {
+		const Triangle& triangle = _triangles[t];
+		int k = 0;
+		for (; k < 3; k++) {
+			const Point& a = _sites[triangle.v[(k + 1) % 3]];
+			const Point& b = _sites[triangle.v[(k + 2) % 3]];
+			if (Orientation(a, b, p) < 0)
+				break;
+		}
+		if (k == 3)
+			return t;
+		t = triangle.n[k];
+		if (isGhost(t))
+			return t;
+	}
+}
+
+/**
+ * Whether the circle of |t| holds |p|.  For a triangle outside the hull,
+ * the circle is the half-plane beyond its side, with the side itself.
+ */
+bool DynamicDiagram::Conflicts(uint32_t t, const Point& p) const
+{
+	const Triangle& triangle = _triangles[t];
+
+	if (isGhost(t))
+		return OutsideSide(triangle.v[0], triangle.v[1], p);
+	return InCircle(_sites[triangle.v[0]], _sites[triangle.v[1]],
+			_sites[triangle.v[2]], p) > 0;
+}
+
+/**
+ * Whether |p| is left of the hull side from |a| to |b|, where the outside
+ * is, or strictly between its ends.
+ */
+bool DynamicDiagram::OutsideSide(int a, int b, const Point& p) const
+{
+	const Point& pa = _sites[a];
+	const Point& pb = _sites[b];
+	double turn = Orientation(pa, pb, p);
+
+	if (turn != 0)
+		return turn > 0;
+	return (p.x() - pa.x()) * (pb.x() - pa.x())
+			+ (p.y() - pa.y()) * (pb.y() - pa.y()) > 0
+			&& (p.x() - pb.x()) * (pa.x() - pb.x())
+					+ (p.y() - pb.y()) * (pa.y() - pb.y()) > 0;
+}
+
+/**
+ * Whether the corner at side |i| of |hole|, with the sides before and at
+ * |i|, is a triangle of the new triangulation: it turns the right way and
+ * its circle holds none of the other corners.
+ */
+bool DynamicDiagram::ValidEar(const std::vector<Side>& hole, size_t i) const
+{
+	size_t before = (i + hole.size() - 1) % hole.size();
+	int a = hole[before].a, b = hole[i].a, c = hole[i].b;
+
+	for (size_t j = 0; j < hole.size(); j++) {
+		int x = hole[j].a;
+		if (x == a || x == b || x == c || x == kInfinity)
+			continue;
+		if (b == kInfinity ? OutsideSide(c, a, _sites[x])
+				: a == kInfinity ? OutsideSide(b, c, _sites[x])
+				: c == kInfinity ? OutsideSide(a, b, _sites[x])
+				: InCircle(_sites[a], _sites[b], _sites[c], _sites[x]) > 0)
+			return false;
+	}
+	if (a == kInfinity || b == kInfinity || c == kInfinity)
+		return true;
+	return Orientation(_sites[a], _sites[b], _sites[c]) > 0;
+}
+
+void DynamicDiagram::Touch(int site)
+{
+	_changed.push_back(site);
+}
+
+}
@@ -0,0 +1,146 @@
+/**
+ *  @file
+ *  @brief 
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#include <utility>
+#include <voronoi/engine.hh>
+#include <voronoi/flat.hh>
+#include <voronoi/status.hh>
+#include <voronoi/strips.hh>
+
+namespace voronoi {
+
+template <class Backend>
+BasicEngine<Backend>::BasicEngine() :
+		_tree(&_queue, &_dcel), _algorithm(kSequentialSweep), _strips(NULL),
+				_threads(0), _build_mesh(false)
+{
+}
+
+template <class Backend>
+BasicEngine<Backend>::~BasicEngine()
+{
+	delete _strips;
+}
+
+template <class Backend>
+const VoronoiDCEL& BasicEngine<Backend>::compute(Span<const Point> sites)
+{
+	reset();
+	if (_algorithm == kStripSweep && sites.size() >= kMinStripSites
+			&& !_build_mesh) {
+		if (_strips == NULL)
+			_strips = new StripEngine(_threads);
+		_strips->Compute(sites, _dcel);
+		return _dcel;
+	}
+	_sites.assign(sites.begin(), sites.end());
+	_site_pointers.resize(_sites.size());
+	for (size_t i = 0; i < _sites.size(); i++)
+		_site_pointers[i] = &_sites[i];
+
+	_queue.Reset(_site_pointers);
+	_tree.set_sites(_sites.data());
+	if (_build_mesh)
+		_tree.PrepareMesh(_sites.size());
+	_tree.Sweep();
+	return _dcel;
+}
+
+template <class Backend>
+void BasicEngine<Backend>::reset()
+{
+	_sites.clear();
+	_site_pointers.clear();
+	_tree.Reset();
+	_dcel.Clear();
+	_mesh.clear();
+}
+
+template <class Backend>
+void BasicEngine<Backend>::reserve(size_t sites)
+{
+	_sites.reserve(sites);
+	_site_pointers.reserve(sites);
+	_dcel.reserve(sites);
+	/* The beach line holds at most 2n - 1 arcs and 2n - 2 breakpoints. */
+	_tree.ReserveNodes(4 * sites);
+}
+
+template <class Backend>
+void BasicEngine<Backend>::set_algorithm(SweepAlgorithm algorithm,
+		unsigned int threads)
+{
+	_algorithm = algorithm;
+	if (threads != _threads) {
+		delete _strips;
+		_strips = NULL;
+		_threads = threads;
+	}
+}
+
+template <class Backend>
+SweepAlgorithm BasicEngine<Backend>::algorithm() const
+{
+	return _algorithm;
+}
+
+template <class Backend>
+void BasicEngine<Backend>::set_build_mesh(bool build)
+{
+	_build_mesh = build;
+	_tree.set_mesh(build ? &_mesh : NULL);
+	if (!build)
+		_mesh.clear();
+}
+
+template <class Backend>
+bool BasicEngine<Backend>::build_mesh() const
+{
+	return _build_mesh;
+}
+
+template <class Backend>
+const HalfEdgeDiagram& BasicEngine<Backend>::mesh() const
+{
+	return _mesh;
+}
+
+template <class Backend>
+const VoronoiDCEL& BasicEngine<Backend>::diagram() const
+{
+	return _dcel;
+}
+
+template <class Backend>
+const QueueStats& BasicEngine<Backend>::stats() const
+{
+	return _queue.stats();
+}
+
+template <class Backend>
+VoronoiDCEL BasicEngine<Backend>::TakeDiagram()
+{
+	VoronoiDCEL taken(std::move(_dcel));
+	_dcel.Clear();
+	return taken;
+}
+
+template <class Backend>
+void BasicEngine<Backend>::Recycle(VoronoiDCEL&& diagram)
+{
+	diagram.Clear();
+	_dcel = std::move(diagram);
+}
+
+template <class Backend>
+const size_t BasicEngine<Backend>::kMinStripSites;
+
+template class BasicEngine<VoronoiTree>;
+template class BasicEngine<FlatBeachLine>;
+
+}
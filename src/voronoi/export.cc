@@ -0,0 +1,311 @@
+/**
+ *  @file
+ *  @brief SVG and GeoJSON files of a clipped diagram.
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <condition_variable>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <voronoi/export.hh>
+
+namespace voronoi {
+
+const size_t kExportChunk = 1 << 14;
+
+/* Formats items [begin, end) at the end of |out|. */
+typedef std::function<void(size_t begin, size_t end, std::string& out)>
+		ChunkFormatter;
+
+static void AppendNumber(std::string& out, double value)
+{
+	char digits[32];
+	out.append(digits, std::to_chars(digits, digits + sizeof(digits),
+			value).ptr);
+}
+
+static void AppendPair(std::string& out, double x, double y, char separator)
+{
+	AppendNumber(out, x);
+	out += separator;
+	AppendNumber(out, y);
+}
+
+/*
+ * Threads that format every chunk of a round but the first, which the
+ * caller formats meanwhile.  One set serves every WriteChunks() of an
+ * export.
+ */
+class ChunkWorkers {
+public:
+	explicit ChunkWorkers(unsigned int threads);
+	~ChunkWorkers();
+
+	unsigned int threads() const;
+
+	/*
+	 * Format chunk i of the round of |count| items that starts at |round|
+	 * into |buffers[i]|, for every chunk, and return once all are done.
+	 */
+	void Format(const ChunkFormatter& format, size_t count, size_t round,
+			std::vector<std::string>& buffers);
+
+private:
+	ChunkWorkers(const ChunkWorkers&);
+	ChunkWorkers& operator=(const ChunkWorkers&);
+
+	void Work(unsigned int chunk);
+
+	std::vector<std::thread> _workers;
+	std::mutex _mutex;
+	std::condition_variable _started;
+	std::condition_variable _finished;
+	const ChunkFormatter* _format;
+	size_t _count;
+	size_t _round;
+	std::vector<std::string>* _buffers;
+	size_t _generation; /**< Rounds started, so workers see new ones */
+	unsigned int _busy;
+	bool _stopping;
+};
+
+static void FormatChunk(const ChunkFormatter& format, size_t count,
+		size_t round, unsigned int chunk, std::string& buffer)
+{
+	size_t begin = std::min(count, round + chunk * kExportChunk);
+	size_t end = std::min(count, begin + kExportChunk);
+
+	buffer.clear();
+	if (begin < end)
+		format(begin, end, buffer);
+}
+
+ChunkWorkers::ChunkWorkers(unsigned int threads) :
+		_format(NULL), _count(0), _round(0), _buffers(NULL), _generation(0),
+		_busy(0), _stopping(false)
+{
+	for (unsigned int i = 1; i < threads; i++)
+		_workers.push_back(std::thread(&ChunkWorkers::Work, this, i));
+}
+
+ChunkWorkers::~ChunkWorkers()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_stopping = true;
+	_started.notify_all();
+	lock.unlock();
+	for (size_t i = 0; i < _workers.size(); i++)
+		_workers[i].join();
+}
+
+unsigned int ChunkWorkers::threads() const
+{
+	return _workers.size() + 1;
+}
+
+void ChunkWorkers::Format(const ChunkFormatter& format, size_t count,
+		size_t round, std::vector<std::string>& buffers)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_format = &format;
+	_count = count;
+	_round = round;
+	_buffers = &buffers;
+	_busy = _workers.size();
+	_generation++;
+	_started.notify_all();
+	lock.unlock();
+
+	/* The workers write to |buffers| until they are done, even if we throw. */
+	std::exception_ptr error;
+	try {
+		FormatChunk(format, count, round, 0, buffers[0]);
+	} catch (...) {
+		error = std::current_exception();
+	}
+	lock.lock();
+	_finished.wait(lock, [this]() { return _busy == 0; });
+	if (error)
+		std::rethrow_exception(error);
+}
+
+void ChunkWorkers::Work(unsigned int chunk)
+{
+	size_t seen = 0;
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	while (true) {
+		_started.wait(lock, [this, seen]() {
+			return _stopping || _generation != seen;
+		});
+		if (_stopping)
+			return;
+		seen = _generation;
+		lock.unlock();
+		FormatChunk(*_format, _count, _round, chunk, (*_buffers)[chunk]);
+		lock.lock();
+		if (--_busy == 0)
+			_finished.notify_one();
+	}
+}
+
+/*
+ * Format |count| items a round at a time, one chunk per thread, and write
+ * the buffers in order before the next round.  With |skip_first| the
+ * first character of the output is dropped: chunks that cannot know if
+ * anything came before them start with a separator.
+ */
+static bool WriteChunks(FILE* file, size_t count, ChunkWorkers& workers,
+		const ChunkFormatter& format, bool skip_first = false)
+{
+	unsigned int threads = workers.threads();
+	std::vector<std::string> buffers(threads);
+	bool written = true;
+
+	for (size_t round = 0; round < count; round += threads * kExportChunk) {
+		workers.Format(format, count, round, buffers);
+		for (unsigned int i = 0; i < threads; i++) {
+			size_t from = skip_first && !buffers[i].empty() ? 1 : 0;
+			size_t bytes = buffers[i].size() - from;
+			if (bytes > 0)
+				skip_first = false;
+			written = fwrite(buffers[i].data() + from, 1, bytes, file)
+					== bytes && written;
+		}
+	}
+	return written;
+}
+
+static unsigned int ThreadCount(unsigned int threads)
+{
+	if (threads == 0)
+		threads = std::thread::hardware_concurrency();
+	return std::max(1u, threads);
+}
+
+static bool Close(FILE* file, bool written)
+{
+	return fclose(file) == 0 && written;
+}
+
+static bool Put(FILE* file, const std::string& text)
+{
+	return fwrite(text.data(), 1, text.size(), file) == text.size();
+}
+
+static void FormatEdges(const ClippedDiagram* clipped, size_t begin,
+		size_t end, std::string& out)
+{
+	out += "<path d=\"";
+	for (size_t i = begin; i < end; i++) {
+		Point origin = clipped->origin(i);
+		Point destination = clipped->destination(i);
+		out += 'M';
+		AppendPair(out, origin.x(), -origin.y(), ' ');
+		out += 'L';
+		AppendPair(out, destination.x(), -destination.y(), ' ');
+	}
+	out += "\"/>\n";
+}
+
+/* Each site is a round dot: a path of length zero. */
+static void FormatSites(const Span<const Point>* sites, size_t begin,
+		size_t end, std::string& out)
+{
+	out += "<path d=\"";
+	for (size_t i = begin; i < end; i++) {
+		out += 'M';
+		AppendPair(out, (*sites)[i].x(), -(*sites)[i].y(), ' ');
+		out += "h0";
+	}
+	out += "\"/>\n";
+}
+
+static void FormatCells(const ClippedDiagram* clipped, size_t begin,
+		size_t end, std::string& out)
+{
+	const std::vector<double>& corners = clipped->cell_coordinates();
+	const std::vector<uint32_t>& offsets = clipped->cell_offsets();
+	char digits[32];
+
+	for (size_t cell = begin; cell < end; cell++) {
+		size_t first = offsets[cell];
+		size_t last = offsets[cell + 1];
+		if (first == last)
+			continue;
+		out += ",{\"type\":\"Feature\",\"properties\":{\"site\":";
+		out.append(digits, std::to_chars(digits, digits + sizeof(digits),
+				cell).ptr);
+		out += "},\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[[";
+		/* GeoJSON rings end where they start. */
+		for (size_t i = first; i <= last; i++) {
+			size_t corner = i < last ? i : first;
+			out += '[';
+			AppendPair(out, corners[2 * corner], corners[2 * corner + 1],
+					',');
+			out += i < last ? "]," : "]";
+		}
+		out += "]]}}\n";
+	}
+}
+
+bool WriteSvg(const char* path, const ClippedDiagram& clipped,
+		const BoundingBox& rectangle, Span<const Point> sites,
+		unsigned int threads)
+{
+	using namespace std::placeholders;
+	FILE* file = fopen(path, "wb");
+	std::string text;
+
+	if (file == NULL)
+		return false;
+	ChunkWorkers workers(ThreadCount(threads));
+
+	/* y is negated, so that it goes up. */
+	text = "<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"";
+	AppendPair(text, rectangle.min_x(), -rectangle.max_y(), ' ');
+	text += ' ';
+	AppendPair(text, rectangle.max_x() - rectangle.min_x(),
+			rectangle.max_y() - rectangle.min_y(), ' ');
+	text += "\">\n<g fill=\"none\" stroke=\"black\" stroke-width=\"1\" "
+			"vector-effect=\"non-scaling-stroke\">\n";
+	bool written = Put(file, text);
+	written = WriteChunks(file, clipped.edges().size(), workers,
+			std::bind(FormatEdges, &clipped, _1, _2, _3)) && written;
+	written = Put(file, "</g>\n<g stroke=\"red\" stroke-width=\"3\" "
+			"stroke-linecap=\"round\" vector-effect=\"non-scaling-stroke\">\n")
+			&& written;
+	written = WriteChunks(file, sites.size(), workers,
+			std::bind(FormatSites, &sites, _1, _2, _3)) && written;
+	written = Put(file, "</g>\n</svg>\n") && written;
+	return Close(file, written);
+}
+
+bool WriteGeoJson(const char* path, const ClippedDiagram& clipped,
+		unsigned int threads)
+{
+	using namespace std::placeholders;
+	FILE* file = fopen(path, "wb");
+
+	if (file == NULL)
+		return false;
+	ChunkWorkers workers(ThreadCount(threads));
+
+	bool written = Put(file,
+			"{\"type\":\"FeatureCollection\",\"features\":[\n");
+	written = WriteChunks(file, clipped.cell_count(), workers,
+			std::bind(FormatCells, &clipped, _1, _2, _3), true) && written;
+	written = Put(file, "]}\n") && written;
+	return Close(file, written);
+}
+
+}
@@ -0,0 +1,281 @@
+/**
+ *  @file
+ *  @brief 
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <new>
+#include <voronoi/flat.hh>
+#include <voronoi/predicates.hh>
+#include <voronoi/queue.hh>
+
+namespace voronoi {
+
+FlatBeachLine::FlatBeachLine(VoronoiQueue* queue, VoronoiDCEL* dcel) :
+		BeachLine(queue, dcel)
+{
+}
+
+void FlatBeachLine::InsertParabola(Point* parabola)
+{
+	if (!EnterSite(parabola))
+		return;
+	if (_arcs.empty()) {
+		Entry first = { parabola, CreateStatus(Status(parabola)), kNullNode };
+		_arcs.push_back(first);
+		return;
+	}
+	size_t k = Locate(parabola);
+	while (Overdue(parabola, k == 0 ? NULL : _arcs[k - 1].site,
+			status(_arcs[k].arc), k + 1 == _arcs.size() ? NULL
+			: _arcs[k + 1].site)) {
+		RemoveParabola(TakeCircleEvent(status(_arcs[k].arc)));
+		k = Locate(parabola);
+	}
+	Entry nearest = _arcs[k];
+
+	RemoveCircleEvent(status(nearest.arc));
+
+	/* Only a site of the first row is level with the arc above it. */
+	if (parabola->y() == nearest.site->y()) {
+		InsertBeside(k, parabola);
+		return;
+	}
+
+	/* The arc keeps its left part and gets a copy for the right one. */
+	NodeIndex left = CreateStatus(Status(nearest.site, parabola));
+	NodeIndex right = CreateStatus(Status(parabola, nearest.site));
+	Entry split[2] = { { parabola, CreateStatus(Status(parabola)), right },
+			{ nearest.site, CreateStatus(Status(nearest.site)),
+					nearest.right } };
+
+	_arcs[k].right = left;
+	_arcs.insert(_arcs.begin() + k + 1, split, split + 2);
+	SplitArc(parabola, nearest.site, status(left), status(right));
+
+	CheckCircle(k, parabola->y());
+	CheckCircle(k + 2, parabola->y());
+}
+
+/**
+ * Sites on the first row of the sweep have no arc above them to split.  They
+ * come left to right, so the new arc goes right of the one at |nearest|,
+ * the last one.
+ */
+void FlatBeachLine::InsertBeside(size_t nearest, Point* parabola)
+{
+	Point* arc = _arcs[nearest].site;
+	NodeIndex breakpoint = CreateStatus(Status(arc, parabola));
+	Entry added = { parabola, CreateStatus(Status(parabola)), kNullNode };
+
+	assert(nearest + 1 == _arcs.size() && arc->x() < parabola->x());
+	_arcs[nearest].right = breakpoint;
+	_arcs.push_back(added);
+	PlaceBeside(status(breakpoint));
+
+	CheckCircle(nearest, parabola->y());
+}
+
+void FlatBeachLine::CheckCircle(size_t position, double sweepline_y)
+{
+	if (position == 0 || position + 1 >= _arcs.size())
+		return;
+
+	const Entry& left = _arcs[position - 1];
+	const Entry& right = _arcs[position + 1];
+	if (*left.site == *right.site)
+		return;
+	BeachLine::CheckCircle(status(_arcs[position].arc), _arcs[position].arc,
+			left.site, right.site, sweepline_y);
+}
+
+void FlatBeachLine::RemoveParabola(const CircleEvent& taken)
+{
+	CircleEvent event = taken;
+	size_t k = Find(event);
+	size_t first = FirstTied(k, event);
+
+	if (first != k) {
+		event = Postpone(event, status(_arcs[k].arc),
+				status(_arcs[first].arc));
+		k = first;
+	}
+	Entry left = _arcs[k - 1];
+	Entry middle = _arcs[k];
+	Entry right = _arcs[k + 1];
+
+	/* The event of the arc itself was already taken from the queue. */
+	status(middle.arc)->set_circle_event_handle(kNoEvent);
+	RemoveCircleEvent(status(left.arc));
+	RemoveCircleEvent(status(right.arc));
+
+	/* The breakpoint on the left goes on between the two neighbors. */
+	CloseArc(left.site, middle.site, right.site, status(left.right),
+			status(middle.right), status(left.right));
+	_statuses.Free(middle.right);
+	_statuses.Free(middle.arc);
+	_arcs.erase(_arcs.begin() + k);
+
+	CheckCircle(k - 1, event.y);
+	CheckCircle(k, event.y);
+}
+
+/**
+ * Position of the arc to close before the one at |k|, whose |event| was
+ * just taken, or |k|: see BeachLine::FirstOfTied().
+ */
+size_t FlatBeachLine::FirstTied(size_t k, const CircleEvent& event)
+{
+	size_t first = k, last = k;
+
+	if (!queue->hasTied(event))
+		return k;
+	for (size_t i = 1; i <= kLookAround && i <= k; i++)
+		if (IsTied(status(_arcs[k - i].arc), event))
+			first = k - i;
+	for (size_t i = 1; i <= kLookAround && k + i < _arcs.size(); i++)
+		if (IsTied(status(_arcs[k + i].arc), event))
+			last = k + i;
+	if (first == last)
+		return k;
+
+	/* Two more arcs on each side, where there are. */
+	size_t begin = first < 2 ? 0 : first - 2;
+	size_t end = std::min(last + 2, _arcs.size() - 1);
+	_tied.clear();
+	for (size_t i = begin; i <= end; i++) {
+		TiedArc tied = { _arcs[i].site, i == k
+				|| IsTied(status(_arcs[i].arc), event) };
+		_tied.push_back(tied);
+	}
+	return begin + FirstOfTied(k - begin);
+}
+
+/**
+ * Whether |event| comes before |site|, which the queue could not tell.
+ */
+bool FlatBeachLine::EventFirst(const CircleEvent& event,
+		const Point* site) const
+{
+	size_t k = Find(event);
+
+	return CircleAbove(*_arcs[k - 1].site, *_arcs[k].site,
+			*_arcs[k + 1].site, site->y());
+}
+
+void FlatBeachLine::FinishEdges()
+{
+	FinishUpwardEdges();
+	for (size_t i = 0; i + 1 < _arcs.size(); i++)
+		FinishBreakpoint(status(_arcs[i].right));
+	FinishMesh();
+}
+
+void FlatBeachLine::Sweep()
+{
+	while (!queue->empty()) {
+		queue->tiedWithSite(_tied_events);
+		size_t first = 0;
+		while (first < _tied_events.size() && !EventFirst(queue->event(
+				_tied_events[first]), queue->site()))
+			first++;
+		if (first < _tied_events.size()) {
+			CircleEvent event = queue->event(_tied_events[first]);
+			queue->erase(_tied_events[first]);
+			RemoveParabola(event);
+		} else if (!_tied_events.empty() || queue->isSiteNext()) {
+			Point* site = queue->site();
+			queue->popSite();
+			InsertParabola(site);
+		} else {
+			/* The queue reuses the event storage on the next push. */
+			CircleEvent event = queue->circle();
+			queue->pop();
+			RemoveParabola(event);
+		}
+	}
+	FinishEdges();
+}
+
+void FlatBeachLine::Reset()
+{
+	_arcs.clear();
+	_statuses.Clear();
+	ResetEdges();
+}
+
+void FlatBeachLine::ReserveNodes(size_t count)
+{
+	_statuses.Reserve(count);
+	_arcs.reserve(count / 2);
+}
+
+const Point* FlatBeachLine::ArcAbove(const Point* site) const
+{
+	if (_arcs.empty())
+		return NULL;
+	return _arcs[Locate(site)].site;
+}
+
+size_t FlatBeachLine::size() const
+{
+	return _arcs.size();
+}
+
+/**
+ * Position of the arc above |site|: the first one whose right breakpoint
+ * is to the right of it.  Same rule as RBTreeNode::FindNearest().
+ */
+size_t FlatBeachLine::Locate(const Point* site) const
+{
+	size_t low = 0, high = _arcs.size() - 1;
+
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		const Status* right = status(_arcs[middle].right);
+		if (LeftOfBreakpoint(*right->i, *right->j, *site))
+			high = middle;
+		else
+			low = middle + 1;
+	}
+	return low;
+}
+
+/**
+ * Position of the arc of |event|.  Both of its breakpoints meet at the
+ * event, so the search lands on the arc or, through rounding or other
+ * arcs shrinking at the same point, next to it.
+ */
+size_t FlatBeachLine::Find(const CircleEvent& event) const
+{
+	Point at(event.x, event.y);
+	size_t guess = Locate(&at);
+
+	for (size_t d = 0; d < _arcs.size(); d++) {
+		if (guess + d < _arcs.size() && _arcs[guess + d].arc == event.arc)
+			return guess + d;
+		if (d <= guess && _arcs[guess - d].arc == event.arc)
+			return guess - d;
+	}
+	assert(false);
+	return guess;
+}
+
+NodeIndex FlatBeachLine::CreateStatus(const Status& data)
+{
+	NodeIndex index = _statuses.Allocate();
+
+	new (_statuses.at(index)) Status(data);
+	return index;
+}
+
+Status* FlatBeachLine::status(NodeIndex index) const
+{
+	return _statuses.at(index);
+}
+
+}
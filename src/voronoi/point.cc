@@ -7,132 +7,62 @@
  */
 
 #include <algorithm>
-#include <iostream>
 #include <limits>
 #include <sstream>
 #include <cmath>
 #include <voronoi/point.hh>
+#include <voronoi/predicates.hh>
 
 namespace voronoi {
 
-static Point GetCircleCenter(const Point* a, const Point* b, const Point* c)
+static double SquaredDistance(const Point& p, const Point& q)
 {
-	double y_delta_a = b->y() - a->y();
-	double x_delta_a = b->x() - a->x();
-	double y_delta_b = c->y() - b->y();
-	double x_delta_b = c->x() - b->x();
-
-	double a_slope = y_delta_a / x_delta_a;
-	double b_slope = y_delta_b / x_delta_b;
-
-	double center_x, center_y;
-
-	center_x = (a_slope * b_slope * (a->y() - c->y()) + b_slope * (a->x() + b->x())
-			- a_slope * (b->x() + c->x())) / (2 * (b_slope - a_slope));
-	center_y = -1 * (center_x - (a->x() + b->x()) / 2) / a_slope
-			+ (a->y() + b->y()) / 2;
-
-	std::cerr << "Círculo " << a->str()
-					<< ", " << b->str() << ", "
-					<< c->str() << " = "
-					<< Point(center_x, center_y).str() << "\n";
-
-	return Point(center_x, center_y);
-}
-
-template <class T>
-class RBTreeNode;
-
-Point::Point() :
-		_x(0.0), _y(0.0), _id(0), _false_alarm(false), _face(-1U),
-				_lowest_circle_parabola_node(NULL)
-{
-}
-
-Point::Point(const Point& p) :
-		_false_alarm(p.isFalseAlarm()), _face(-1U)
-{
-	set_coordinates(p.x(), p.y());
-	set_id(p.id());
-	set_circle_lowest_circle_parabola_node(p.lowest_circle_parabola_node());
-}
-
-Point::Point(double x, double y) :
-		_id(0), _false_alarm(false), _face(-1U),
-				_lowest_circle_parabola_node(NULL)
-{
-	set_coordinates(x, y);
-}
-
-void Point::set_id(int id)
-{
-	_id = id;
-}
-
-void Point::set_coordinates(double x, double y)
-{
-	set_x(x);
-	set_y(y);
-}
-
-void Point::set_x(double x)
-{
-	_x = x;
-}
-
-void Point::set_y(double y)
-{
-	_y = y;
-}
-
-double Point::x() const
-{
-	return _x;
-}
-
-double Point::y() const
-{
-	return _y;
-}
-
-int Point::id() const
-{
-	return _id;
-}
-
-bool Point::operator <(const Point& b) const
-{
-	double abs_a = std::fabs(y());
-	double abs_b = std::fabs(b.y());
-	double greater = abs_a < abs_b? abs_b : abs_a;
-
-	return (b.y() - y()) > greater * std::numeric_limits<double>::epsilon();
-}
-
-bool Point::operator >(const Point& b) const
-{
-	return y() > b.y();
+	double dx = p.x() - q.x(), dy = p.y() - q.y();
+	return dx * dx + dy * dy;
 }
 
-bool Point::operator ==(const Point& b) const
-{
-	return x() == b.x() && y() == b.y();
-}
-
-void Point::set_face(unsigned int face)
-{
-	_face = face;
-}
-
-unsigned int Point::face() const
-{
-	return _face;
+/**
+ * Center of the circle through a, b and c, given their Orientation(), whose
+ * sign is exact: the center never lands on the wrong side of ab, and no
+ * turn that is not a line divides by zero.
+ */
+static Point GetCircleCenter(const Point* a, const Point* b, const Point* c,
+		double orientation)
+{
+	/*
+	 * Work relative to the corner opposite the longest side, which keeps
+	 * more bits for close points.  From a corner with a narrow angle, as
+	 * next to two sites an ulp apart, the terms below cancel out.  Turning
+	 * the corners around keeps the orientation.
+	 */
+	double ab = SquaredDistance(*a, *b);
+	double bc = SquaredDistance(*b, *c);
+	double ca = SquaredDistance(*c, *a);
+	if (ca > bc && ca >= ab)
+		return GetCircleCenter(b, c, a, orientation);
+	if (ab > bc && ab > ca)
+		return GetCircleCenter(c, a, b, orientation);
+
+	double bx = b->x() - a->x(), by = b->y() - a->y();
+	double cx = c->x() - a->x(), cy = c->y() - a->y();
+	double b_norm = bx * bx + by * by;
+	double c_norm = cx * cx + cy * cy;
+	/*
+	 * The filtered orientation only has the right sign; from this corner
+	 * the cross product is accurate, unless it is too small to have one.
+	 */
+	double cross = bx * cy - by * cx;
+	double d = 2 * ((cross > 0) == (orientation > 0) && cross != 0 ? cross
+			: orientation);
+
+	return Point(a->x() + (cy * b_norm - by * c_norm) / d,
+			a->y() + (bx * c_norm - cx * b_norm) / d);
 }
 
 void Point::SetCoordinatesToTheCircleCenter(const Point* a, const Point* b,
 		const Point* c)
 {
-	Point d = GetCircleCenter(a, b, c);
+	Point d = GetCircleCenter(a, b, c, Orientation(*a, *b, *c));
 
 	set_coordinates(d.x(), d.y());
 }
@@ -140,85 +70,127 @@ void Point::SetCoordinatesToTheCircleCenter(const Point* a, const Point* b,
 void Point::SetCoordinatesToTheCircleBottom(const Point* a, const Point* b,
 		const Point* c)
 {
-	Point d = GetCircleCenter(a, b, c);
+	SetCoordinatesToTheCircleBottom(a, b, c, Orientation(*a, *b, *c));
+}
+
+void Point::SetCoordinatesToTheCircleBottom(const Point* a, const Point* b,
+		const Point* c, double orientation)
+{
+	Point d = GetCircleCenter(a, b, c, orientation);
 
 	double dx = d.x() - a->x();
 	double dy = d.y() - a->y();
 
 	double radius = std::sqrt(std::pow(dx, 2) + std::pow(dy, 2));
 
-	set_coordinates(d.x(), d.y() - radius);
+	/*
+	 * Bottom relative to |a|.  Above a, dy - radius cancels out on the huge
+	 * circles of nearly aligned sites: -dx^2 / (dy + radius) does not.
+	 */
+	if (dy > 0)
+		set_coordinates(d.x(), a->y() - dx * dx / (dy + radius));
+	else
+		set_coordinates(d.x(), a->y() + (dy - radius));
 }
 
-RBTreeNode<Status>* Point::lowest_circle_parabola_node() const
+double Point::GetYOfParabolaInsersection(const Point* other) const
 {
-	return _lowest_circle_parabola_node;
+	double dp = 2. * (y() - other->y());
+	double a1 = 1. / dp;
+	double b1 = -2. * x() / dp;
+	double c1 = other->y() + dp / 4. + std::pow(x(), 2) / dp;
+
+	return a1 * std::pow(other->x(), 2) + b1 * other->x() + c1;
 }
 
-void Point::set_circle_lowest_circle_parabola_node(RBTreeNode<Status>* node)
+/* http://blog.ivank.net/fortunes-algorithm-and-implementation.html */
+double Point::GetXOfParabolaIntersection(const Point* q, double sweep_y) const
 {
-	_lowest_circle_parabola_node = node;
+	/* Same height: the parabolas only differ by a shift. */
+	if (y() == q->y())
+		return (x() + q->x()) / 2;
+	/* A site on the sweep line is a vertical ray at its x. */
+	if (y() == sweep_y)
+		return x();
+	if (q->y() == sweep_y)
+		return q->x();
+
+	/*
+	 * Equal distance to both sites and the sweep line gives, relative to
+	 * this site, dy u^2 + 2 dx dp u - dp (dx^2 + dq dy) = 0.  Solved so that
+	 * nothing cancels out: sites a rounding error apart in height, as
+	 * snapped coordinates make, get a finite breakpoint and not noise.
+	 */
+	double dp = y() - sweep_y, dq = q->y() - sweep_y;
+	double dx = q->x() - x(), dy = q->y() - y();
+	double root = std::sqrt(std::max(dp * dq * (dx * dx + dy * dy), 0.0));
+	double half_b = dx * dp;
+	double k = -(half_b + (half_b < 0 ? -root : root));
+	double u1 = k / dy;
+	double u2 = -dp * (dx * dx + dq * dy) / k;
+
+	if (y() >= q->y())
+		return x() + std::min(u1, u2);
+	return x() + std::max(u1, u2);
 }
 
-bool Point::isCircleEvent() const
+std::string Point::str() const
 {
-	return lowest_circle_parabola_node() != NULL;
+	std::stringstream ss;
+
+	ss << "(" << x() * 2  << "," << y() * 2 << ")";
+	return ss.str();
 }
 
-bool Point::isFalseAlarm() const
+BoundingBox::BoundingBox() :
+		_empty(true), _min_x(0), _max_x(0), _min_y(0), _max_y(0)
 {
-	return _false_alarm;
 }
 
-void Point::MarkAsFalseAlarm()
+BoundingBox::BoundingBox(double min_x, double min_y, double max_x,
+		double max_y) :
+		_empty(false), _min_x(min_x), _max_x(max_x), _min_y(min_y),
+				_max_y(max_y)
 {
-	_false_alarm = true;
 }
 
-double Point::GetYOfParabolaInsersection(Point* other) const
+void BoundingBox::Extend(const Point& p)
 {
-	double dp = 2. * (y() - other->y());
-	double a1 = 1. / dp;
-	double b1 = -2. * x() / dp;
-	double c1 = other->y() + dp / 4. + std::pow(x(), 2) / dp;
-
-	return a1 * std::pow(other->x(), 2) + b1 * other->x() + c1;
+	if (empty()) {
+		_min_x = _max_x = p.x();
+		_min_y = _max_y = p.y();
+		_empty = false;
+		return;
+	}
+	_min_x = std::min(_min_x, p.x());
+	_max_x = std::max(_max_x, p.x());
+	_min_y = std::min(_min_y, p.y());
+	_max_y = std::max(_max_y, p.y());
 }
 
-/* http://blog.ivank.net/fortunes-algorithm-and-implementation.html */
-double Point::GetXOfParabolaIntersection(const Point* q, double sweep_y) const
+void BoundingBox::Extend(const BoundingBox& box)
 {
-	/* p's (current) parabola */
-	double dp = 2.0 * (y() - sweep_y);
-	double a1 = 1.0 / dp;
-	double b1 = -2.0 * x() / dp;
-	double c1 = sweep_y + dp / 4 + std::pow(x(), 2) / dp;
-
-	/* q's parabola */
-	dp = 2.0 * (q->y() - sweep_y);
-	double a2 = 1.0 / dp;
-	double b2 = -2.0 * q->x() / dp;
-	double c2 = sweep_y + dp / 4 + std::pow(q->x(), 2) / dp;
-
-	double a = a1 - a2;
-	double b = b1 - b2;
-	double c = c1 - c2;
-
-	double disc = b * b - 4 * a * c;
-	double x1 = (-b + std::sqrt(disc)) / (2 * a);
-	double x2 = (-b - std::sqrt(disc)) / (2 * a);
+	if (box.empty())
+		return;
+	Extend(Point(box.min_x(), box.min_y()));
+	Extend(Point(box.max_x(), box.max_y()));
+}
 
-	if (y() >= q->y())
-		return std::min(x1, x2);
-	return std::max(x1, x2);
+void BoundingBox::Clear()
+{
+	*this = BoundingBox();
 }
 
-std::string Point::str() const
+Point BoundingBox::FarPoint(const Point& from, double dx, double dy) const
 {
-	std::stringstream ss;
+	double diagonal = std::max(std::hypot(_max_x - _min_x, _max_y - _min_y),
+			1.0);
+	double distance = diagonal + std::hypot(from.x() - (_min_x + _max_x) / 2,
+			from.y() - (_min_y + _max_y) / 2);
+	double norm = std::hypot(dx, dy);
 
-	ss << "(" << x() * 2  << "," << y() * 2 << ")";
-	return ss.str();
+	return Point(from.x() + dx / norm * distance,
+			from.y() + dy / norm * distance);
 }
 
 }
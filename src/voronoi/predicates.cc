@@ -0,0 +1,326 @@
+/**
+ *  @file
+ *  @brief 
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <voronoi/predicates.hh>
+
+namespace voronoi {
+
+/*
+ * Error bounds of the filters, after Shewchuk, "Adaptive Precision
+ * Floating-Point Arithmetic and Fast Robust Geometric Predicates".
+ */
+static const double kEpsilon = std::numeric_limits<double>::epsilon() / 2;
+static const double kOrientationBound = (3 + 16 * kEpsilon) * kEpsilon;
+static const double kInCircleBound = (10 + 96 * kEpsilon) * kEpsilon;
+static const double kBreakpointBound = (8 + 64 * kEpsilon) * kEpsilon;
+static const double kCircleAboveBound = (32 + 512 * kEpsilon) * kEpsilon;
+
+static thread_local PredicateStats stats = { 0, 0, 0, 0 };
+
+/*
+ * Exact arithmetic on expansions: sums of doubles that do not overlap,
+ * kept in increasing order of magnitude, so that the last one gives the
+ * sign.  Products use fma() rather than Dekker's split, which an optimizer
+ * contracting a * b - c into an fma would break.
+ */
+typedef std::vector<double> Expansion;
+
+static void TwoSum(double a, double b, double& sum, double& error)
+{
+	sum = a + b;
+	double b_virtual = sum - a;
+	double a_virtual = sum - b_virtual;
+	error = (a - a_virtual) + (b - b_virtual);
+}
+
+static void TwoProduct(double a, double b, double& product, double& error)
+{
+	product = a * b;
+	error = std::fma(a, b, -product);
+}
+
+/**
+ * Add |b| to |e|, in place.
+ */
+static void Grow(Expansion& e, double b)
+{
+	size_t kept = 0;
+	double q = b;
+
+	for (size_t i = 0; i < e.size(); i++) {
+		double h;
+		TwoSum(q, e[i], q, h);
+		if (h != 0)
+			e[kept++] = h;
+	}
+	e.resize(kept);
+	if (q != 0)
+		e.push_back(q);
+}
+
+static void Add(Expansion& e, const Expansion& f)
+{
+	for (size_t i = 0; i < f.size(); i++)
+		Grow(e, f[i]);
+}
+
+/**
+ * Add |e| times |b| to |out|.
+ */
+static void AddScaled(Expansion& out, const Expansion& e, double b)
+{
+	for (size_t i = 0; i < e.size(); i++) {
+		double product, error;
+		TwoProduct(e[i], b, product, error);
+		Grow(out, error);
+		Grow(out, product);
+	}
+}
+
+/**
+ * Add the exact |a| times |b| to |out|.
+ */
+static void AddProduct(Expansion& out, double a, double b)
+{
+	double product, error;
+
+	TwoProduct(a, b, product, error);
+	Grow(out, error);
+	Grow(out, product);
+}
+
+static Expansion Product(const Expansion& e, const Expansion& f)
+{
+	Expansion out;
+
+	for (size_t i = 0; i < f.size(); i++)
+		AddScaled(out, e, f[i]);
+	return out;
+}
+
+static Expansion Negated(Expansion e)
+{
+	for (size_t i = 0; i < e.size(); i++)
+		e[i] = -e[i];
+	return e;
+}
+
+/**
+ * The exact |a| - |b|.
+ */
+static Expansion Difference(double a, double b)
+{
+	Expansion e;
+
+	Grow(e, a);
+	Grow(e, -b);
+	return e;
+}
+
+static double Estimate(const Expansion& e)
+{
+	double sum = 0;
+
+	for (size_t i = 0; i < e.size(); i++)
+		sum += e[i];
+	return sum;
+}
+
+static void ExactOrientation(const Point& a, const Point& b, const Point& c,
+		Expansion& out)
+{
+	out.clear();
+	AddProduct(out, a.x(), b.y());
+	AddProduct(out, -a.x(), c.y());
+	AddProduct(out, -a.y(), b.x());
+	AddProduct(out, a.y(), c.x());
+	AddProduct(out, b.x(), c.y());
+	AddProduct(out, -b.y(), c.x());
+}
+
+double Orientation(const Point& a, const Point& b, const Point& c)
+{
+	double left = (a.x() - c.x()) * (b.y() - c.y());
+	double right = (a.y() - c.y()) * (b.x() - c.x());
+	double det = left - right;
+
+	stats.orientations++;
+	/* Terms of opposite signs, or a zero one, cannot cancel out. */
+	if (left == 0 || right == 0 || (left > 0) != (right > 0))
+		return det;
+	if (std::fabs(det) > kOrientationBound * (std::fabs(left)
+			+ std::fabs(right)))
+		return det;
+
+	stats.exact_orientations++;
+	Expansion exact;
+	ExactOrientation(a, b, c, exact);
+	return Estimate(exact);
+}
+
+double InCircle(const Point& a, const Point& b, const Point& c,
+		const Point& d)
+{
+	double adx = a.x() - d.x(), ady = a.y() - d.y();
+	double bdx = b.x() - d.x(), bdy = b.y() - d.y();
+	double cdx = c.x() - d.x(), cdy = c.y() - d.y();
+	double bc = bdx * cdy - cdx * bdy;
+	double ca = cdx * ady - adx * cdy;
+	double ab = adx * bdy - bdx * ady;
+	double alift = adx * adx + ady * ady;
+	double blift = bdx * bdx + bdy * bdy;
+	double clift = cdx * cdx + cdy * cdy;
+	double det = alift * bc + blift * ca + clift * ab;
+	double permanent = (std::fabs(bdx * cdy) + std::fabs(cdx * bdy)) * alift
+			+ (std::fabs(cdx * ady) + std::fabs(adx * cdy)) * blift
+			+ (std::fabs(adx * bdy) + std::fabs(bdx * ady)) * clift;
+
+	stats.incircles++;
+	if (std::fabs(det) > kInCircleBound * permanent)
+		return det;
+
+	/*
+	 * Expand the 4x4 determinant with rows (x, y, x^2 + y^2, 1) along the
+	 * lifted column: every term is a lift times an orientation.
+	 */
+	stats.exact_incircles++;
+	const Point* points[4] = { &a, &b, &c, &d };
+	Expansion exact, lift, orientation, term;
+	for (int i = 0; i < 4; i++) {
+		const Point* rest[3];
+		for (int j = 0, k = 0; j < 4; j++)
+			if (j != i)
+				rest[k++] = points[j];
+		ExactOrientation(*rest[0], *rest[1], *rest[2], orientation);
+		lift.clear();
+		AddProduct(lift, points[i]->x(), points[i]->x());
+		AddProduct(lift, points[i]->y(), points[i]->y());
+		term.clear();
+		for (size_t k = 0; k < lift.size(); k++)
+			AddScaled(term, orientation, i % 2 == 0 ? lift[k] : -lift[k]);
+		Add(exact, term);
+	}
+	return Estimate(exact);
+}
+
+/**
+ * Positive if, right above |s|, the parabola of |p| is lower than the one of
+ * |q|: (qx - sx)^2 + (qy - sy)^2 over qy - sy against the same for |p|.
+ */
+static double LowerParabola(const Point& p, const Point& q, const Point& s)
+{
+	double a = p.x() - s.x(), b = p.y() - s.y();
+	double c = q.x() - s.x(), d = q.y() - s.y();
+	double p_lift = a * a + b * b, q_lift = c * c + d * d;
+	double det = b * q_lift - d * p_lift;
+
+	if (std::fabs(det) > kBreakpointBound * (std::fabs(b) * q_lift
+			+ std::fabs(d) * p_lift))
+		return det;
+
+	Expansion ea = Difference(p.x(), s.x()), eb = Difference(p.y(), s.y());
+	Expansion ec = Difference(q.x(), s.x()), ed = Difference(q.y(), s.y());
+	Expansion p_exact = Product(ea, ea), q_exact = Product(ec, ec);
+	Add(p_exact, Product(eb, eb));
+	Add(q_exact, Product(ed, ed));
+	Expansion exact = Product(q_exact, eb);
+	Add(exact, Negated(Product(p_exact, ed)));
+	return Estimate(exact);
+}
+
+bool LeftOfBreakpoint(const Point& p, const Point& q, const Point& s)
+{
+	/*
+	 * Same height: the breakpoint is halfway, p.x + q.x against 2 s.x.  The
+	 * rounded sum only ties with 2 s.x if its error settles it.
+	 */
+	if (p.y() == q.y()) {
+		double sum, error;
+		TwoSum(p.x(), q.x(), sum, error);
+		return sum > 2 * s.x() || (sum == 2 * s.x() && error > 0);
+	}
+	/* A site on the sweep line is a vertical ray at its x. */
+	if (p.y() <= s.y())
+		return s.x() < p.x();
+	if (q.y() <= s.y())
+		return s.x() < q.x();
+
+	/*
+	 * The lower site has the narrower parabola, lower than the other one
+	 * between their two intersections and above its own site.  The
+	 * breakpoint is the left intersection if |q| is the lower site, the
+	 * right one otherwise.
+	 */
+	if (p.y() > q.y())
+		return s.x() < q.x() && LowerParabola(p, q, s) > 0;
+	return s.x() < p.x() || LowerParabola(p, q, s) > 0;
+}
+
+bool CircleAbove(const Point& a, const Point& b, const Point& c, double y)
+{
+	/* The bottom of the circle is never above a site on it. */
+	if (y >= a.y())
+		return false;
+
+	/*
+	 * Relative to |a|, the center is (u, v) = (U, V) / 2D, with D the
+	 * orientation.  Its bottom is above e = y - a.y < 0 when (v - e)^2 >
+	 * u^2 + v^2, that is 4 D^2 e^2 - 4 e D V - U^2 > 0.
+	 */
+	double bx = b.x() - a.x(), by = b.y() - a.y();
+	double cx = c.x() - a.x(), cy = c.y() - a.y();
+	double e = y - a.y();
+	double b_norm = bx * bx + by * by, c_norm = cx * cx + cy * cy;
+	double d = bx * cy - by * cx;
+	double u = cy * b_norm - by * c_norm;
+	double v = bx * c_norm - cx * b_norm;
+	double det = 4 * d * d * e * e - 4 * e * d * v - u * u;
+	double d_abs = std::fabs(bx * cy) + std::fabs(by * cx);
+	double u_abs = std::fabs(cy) * b_norm + std::fabs(by) * c_norm;
+	double v_abs = std::fabs(bx) * c_norm + std::fabs(cx) * b_norm;
+	double permanent = 4 * d_abs * d_abs * e * e
+			+ 4 * std::fabs(e) * d_abs * v_abs + u_abs * u_abs;
+
+	if (std::fabs(det) > kCircleAboveBound * permanent)
+		return det > 0;
+
+	Expansion ebx = Difference(b.x(), a.x()), eby = Difference(b.y(), a.y());
+	Expansion ecx = Difference(c.x(), a.x()), ecy = Difference(c.y(), a.y());
+	Expansion ee = Difference(y, a.y());
+	Expansion eb_norm = Product(ebx, ebx), ec_norm = Product(ecx, ecx);
+	Add(eb_norm, Product(eby, eby));
+	Add(ec_norm, Product(ecy, ecy));
+	Expansion ed = Product(ebx, ecy);
+	Add(ed, Negated(Product(eby, ecx)));
+	Expansion eu = Product(ecy, eb_norm);
+	Add(eu, Negated(Product(eby, ec_norm)));
+	Expansion ev = Product(ebx, ec_norm);
+	Add(ev, Negated(Product(ecx, eb_norm)));
+	Expansion de = Product(ed, ee);
+	Expansion exact = Product(de, de);
+	Add(exact, Negated(Product(de, ev)));
+	for (size_t i = 0; i < exact.size(); i++)
+		exact[i] *= 4;
+	Add(exact, Negated(Product(eu, eu)));
+	return Estimate(exact) > 0;
+}
+
+const PredicateStats& predicate_stats()
+{
+	return stats;
+}
+
+void ResetPredicateStats()
+{
+	stats = PredicateStats();
+}
+
+}
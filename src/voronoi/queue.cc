@@ -6,22 +6,286 @@
  *  @copyright FreeBSD License
  */
 
+#include <algorithm>
+#include <cmath>
+#include <thread>
 #include <voronoi/queue.hh>
 #include <voronoi/point.hh>
 
 namespace voronoi {
 
-VoronoiQueue::VoronoiQueue()
+/*
+ * Relative gap between a site and a circle event under which their order is
+ * settled exactly: far more than the rounding of an event, far less than
+ * any gap that matters.
+ */
+static const double kTieWindow = 1e-12;
+
+/*
+ * Strict order for the presorted sites: highest y first, left to right on
+ * ties.  ComparePoint tolerates an epsilon and is not a strict weak order,
+ * so it must not be given to std::sort.
+ */
+struct CompareSite {
+	bool operator ()(const Point* a, const Point* b) const
+	{
+		if (a->y() != b->y())
+			return a->y() > b->y();
+		return a->x() < b->x();
+	}
+};
+
+static void SortSites(std::vector<Point*>& sites)
+{
+	size_t workers = std::thread::hardware_concurrency();
+
+	if (sites.size() < VoronoiQueue::kParallelSortThreshold || workers < 2) {
+		std::sort(sites.begin(), sites.end(), CompareSite());
+		return;
+	}
+
+	/* Sort one chunk per thread, then merge neighbouring runs in rounds. */
+	std::vector<std::vector<Point*>::iterator> bounds;
+	for (size_t i = 0; i <= workers; i++)
+		bounds.push_back(sites.begin() + sites.size() * i / workers);
+
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < workers; i++)
+		threads.push_back(std::thread(std::sort<std::vector<Point*>::iterator,
+				CompareSite>, bounds[i], bounds[i + 1], CompareSite()));
+	for (size_t i = 0; i < threads.size(); i++)
+		threads[i].join();
+
+	for (size_t step = 1; step < workers; step *= 2) {
+		threads.clear();
+		for (size_t i = 0; i + step < workers; i += 2 * step) {
+			size_t last = std::min(i + 2 * step, workers);
+			threads.push_back(std::thread(std::inplace_merge<
+					std::vector<Point*>::iterator, CompareSite>, bounds[i],
+					bounds[i + step], bounds[last], CompareSite()));
+		}
+		for (size_t i = 0; i < threads.size(); i++)
+			threads[i].join();
+	}
+}
+
+const size_t VoronoiQueue::kParallelSortThreshold = 1 << 16;
+
+VoronoiQueue::VoronoiQueue() :
+		_cursor(0), _free_slot(kNoEvent), _scale(0)
+{
+
+}
+
+VoronoiQueue::VoronoiQueue(std::vector<Point*>& sites) :
+		_cursor(0), _free_slot(kNoEvent), _scale(0)
+{
+	Reset(sites);
+}
+
+void VoronoiQueue::Reset(std::vector<Point*>& sites)
+{
+	_sites.assign(sites.begin(), sites.end());
+	SortSites(_sites);
+	_cursor = 0;
+	_heap.clear();
+	_slots.clear();
+	_free_slot = kNoEvent;
+	_scale = 0;
+	_stats = QueueStats();
+	_stats.sites = _sites.size();
+}
+
+bool VoronoiQueue::empty() const
+{
+	return _cursor == _sites.size() && _heap.empty();
+}
+
+size_t VoronoiQueue::size() const
+{
+	return _sites.size() - _cursor + _heap.size();
+}
+
+Point* VoronoiQueue::site() const
+{
+	return _sites[_cursor];
+}
+
+const CircleEvent& VoronoiQueue::circle() const
+{
+	return _slots[_heap.front().handle].event;
+}
+
+Point VoronoiQueue::top() const
+{
+	if (isSiteNext())
+		return *site();
+	return Point(circle().x, circle().y);
+}
+
+void VoronoiQueue::pop()
+{
+	if (isSiteNext()) {
+		_cursor++;
+		return;
+	}
+	RemoveAt(0);
+}
+
+void VoronoiQueue::tiedWithSite(std::vector<EventHandle>& handles) const
+{
+	handles.clear();
+	if (_cursor == _sites.size() || _heap.empty())
+		return;
+	const Point& next = *_sites[_cursor];
+	if (!isSiteNext() && !Tied(next, Point(circle().x, circle().y)))
+		return;
+
+	/*
+	 * Walk the heap from the top, through positions first: below an event
+	 * too low to be tied, every event is lower still.
+	 */
+	double lowest = next.y() - kTieWindow * (std::fabs(next.x())
+			+ std::fabs(next.y()));
+	if (_heap[0].y >= lowest)
+		handles.push_back(0);
+	for (size_t i = 0; i < handles.size(); i++) {
+		size_t child = handles[i] * kArity + 1;
+		for (size_t j = child; j < child + kArity && j < _heap.size(); j++)
+			if (_heap[j].y >= lowest)
+				handles.push_back(j);
+	}
+	for (size_t i = 0; i < handles.size(); i++)
+		handles[i] = _heap[handles[i]].handle;
+}
+
+bool VoronoiQueue::Tied(const Point& a, const Point& b)
+{
+	double scale = std::fabs(a.x()) + std::fabs(a.y()) + std::fabs(b.x())
+			+ std::fabs(b.y());
+	return std::fabs(a.y() - b.y()) <= kTieWindow * scale;
+}
+
+bool VoronoiQueue::hasTied(const CircleEvent& event) const
+{
+	/* Every other event is at most as high as the top, and no larger. */
+	if (_heap.empty())
+		return false;
+	double scale = std::fabs(event.x) + std::fabs(event.y) + _scale;
+	return _heap[0].y >= event.y - kTieWindow * scale;
+}
+
+void VoronoiQueue::popSite()
 {
+	_cursor++;
+}
+
+EventHandle VoronoiQueue::push(const CircleEvent& event)
+{
+	EventHandle handle = _free_slot;
+
+	if (handle != kNoEvent) {
+		_free_slot = _slots[handle].position;
+	} else {
+		handle = _slots.size();
+		_slots.push_back(EventSlot());
+	}
+	_slots[handle].event = event;
+	_scale = std::max(_scale, std::fabs(event.x) + std::fabs(event.y));
 
+	HeapEntry entry = { event.y, handle };
+	_heap.push_back(entry);
+	_slots[handle].position = _heap.size() - 1;
+	SiftUp(_heap.size() - 1);
+
+	_stats.circle_events++;
+	_stats.peak_size = std::max(_stats.peak_size, _heap.size());
+	return handle;
 }
 
-VoronoiQueue::VoronoiQueue(std::vector<Point*>& sites)
+void VoronoiQueue::erase(EventHandle handle)
 {
-	std::vector<Point*>::iterator it;
+	RemoveAt(_slots[handle].position);
+	_stats.removed++;
+}
+
+const CircleEvent& VoronoiQueue::event(EventHandle handle) const
+{
+	return _slots[handle].event;
+}
 
-	for (it = sites.begin(); it != sites.end(); it++)
-		push(*it);
+const QueueStats& VoronoiQueue::stats() const
+{
+	return _stats;
+}
+
+bool VoronoiQueue::isSiteNext() const
+{
+	if (_cursor == _sites.size())
+		return false;
+	if (_heap.empty())
+		return true;
+	/* Exact: a site a rounding error below an event comes after it. */
+	return _sites[_cursor]->y() >= circle().y;
+}
+
+void VoronoiQueue::RemoveAt(size_t position)
+{
+	EventHandle handle = _heap[position].handle;
+	HeapEntry last = _heap.back();
+
+	_heap.pop_back();
+	if (position < _heap.size()) {
+		Place(position, last);
+		if (position > 0 && _heap[(position - 1) / kArity].y < last.y)
+			SiftUp(position);
+		else
+			SiftDown(position);
+	}
+	_slots[handle].position = _free_slot;
+	_free_slot = handle;
+}
+
+void VoronoiQueue::SiftUp(size_t position)
+{
+	HeapEntry entry = _heap[position];
+
+	while (position > 0) {
+		size_t parent = (position - 1) / kArity;
+		if (_heap[parent].y >= entry.y)
+			break;
+		Place(position, _heap[parent]);
+		position = parent;
+	}
+	Place(position, entry);
+}
+
+void VoronoiQueue::SiftDown(size_t position)
+{
+	HeapEntry entry = _heap[position];
+	size_t size = _heap.size();
+
+	for (;;) {
+		size_t first = position * kArity + 1;
+		if (first >= size)
+			break;
+		size_t last = std::min(first + kArity, size);
+		size_t best = first;
+		for (size_t child = first + 1; child < last; child++)
+			if (_heap[child].y > _heap[best].y)
+				best = child;
+		if (_heap[best].y <= entry.y)
+			break;
+		Place(position, _heap[best]);
+		position = best;
+	}
+	Place(position, entry);
+}
+
+void VoronoiQueue::Place(size_t position, const HeapEntry& entry)
+{
+	_heap[position] = entry;
+	_slots[entry.handle].position = position;
 }
 
 }
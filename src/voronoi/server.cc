@@ -0,0 +1,713 @@
+/**
+ *  @file
+ *  @brief Diagrams computed by a long-running process, over a UNIX socket.
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <voronoi/server.hh>
+
+namespace voronoi {
+
+/* Point indices are 32 bits, and a diagram has about three per site. */
+static const uint64_t kMaxSites = 1 << 28;
+
+/* Longest pause of Run() when accept() runs out of descriptors. */
+static const std::chrono::milliseconds kMaxAcceptBackoff(100);
+
+static bool SendMessage(int socket, const void* header, size_t header_size,
+		const void* body, size_t body_size, int file)
+{
+	char control[CMSG_SPACE(sizeof(int))];
+	struct iovec pieces[2];
+	struct msghdr message;
+
+	pieces[0].iov_base = const_cast<void*>(header);
+	pieces[0].iov_len = header_size;
+	pieces[1].iov_base = const_cast<void*>(body);
+	pieces[1].iov_len = body_size;
+	memset(&message, 0, sizeof(message));
+	message.msg_iov = pieces;
+	message.msg_iovlen = body_size > 0 ? 2 : 1;
+	if (file >= 0) {
+		memset(control, 0, sizeof(control));
+		message.msg_control = control;
+		message.msg_controllen = sizeof(control);
+		struct cmsghdr* rights = CMSG_FIRSTHDR(&message);
+		rights->cmsg_level = SOL_SOCKET;
+		rights->cmsg_type = SCM_RIGHTS;
+		rights->cmsg_len = CMSG_LEN(sizeof(int));
+		memcpy(CMSG_DATA(rights), &file, sizeof(int));
+	}
+
+	/* The descriptor goes with the first byte; the rest may take a while. */
+	while (message.msg_iovlen > 0) {
+		ssize_t sent = sendmsg(socket, &message, MSG_NOSIGNAL);
+		if (sent < 0 && errno == EINTR)
+			continue;
+		if (sent <= 0)
+			return false;
+		message.msg_control = NULL;
+		message.msg_controllen = 0;
+		while (message.msg_iovlen > 0
+				&& static_cast<size_t>(sent) >= message.msg_iov->iov_len) {
+			sent -= message.msg_iov->iov_len;
+			message.msg_iov++;
+			message.msg_iovlen--;
+		}
+		if (message.msg_iovlen > 0) {
+			message.msg_iov->iov_base =
+					static_cast<char*>(message.msg_iov->iov_base) + sent;
+			message.msg_iov->iov_len -= sent;
+		}
+	}
+	return true;
+}
+
+static bool ReadAll(int socket, void* data, size_t size)
+{
+	char* at = static_cast<char*>(data);
+
+	while (size > 0) {
+		ssize_t got = recv(socket, at, size, 0);
+		if (got < 0 && errno == EINTR)
+			continue;
+		if (got <= 0)
+			return false;
+		at += got;
+		size -= got;
+	}
+	return true;
+}
+
+/*
+ * Read a |size| bytes header and the descriptor that may come with it into
+ * |file|, -1 if none.
+ */
+static bool ReceiveMessage(int socket, void* header, size_t size, int* file)
+{
+	char control[CMSG_SPACE(sizeof(int))];
+	struct iovec piece;
+	struct msghdr message;
+	ssize_t got;
+
+	*file = -1;
+	piece.iov_base = header;
+	piece.iov_len = size;
+	memset(&message, 0, sizeof(message));
+	message.msg_iov = &piece;
+	message.msg_iovlen = 1;
+	message.msg_control = control;
+	message.msg_controllen = sizeof(control);
+	do
+		got = recvmsg(socket, &message, MSG_CMSG_CLOEXEC);
+	while (got < 0 && errno == EINTR);
+	if (got <= 0)
+		return false;
+	for (struct cmsghdr* c = CMSG_FIRSTHDR(&message); c != NULL;
+			c = CMSG_NXTHDR(&message, c))
+		if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_RIGHTS)
+			memcpy(file, CMSG_DATA(c), sizeof(int));
+	if (ReadAll(socket, static_cast<char*>(header) + got, size - got))
+		return true;
+	if (*file >= 0)
+		close(*file);
+	*file = -1;
+	return false;
+}
+
+/*
+ * Make the shared memory file |*file| hold at least |bytes|, mapped
+ * read-write at |*map|, and add |seals| to it.  It only grows; a file
+ * sealed against growing is replaced by a new one.
+ */
+static bool GrowSharedFile(const char* name, size_t bytes, int seals,
+		int* file, void** map, size_t* capacity)
+{
+	if (bytes <= *capacity)
+		return true;
+	size_t grown = std::max(bytes, std::max<size_t>(2 * *capacity, 1 << 16));
+	if (*map != NULL)
+		munmap(*map, *capacity);
+	*map = NULL;
+	*capacity = 0;
+	if (*file >= 0 && (seals & F_SEAL_GROW) != 0) {
+		close(*file);
+		*file = -1;
+	}
+	if (*file < 0 && (*file = memfd_create(name,
+			MFD_CLOEXEC | MFD_ALLOW_SEALING)) < 0)
+		return false;
+	if (ftruncate(*file, grown) != 0 || fcntl(*file, F_ADD_SEALS, seals) != 0)
+		return false;
+	void* mapped = mmap(NULL, grown, PROT_READ | PROT_WRITE, MAP_SHARED,
+			*file, 0);
+	if (mapped == MAP_FAILED)
+		return false;
+	*map = mapped;
+	*capacity = grown;
+	return true;
+}
+
+/*
+ * Whether the shared file |file| holds |bytes| and cannot shrink under a
+ * mapping of them.
+ */
+static bool SealedFileHolds(int file, uint64_t bytes)
+{
+	struct stat status;
+
+	return (fcntl(file, F_GET_SEALS) & F_SEAL_SHRINK) != 0
+			&& fstat(file, &status) == 0
+			&& static_cast<uint64_t>(status.st_size) >= bytes;
+}
+
+static bool SendFailure(int socket)
+{
+	ServerReply reply;
+
+	memset(&reply, 0, sizeof(reply));
+	reply.magic = kServerMagic;
+	reply.status = kReplyFailed;
+	return SendMessage(socket, &reply, sizeof(reply), NULL, 0, -1);
+}
+
+/* Bytes of a diagram in a reply file. */
+static uint64_t DiagramBytes(uint64_t points, uint64_t vertices,
+		uint64_t edges)
+{
+	return 2 * points * sizeof(double) + vertices * sizeof(VertexSites)
+			+ edges * sizeof(DiagramEdge);
+}
+
+/*
+ * A client and its buffers, kept from one request to the next.  |sites|
+ * holds sites sent inline; sites in a file are mapped at |sites_map|.
+ */
+struct DiagramServer::Connection {
+	int socket;
+	bool done;
+	bool failed; /**< The batch of the last request threw */
+	bool finished;
+	std::chrono::steady_clock::time_point arrival;
+	std::vector<Point> sites;
+	void* sites_map;
+	size_t sites_bytes;
+	Span<const Point> input;
+	VoronoiDCEL diagram;
+	int reply_file;
+	void* reply_map;
+	size_t reply_capacity;
+	std::thread thread;
+
+	explicit Connection(int socket) :
+			socket(socket), done(false), failed(false), finished(false),
+			sites_map(NULL),
+			sites_bytes(0), reply_file(-1), reply_map(NULL),
+			reply_capacity(0)
+	{
+	}
+
+	~Connection()
+	{
+		UnmapSites();
+		if (reply_map != NULL)
+			munmap(reply_map, reply_capacity);
+		if (reply_file >= 0)
+			close(reply_file);
+		close(socket);
+	}
+
+	void UnmapSites()
+	{
+		if (sites_map != NULL)
+			munmap(sites_map, sites_bytes);
+		sites_map = NULL;
+	}
+};
+
+const size_t DiagramServer::kMaxBatch;
+const size_t DiagramServer::kDefaultMaxSites;
+const size_t DiagramServer::kDefaultMaxConnections;
+const size_t DiagramClient::kSharedSitesBytes;
+
+DiagramServer::DiagramServer(unsigned int threads, unsigned int window,
+		size_t max_sites, size_t max_connections) :
+		_engine(threads), _window(window), _max_sites(std::min<uint64_t>(
+				max_sites, kMaxSites)), _max_connections(max_connections),
+		_listener(-1), _stopping(false), _closed(false)
+{
+}
+
+DiagramServer::~DiagramServer()
+{
+	if (_listener >= 0) {
+		close(_listener);
+		unlink(_path.c_str());
+	}
+}
+
+bool DiagramServer::Listen(const char* path)
+{
+	struct sockaddr_un address;
+
+	if (_listener >= 0 || strlen(path) >= sizeof(address.sun_path))
+		return false;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, path);
+	int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (listener < 0)
+		return false;
+	unlink(path);
+	if (bind(listener, reinterpret_cast<struct sockaddr*>(&address),
+			sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0) {
+		close(listener);
+		return false;
+	}
+	_listener = listener;
+	_path = path;
+	return true;
+}
+
+void DiagramServer::Run()
+{
+	std::chrono::milliseconds backoff(1);
+
+	_dispatcher = std::thread(&DiagramServer::Dispatch, this);
+	while (true) {
+		int client = accept4(_listener, NULL, NULL, SOCK_CLOEXEC);
+		int error = errno;
+		std::unique_lock<std::mutex> lock(_mutex);
+		if (_stopping) {
+			if (client >= 0)
+				close(client);
+			break;
+		}
+		if (client < 0) {
+			lock.unlock();
+			if (error == EINTR || error == ECONNABORTED)
+				continue;
+			if (error != EMFILE && error != ENFILE && error != ENOBUFS
+					&& error != ENOMEM)
+				break;
+			/* Out of descriptors or memory: let connections close. */
+			JoinConnections(false);
+			std::this_thread::sleep_for(backoff);
+			backoff = std::min(2 * backoff, kMaxAcceptBackoff);
+			continue;
+		}
+		backoff = std::chrono::milliseconds(1);
+		/* At the cap, closed connections make room first. */
+		if (_connections.size() >= _max_connections) {
+			lock.unlock();
+			JoinConnections(false);
+			lock.lock();
+		}
+		if (_connections.size() >= _max_connections) {
+			lock.unlock();
+			Refuse(client);
+			close(client);
+			continue;
+		}
+		Connection* connection = new Connection(client);
+		_connections.push_back(connection);
+		try {
+			connection->thread = std::thread(&DiagramServer::Serve, this,
+					connection);
+		} catch (const std::system_error&) {
+			/* Out of threads: turn this client away, serve the others. */
+			_connections.pop_back();
+			lock.unlock();
+			Refuse(client);
+			delete connection;
+			continue;
+		}
+		lock.unlock();
+		JoinConnections(false);
+	}
+	JoinConnections(true);
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_closed = true;
+	_arrived.notify_one();
+	lock.unlock();
+	_dispatcher.join();
+}
+
+void DiagramServer::Stop()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_stopping = true;
+	if (_listener >= 0)
+		shutdown(_listener, SHUT_RDWR);
+}
+
+ServerStats DiagramServer::stats() const
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	return _stats;
+}
+
+/* Answer |client| with kReplyFailed before reading its request. */
+void DiagramServer::Refuse(int client)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_stats.refused++;
+	lock.unlock();
+	SendFailure(client);
+}
+
+/*
+ * Join the threads of closed connections, or, with |all|, close every
+ * connection and join them all.
+ */
+void DiagramServer::JoinConnections(bool all)
+{
+	std::vector<Connection*> joined;
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	for (std::list<Connection*>::iterator i = _connections.begin();
+			i != _connections.end();) {
+		if (all || (*i)->finished) {
+			if (all)
+				shutdown((*i)->socket, SHUT_RDWR);
+			joined.push_back(*i);
+			i = _connections.erase(i);
+		} else {
+			++i;
+		}
+	}
+	lock.unlock();
+	for (size_t i = 0; i < joined.size(); i++) {
+		joined[i]->thread.join();
+		delete joined[i];
+	}
+}
+
+void DiagramServer::Serve(Connection* connection)
+{
+	while (Receive(connection)) {
+		Compute(connection);
+		connection->UnmapSites();
+		bool answered = connection->failed
+				? SendFailure(connection->socket) : Reply(connection);
+		if (!answered)
+			break;
+	}
+	std::unique_lock<std::mutex> lock(_mutex);
+	connection->finished = true;
+}
+
+bool DiagramServer::Receive(Connection* connection)
+{
+	ServerRequest request;
+	int file;
+
+	if (!ReceiveMessage(connection->socket, &request, sizeof(request), &file))
+		return false;
+	bool shared = (request.flags & kSitesInFile) != 0;
+	if (request.magic != kServerMagic || shared != (file >= 0)) {
+		if (file >= 0)
+			close(file);
+		return false;
+	}
+
+	/* Inline sites over the cap are not read, so the stream is lost. */
+	size_t bytes = request.sites * sizeof(Point);
+	if (request.sites > _max_sites) {
+		if (file >= 0)
+			close(file);
+		SendFailure(connection->socket);
+		return false;
+	}
+	if (!shared) {
+		try {
+			connection->sites.resize(request.sites);
+		} catch (const std::bad_alloc&) {
+			SendFailure(connection->socket);
+			return false;
+		}
+		connection->input = Span<const Point>(connection->sites.data(),
+				request.sites);
+		return ReadAll(connection->socket, connection->sites.data(), bytes);
+	}
+
+	void* map = NULL;
+	if (bytes > 0 && SealedFileHolds(file, bytes))
+		map = mmap(NULL, bytes, PROT_READ, MAP_SHARED, file, 0);
+	close(file);
+	if (bytes > 0 && (map == NULL || map == MAP_FAILED)) {
+		SendFailure(connection->socket);
+		return false;
+	}
+	connection->sites_map = bytes > 0 ? map : NULL;
+	connection->sites_bytes = bytes;
+	connection->input = Span<const Point>(static_cast<const Point*>(map),
+			request.sites);
+	return true;
+}
+
+/* Queue |connection| for the dispatcher and wait for its diagram. */
+void DiagramServer::Compute(Connection* connection)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	connection->done = false;
+	connection->arrival = std::chrono::steady_clock::now();
+	_pending.push_back(connection);
+	if (_pending.size() == 1 || _pending.size() >= kMaxBatch)
+		_arrived.notify_one();
+	_computed.wait(lock, [connection]() { return connection->done; });
+}
+
+bool DiagramServer::Reply(Connection* connection)
+{
+	const VoronoiDCEL& diagram = connection->diagram;
+	ServerReply reply;
+
+	reply.magic = kServerMagic;
+	reply.status = kReplyOk;
+	reply.points = diagram.point_count();
+	reply.vertices = diagram.vertex_count();
+	reply.edges = diagram.edges().size();
+	reply.bytes = DiagramBytes(reply.points, reply.vertices, reply.edges);
+	/* The client gets the descriptor: it may not resize what we write. */
+	if (!GrowSharedFile("voronoi-diagram", std::max<size_t>(reply.bytes, 1),
+			F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL,
+			&connection->reply_file, &connection->reply_map,
+			&connection->reply_capacity))
+		return SendFailure(connection->socket);
+
+	char* at = static_cast<char*>(connection->reply_map);
+	size_t bytes = diagram.coordinates().size() * sizeof(double);
+	memcpy(at, diagram.coordinates().data(), bytes);
+	at += bytes;
+	bytes = diagram.vertex_sites().size() * sizeof(VertexSites);
+	memcpy(at, diagram.vertex_sites().data(), bytes);
+	at += bytes;
+	/* Whole records: DiagramEdge has no padding to leak to the client. */
+	memcpy(at, diagram.edges().data(), reply.edges * sizeof(DiagramEdge));
+	return SendMessage(connection->socket, &reply, sizeof(reply), NULL, 0,
+			connection->reply_file);
+}
+
+/*
+ * Take the requests that arrive within the window of the oldest one
+ * waiting, up to kMaxBatch, and compute them together.  Each diagram is
+ * swapped in and out of the batch, so its memory stays with its
+ * connection.
+ */
+void DiagramServer::Dispatch()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	while (true) {
+		_arrived.wait(lock, [this]() {
+			return _closed || !_pending.empty();
+		});
+		if (_pending.empty())
+			return;
+		std::chrono::steady_clock::time_point deadline =
+				_pending.front()->arrival
+						+ std::chrono::microseconds(_window);
+		_arrived.wait_until(lock, deadline, [this]() {
+			return _pending.size() >= kMaxBatch;
+		});
+
+		size_t count = std::min(kMaxBatch, _pending.size());
+		_batch.assign(_pending.begin(), _pending.begin() + count);
+		_pending.erase(_pending.begin(), _pending.begin() + count);
+		lock.unlock();
+
+		/* A batch that throws is answered with kReplyFailed, all of it. */
+		bool failed = false, swapped = false;
+		try {
+			_inputs.resize(count);
+			_outputs.resize(count);
+			for (size_t i = 0; i < count; i++) {
+				_inputs[i] = _batch[i]->input;
+				std::swap(_outputs[i], _batch[i]->diagram);
+			}
+			swapped = true;
+			_engine.Compute(_inputs, _outputs);
+		} catch (const std::exception&) {
+			failed = true;
+		}
+		for (size_t i = 0; swapped && i < count; i++)
+			std::swap(_outputs[i], _batch[i]->diagram);
+
+		lock.lock();
+		for (size_t i = 0; i < count; i++) {
+			_batch[i]->failed = failed;
+			_batch[i]->done = true;
+		}
+		_stats.requests += count;
+		_stats.batches++;
+		_stats.largest_batch = std::max(_stats.largest_batch, count);
+		_computed.notify_all();
+	}
+}
+
+DiagramClient::DiagramClient() :
+		_socket(-1), _sites_file(-1), _sites_capacity(0), _sites_map(NULL),
+		_diagram(NULL)
+{
+	memset(&_reply, 0, sizeof(_reply));
+}
+
+DiagramClient::~DiagramClient()
+{
+	Unmap();
+	if (_sites_map != NULL)
+		munmap(_sites_map, _sites_capacity);
+	if (_sites_file >= 0)
+		close(_sites_file);
+	if (_socket >= 0)
+		close(_socket);
+}
+
+bool DiagramClient::Connect(const char* path)
+{
+	struct sockaddr_un address;
+
+	if (_socket >= 0 || strlen(path) >= sizeof(address.sun_path))
+		return false;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, path);
+	_socket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (_socket < 0)
+		return false;
+	if (connect(_socket, reinterpret_cast<struct sockaddr*>(&address),
+			sizeof(address)) == 0)
+		return true;
+	close(_socket);
+	_socket = -1;
+	return false;
+}
+
+bool DiagramClient::ShareSites(Span<const Point> sites)
+{
+	size_t bytes = sites.size() * sizeof(Point);
+
+	if (!GrowSharedFile("voronoi-sites", bytes, F_SEAL_SHRINK, &_sites_file,
+			&_sites_map, &_sites_capacity))
+		return false;
+	memcpy(_sites_map, sites.data(), bytes);
+	return true;
+}
+
+void DiagramClient::Unmap()
+{
+	if (_diagram != NULL)
+		munmap(_diagram, _reply.bytes);
+	_diagram = NULL;
+	memset(&_reply, 0, sizeof(_reply));
+}
+
+bool DiagramClient::Compute(Span<const Point> sites)
+{
+	ServerRequest request;
+	bool sent;
+	int file;
+
+	Unmap();
+	if (_socket < 0)
+		return false;
+	request.magic = kServerMagic;
+	request.flags = 0;
+	request.sites = sites.size();
+	size_t bytes = sites.size() * sizeof(Point);
+	if (bytes >= kSharedSitesBytes && ShareSites(sites)) {
+		request.flags = kSitesInFile;
+		sent = SendMessage(_socket, &request, sizeof(request), NULL, 0,
+				_sites_file);
+	} else {
+		sent = SendMessage(_socket, &request, sizeof(request), sites.data(),
+				bytes, -1);
+	}
+	if (!sent || !ReceiveMessage(_socket, &_reply, sizeof(_reply), &file))
+		return false;
+
+	bool valid = _reply.magic == kServerMagic && _reply.status == kReplyOk
+			&& file >= 0 && _reply.bytes == DiagramBytes(_reply.points,
+					_reply.vertices, _reply.edges)
+			&& SealedFileHolds(file, _reply.bytes);
+	if (valid && _reply.bytes > 0) {
+		_diagram = mmap(NULL, _reply.bytes, PROT_READ, MAP_SHARED, file, 0);
+		if (_diagram == MAP_FAILED) {
+			_diagram = NULL;
+			valid = false;
+		}
+	}
+	if (file >= 0)
+		close(file);
+	if (!valid)
+		memset(&_reply, 0, sizeof(_reply));
+	return valid;
+}
+
+size_t DiagramClient::point_count() const
+{
+	return _reply.points;
+}
+
+size_t DiagramClient::vertex_count() const
+{
+	return _reply.vertices;
+}
+
+size_t DiagramClient::edge_count() const
+{
+	return _reply.edges;
+}
+
+const double* DiagramClient::coordinates() const
+{
+	return static_cast<const double*>(_diagram);
+}
+
+const VertexSites* DiagramClient::vertex_sites() const
+{
+	return reinterpret_cast<const VertexSites*>(coordinates()
+			+ 2 * _reply.points);
+}
+
+const DiagramEdge* DiagramClient::edges() const
+{
+	return reinterpret_cast<const DiagramEdge*>(vertex_sites()
+			+ _reply.vertices);
+}
+
+void DiagramClient::CopyTo(VoronoiDCEL& out) const
+{
+	out.Clear();
+	for (size_t i = 0; i < point_count(); i++) {
+		double x = coordinates()[2 * i];
+		double y = coordinates()[2 * i + 1];
+		if (i < vertex_count())
+			out.addVertex(x, y, vertex_sites()[i]);
+		else
+			out.addFarPoint(x, y);
+	}
+	for (size_t i = 0; i < edge_count(); i++)
+		out.addEdge(edges()[i]);
+}
+
+}
@@ -9,29 +9,39 @@
 #include <sstream>
 #include <cassert>
 #include <cstddef>
+#include <limits>
 #include <voronoi/status.hh>
 #include <voronoi/point.hh>
 
 namespace voronoi {
 
 Status::Status() :
-		i(NULL), j(NULL), arc(NULL), _circle_event(NULL), _start(NULL)
+		i(NULL), j(NULL), arc(NULL), _circle_event_handle(kNoEvent),
+				_start(kNoVertex), _twin(NULL), _half_edge(-1U), _x(0),
+				_x_sweep(std::numeric_limits<double>::quiet_NaN())
 {
 }
 
 Status::Status(const Status& status) :
 		i(status.i), j(status.j), arc(status.arc),
-				_circle_event(status.circle_event()), _start(status.start())
+				_circle_event_handle(status.circle_event_handle()),
+				_start(status.start()), _twin(status.twin()),
+				_half_edge(status.half_edge()), _x(status._x),
+				_x_sweep(status._x_sweep)
 {
 }
 
 Status::Status(Point* arc) :
-		i(NULL), j(NULL), arc(arc), _circle_event(NULL), _start(NULL)
+		i(NULL), j(NULL), arc(arc), _circle_event_handle(kNoEvent),
+				_start(kNoVertex), _twin(NULL), _half_edge(-1U), _x(0),
+				_x_sweep(std::numeric_limits<double>::quiet_NaN())
 {
 }
 
 Status::Status(Point* i, Point* j) :
-		i(i), j(j), arc(NULL), _circle_event(NULL), _start(NULL)
+		i(i), j(j), arc(NULL), _circle_event_handle(kNoEvent),
+				_start(kNoVertex), _twin(NULL), _half_edge(-1U), _x(0),
+				_x_sweep(std::numeric_limits<double>::quiet_NaN())
 {
 }
 
@@ -39,22 +49,6 @@ Status::~Status()
 {
 }
 
-bool Status::operator <(const Status& b) const
-{
-	assert(i != NULL);
-	assert(j != NULL);
-	assert(b.arc != NULL);
-	return b.arc->x() < i->GetXOfParabolaIntersection(j, b.arc->y());
-}
-
-bool Status::operator >(const Status& b) const
-{
-	assert(i != NULL);
-	assert(j != NULL);
-	assert(b.arc != NULL);
-	return b.arc->x() > i->GetXOfParabolaIntersection(j, b.arc->y());
-}
-
 bool Status::operator ==(const Status& b) const
 {
 	assert(i == NULL);
@@ -73,53 +67,4 @@ std::string Status::str() const
 	return arc->str();
 }
 
-Point* Status::start() const
-{
-	return _start;
-}
-
-void Status::set_start(Point* start)
-{
-	_start = start;
-}
-
-Point* Status::circle_event() const
-{
-	return _circle_event;
-}
-
-void Status::set_circle_event(Point* event)
-{
-	_circle_event = event;
-}
-
-bool Status::hasCircleEvent() const
-{
-	return circle_event() != NULL;
-}
-
-void Status::RemoveCircleEvent()
-{
-	if (hasCircleEvent()) {
-		circle_event()->MarkAsFalseAlarm();
-		set_circle_event(NULL);
-	}
-}
-
-unsigned int Status::face() const
-{
-	return _face;
-}
-
-
-void Status::set_face(unsigned int face)
-{
-	_face = face;
-}
-
-bool Status::hasFace() const
-{
-	return face() != -1U;
-}
-
 }
@@ -0,0 +1,176 @@
+/**
+ *  @file
+ *  @brief 
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#include <algorithm>
+#include <voronoi/status.hh>
+#include <voronoi/stream.hh>
+
+namespace voronoi {
+
+StreamingSweep::StreamingSweep(const PointCallback& on_point,
+		const EdgeCallback& on_edge) :
+		_tree(&_queue, &_dcel), _reported_edges(0),
+				_compact_at(kMinCompaction), _next_point(0), _next_site(0),
+				_mark(0), _finished(false), _on_point(on_point),
+				_on_edge(on_edge)
+{
+	_tree.set_site_id(SlotId);
+}
+
+int StreamingSweep::AddSite(const Point& site)
+{
+	if (_finished || (_next_site > 0 && !isAfterLast(site)))
+		return kNoSite;
+
+	while (!_queue.empty() && site < _queue.top()) {
+		/* The queue reuses the event storage on the next push. */
+		CircleEvent event = _queue.circle();
+		_queue.pop();
+		_tree.RemoveParabola(event);
+	}
+
+	Slot* slot;
+	if (_free_slots.empty()) {
+		_slots.push_back(Slot());
+		slot = &_slots.back();
+	} else {
+		slot = _free_slots.back();
+		_free_slots.pop_back();
+	}
+	slot->site = site;
+	slot->id = _next_site++;
+	slot->mark = _mark;
+	_last = site;
+	_tree.InsertParabola(&slot->site);
+
+	Report();
+	if (held_points() + held_sites() >= _compact_at)
+		Compact();
+	return slot->id;
+}
+
+void StreamingSweep::Finish()
+{
+	if (_finished)
+		return;
+	while (!_queue.empty()) {
+		CircleEvent event = _queue.circle();
+		_queue.pop();
+		_tree.RemoveParabola(event);
+	}
+	_tree.FinishEdges();
+	Report();
+	_finished = true;
+}
+
+void StreamingSweep::Reset()
+{
+	std::vector<Point*> none;
+
+	_queue.Reset(none);
+	_tree.Reset();
+	_dcel.Clear();
+	_slots.clear();
+	_free_slots.clear();
+	_point_ids.clear();
+	_reported_edges = 0;
+	_compact_at = kMinCompaction;
+	_next_point = 0;
+	_next_site = 0;
+	_finished = false;
+}
+
+size_t StreamingSweep::beach_line_size() const
+{
+	return _tree.size();
+}
+
+size_t StreamingSweep::pending_events() const
+{
+	return _queue.size();
+}
+
+size_t StreamingSweep::held_sites() const
+{
+	return _slots.size() - _free_slots.size();
+}
+
+size_t StreamingSweep::held_points() const
+{
+	return _dcel.point_count();
+}
+
+int StreamingSweep::SlotId(const Point* site)
+{
+	return reinterpret_cast<const Slot*>(site)->id;
+}
+
+/**
+ * The order of VoronoiQueue: highest y first, left to right on ties.
+ */
+bool StreamingSweep::isAfterLast(const Point& site) const
+{
+	if (site.y() != _last.y())
+		return site.y() < _last.y();
+	return site.x() > _last.x();
+}
+
+/**
+ * Hand out the points and edges added to the diagram since the last call.
+ */
+void StreamingSweep::Report()
+{
+	for (size_t v = _point_ids.size(); v < _dcel.point_count(); v++) {
+		_point_ids.push_back(_next_point++);
+		_on_point(_point_ids[v], _dcel.point(v), v < _dcel.vertex_count()
+				? _dcel.vertex_sites()[v] : VertexSites());
+	}
+	for (; _reported_edges < _dcel.edges().size(); _reported_edges++) {
+		const DiagramEdge& edge = _dcel.edges()[_reported_edges];
+		StreamEdge reported = { _point_ids[edge.origin],
+				_point_ids[edge.destination], edge.left_site,
+				edge.right_site, edge.origin_at_infinity,
+				edge.destination_at_infinity };
+		_on_edge(reported);
+	}
+}
+
+/**
+ * Drop the reported edges, the vertices no open edge needs and the sites
+ * that left the beach line.  The next compaction waits until the held
+ * points and sites double, so each costs O(1) per site, amortized.
+ */
+void StreamingSweep::Compact()
+{
+	_tree.CompactDiagram(_kept);
+	for (size_t i = 0; i < _kept.size(); i++)
+		_point_ids[i] = _point_ids[_kept[i]];
+	_point_ids.resize(_kept.size());
+	_reported_edges = 0;
+
+	_mark++;
+	Node* top = _tree.root();
+	for (Node* p = top; p != NULL; p = p->NextPreOrder(top))
+		if (p->isLeaf())
+			reinterpret_cast<Slot*>(p->data()->arc)->mark = _mark;
+	for (size_t i = 0; i < _slots.size(); i++) {
+		Slot* slot = &_slots[i];
+		if (slot->id != kNoSite && slot->mark != _mark) {
+			slot->id = kNoSite;
+			_free_slots.push_back(slot);
+		}
+	}
+
+	_compact_at = std::max(2 * (held_points() + held_sites()),
+			kMinCompaction);
+}
+
+const int StreamingSweep::kNoSite;
+const size_t StreamingSweep::kMinCompaction;
+
+}
@@ -0,0 +1,662 @@
+/**
+ *  @file
+ *  @brief Parallel sweep over vertical strips of the sites.
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <thread>
+#include <voronoi/engine.hh>
+#include <voronoi/predicates.hh>
+#include <voronoi/strips.hh>
+
+namespace voronoi {
+
+/* Sites sampled per strip to place the cuts. */
+static const size_t kSamplesPerStrip = 256;
+
+/*
+ * A strip gives up, and the whole diagram is swept at once, after this many
+ * sweeps, or after testing its share of this many sites per input site in
+ * its circles.
+ */
+static const size_t kMaxSweeps = 6;
+static const size_t kTestsPerSite = 64;
+
+struct StripEngine::Strip {
+	Engine engine;
+	std::vector<Point> local; /**< Strip and halo sites */
+	std::vector<int> ids; /**< Position in the input of each local site */
+	std::vector<int> own; /**< Positions of the strip's sites, ascending */
+	std::vector<const Point*> core; /**< Sites of the strip, for the hull */
+	std::vector<int> hull;
+	std::vector<int> extra; /**< Sites swept from outside the halo, sorted */
+	std::vector<int> missing; /**< Sites found inside empty circles */
+	/* Edges and vertices of the strip's diagram that it answers for. */
+	std::vector<size_t> owned_edges;
+	std::vector<size_t> owned_vertices;
+	std::vector<uint32_t> merged; /**< Output index of each vertex */
+	std::exception_ptr error;
+	size_t sweeps;
+	size_t halo_sites;
+	size_t budget; /**< Tests left in circles before giving up */
+};
+
+/**
+ * Buckets of sites over a uniform grid with about one site per cell.
+ */
+struct StripEngine::SiteGrid {
+	BoundingBox box;
+	double cell;
+	size_t columns;
+	size_t rows;
+	std::vector<size_t> first; /**< Start of each cell in |sites| */
+	std::vector<int> sites;
+
+	void Build(Span<const Point> points, const BoundingBox& bounds)
+	{
+		double width = bounds.max_x() - bounds.min_x();
+		double height = bounds.max_y() - bounds.min_y();
+
+		box = bounds;
+		cell = std::sqrt(width * height / points.size());
+		if (!(cell > 0))
+			cell = std::max(width, height) / points.size();
+		if (!(cell > 0))
+			cell = 1;
+		columns = static_cast<size_t>(width / cell) + 1;
+		rows = static_cast<size_t>(height / cell) + 1;
+
+		first.assign(columns * rows + 1, 0);
+		for (size_t i = 0; i < points.size(); i++)
+			first[Cell(points[i]) + 1]++;
+		for (size_t c = 0; c < columns * rows; c++)
+			first[c + 1] += first[c];
+		sites.resize(points.size());
+		std::vector<size_t> next(first.begin(), first.end() - 1);
+		for (size_t i = 0; i < points.size(); i++)
+			sites[next[Cell(points[i])]++] = i;
+	}
+
+	size_t Column(double x) const
+	{
+		double c = std::floor((x - box.min_x()) / cell);
+		return c < 0 ? 0 : std::min(static_cast<size_t>(c), columns - 1);
+	}
+
+	size_t Row(double y) const
+	{
+		double r = std::floor((y - box.min_y()) / cell);
+		return r < 0 ? 0 : std::min(static_cast<size_t>(r), rows - 1);
+	}
+
+	size_t Cell(const Point& p) const
+	{
+		return Row(p.y()) * columns + Column(p.x());
+	}
+};
+
+static bool CompareXY(const Point* a, const Point* b)
+{
+	return a->x() < b->x() || (a->x() == b->x() && a->y() < b->y());
+}
+
+static bool SameXY(const Point* a, const Point* b)
+{
+	return a->x() == b->x() && a->y() == b->y();
+}
+
+/**
+ * Andrew's monotone chain, with exact turns.  Points on the sides are kept,
+ * since the diagram has a ray between each two of them in a row; copies of
+ * a point are not, as they would never be popped.  When all points are on
+ * a line, each comes twice, once each way.
+ */
+static void ConvexHull(std::vector<const Point*>& points,
+		std::vector<const Point*>& hull)
+{
+	size_t k = 0;
+
+	std::sort(points.begin(), points.end(), CompareXY);
+	points.erase(std::unique(points.begin(), points.end(), SameXY),
+			points.end());
+	if (points.size() < 3) {
+		hull = points;
+		return;
+	}
+	hull.resize(2 * points.size());
+	for (size_t i = 0; i < points.size(); i++) {
+		while (k >= 2 && Orientation(*hull[k - 2], *hull[k - 1], *points[i])
+				< 0)
+			k--;
+		hull[k++] = points[i];
+	}
+	for (size_t i = points.size() - 1, t = k + 1; i > 0; i--) {
+		while (k >= t && Orientation(*hull[k - 2], *hull[k - 1],
+				*points[i - 1]) < 0)
+			k--;
+		hull[k++] = points[i - 1];
+	}
+	hull.resize(k > 1 ? k - 1 : k);
+}
+
+static std::pair<int, int> SitePair(int a, int b)
+{
+	return a < b ? std::make_pair(a, b) : std::make_pair(b, a);
+}
+
+StripEngine::StripEngine(unsigned int threads) :
+		_grid(new SiteGrid()), _halo(0), _give_up(false)
+{
+	if (threads == 0)
+		threads = std::thread::hardware_concurrency();
+	if (threads == 0)
+		threads = 1;
+	for (unsigned int i = 0; i < threads; i++)
+		_strips.push_back(new Strip());
+}
+
+StripEngine::~StripEngine()
+{
+	for (size_t i = 0; i < _strips.size(); i++)
+		delete _strips[i];
+	delete _grid;
+}
+
+void StripEngine::Compute(Span<const Point> sites, VoronoiDCEL& out)
+{
+	size_t count = _strips.size();
+	std::vector<double> sample;
+
+	_sites = sites;
+	_stats = StripStats();
+	_stats.strips = count;
+	out.Clear();
+	if (sites.empty())
+		return;
+
+	_box.Clear();
+	for (size_t i = 0; i < sites.size(); i++)
+		_box.Extend(sites[i]);
+
+	size_t step = std::max<size_t>(sites.size() / (kSamplesPerStrip * count),
+			1);
+	for (size_t i = 0; i < sites.size(); i += step)
+		sample.push_back(sites[i].x());
+	std::sort(sample.begin(), sample.end());
+	_cuts.clear();
+	for (size_t i = 1; i < count; i++)
+		_cuts.push_back(sample[i * sample.size() / count]);
+	for (size_t s = 0; s < count; s++)
+		_strips[s]->own.clear();
+	for (size_t i = 0; i < sites.size(); i++)
+		_strips[StripOf(sites[i].x())]->own.push_back(i);
+
+	/* Start with a few times the mean distance between sites. */
+	double width = _box.max_x() - _box.min_x();
+	double height = _box.max_y() - _box.min_y();
+	_halo = 4 * std::sqrt(width * height / sites.size());
+	if (!(_halo > 0))
+		_halo = std::max(std::max(width, height), 1.0) / sites.size();
+
+	RunOnStrips(&StripEngine::FindHull);
+
+	/* The hull of all sites is the hull of the strip hulls. */
+	std::vector<const Point*> points, hull;
+	for (size_t s = 0; s < count; s++)
+		for (size_t i = 0; i < _strips[s]->hull.size(); i++)
+			points.push_back(&sites[_strips[s]->hull[i]]);
+	ConvexHull(points, hull);
+	_hull_edges.clear();
+	_hull_sites.clear();
+	for (size_t i = 0; i < hull.size(); i++) {
+		int a = hull[i] - sites.data();
+		int b = hull[(i + 1) % hull.size()] - sites.data();
+		_hull_sites.push_back(a);
+		if (a != b)
+			_hull_edges.push_back(SitePair(a, b));
+	}
+	std::sort(_hull_edges.begin(), _hull_edges.end());
+	_hull_edges.erase(std::unique(_hull_edges.begin(), _hull_edges.end()),
+			_hull_edges.end());
+	std::sort(_hull_sites.begin(), _hull_sites.end());
+	_hull_sites.erase(std::unique(_hull_sites.begin(), _hull_sites.end()),
+			_hull_sites.end());
+
+	_grid->Build(sites, _box);
+
+	_give_up = false;
+	RunOnStrips(&StripEngine::SweepStrip);
+	for (size_t s = 0; s < count; s++) {
+		_stats.sweeps += _strips[s]->sweeps;
+		_stats.halo_sites += _strips[s]->halo_sites;
+	}
+	if (!_give_up && Merge(out))
+		return;
+
+	/* Certifying the strips cost too much, or they disagree. */
+	Engine& engine = _strips[0]->engine;
+	out.Assign(engine.compute(sites));
+	_stats.sweeps++;
+	_stats.sequential = true;
+}
+
+unsigned int StripEngine::threads() const
+{
+	return _strips.size();
+}
+
+const StripStats& StripEngine::stats() const
+{
+	return _stats;
+}
+
+/**
+ * Run |phase| for every strip, one thread each, and rethrow the first
+ * error once all of them are done.
+ */
+void StripEngine::RunOnStrips(Phase phase)
+{
+	std::vector<std::thread> pool;
+
+	for (size_t s = 0; s < _strips.size(); s++)
+		_strips[s]->error = std::exception_ptr();
+	for (size_t s = 1; s < _strips.size(); s++)
+		pool.push_back(std::thread(phase, this, s));
+	(this->*phase)(0);
+	for (size_t i = 0; i < pool.size(); i++)
+		pool[i].join();
+	for (size_t s = 0; s < _strips.size(); s++)
+		if (_strips[s]->error)
+			std::rethrow_exception(_strips[s]->error);
+}
+
+void StripEngine::FindHull(size_t strip)
+{
+	Strip* self = _strips[strip];
+	std::vector<const Point*> hull;
+
+	try {
+		self->core.clear();
+		for (size_t i = 0; i < self->own.size(); i++)
+			self->core.push_back(&_sites[self->own[i]]);
+		ConvexHull(self->core, hull);
+		self->hull.clear();
+		for (size_t i = 0; i < hull.size(); i++)
+			self->hull.push_back(hull[i] - _sites.data());
+	} catch (...) {
+		self->error = std::current_exception();
+	}
+}
+
+/**
+ * Add the sites of |found| that are not swept yet to |extra|.  Returns
+ * false if there were none.
+ */
+static bool AddSites(const std::vector<int>& found, Span<const Point> sites,
+		double low, double high, std::vector<int>& extra)
+{
+	size_t size = extra.size();
+
+	for (size_t i = 0; i < found.size(); i++) {
+		double x = sites[found[i]].x();
+		if ((x < low || x >= high) && !std::binary_search(extra.begin(),
+				extra.begin() + size, found[i]))
+			extra.push_back(found[i]);
+	}
+	if (extra.size() == size)
+		return false;
+	std::sort(extra.begin(), extra.end());
+	extra.erase(std::unique(extra.begin(), extra.end()), extra.end());
+	return true;
+}
+
+/*
+ * Whether the segment from |a| to |b| has points with x in [|low|, |high|).
+ */
+static bool Reaches(const Point& a, const Point& b, double low, double high)
+{
+	return std::max(a.x(), b.x()) >= low && std::min(a.x(), b.x()) < high;
+}
+
+void StripEngine::SweepStrip(size_t strip)
+{
+	Strip* self = _strips[strip];
+	double inf = std::numeric_limits<double>::infinity();
+	double low = strip == 0 ? -inf : _cuts[strip - 1] - _halo;
+	double high = strip + 1 == _strips.size() ? inf : _cuts[strip] + _halo;
+
+	self->sweeps = 0;
+	self->halo_sites = 0;
+	self->owned_edges.clear();
+	self->owned_vertices.clear();
+	if (self->own.empty())
+		return;
+	try {
+		/*
+		 * With the hull edges over the strip in, its rays are rays of the
+		 * diagram.  Hull sites further away have no cell there.
+		 */
+		self->extra.clear();
+		self->missing.clear();
+		for (size_t i = 0; i < _hull_edges.size(); i++) {
+			int a = _hull_edges[i].first, b = _hull_edges[i].second;
+			if (Reaches(_sites[a], _sites[b], low, high)) {
+				self->missing.push_back(a);
+				self->missing.push_back(b);
+			}
+		}
+		if (_hull_edges.empty())
+			self->missing = _hull_sites;
+		AddSites(self->missing, _sites, low, high, self->extra);
+		self->budget = kTestsPerSite * _sites.size() / _strips.size();
+
+		/* The halo only takes sites from the strips it overlaps. */
+		self->local.clear();
+		self->ids.clear();
+		for (size_t s = StripOf(low); s <= StripOf(high); s++) {
+			const std::vector<int>& own = _strips[s]->own;
+			for (size_t i = 0; i < own.size(); i++) {
+				double x = _sites[own[i]].x();
+				if (x >= low && x < high) {
+					self->local.push_back(_sites[own[i]]);
+					self->ids.push_back(own[i]);
+				}
+			}
+		}
+		size_t slab = self->local.size();
+		while (!_give_up) {
+			self->local.resize(slab);
+			self->ids.resize(slab);
+			for (size_t i = 0; i < self->extra.size(); i++) {
+				self->local.push_back(_sites[self->extra[i]]);
+				self->ids.push_back(self->extra[i]);
+			}
+			self->engine.compute(Span<const Point>(self->local));
+			self->sweeps++;
+			self->halo_sites += self->local.size() - self->own.size();
+
+			self->missing.clear();
+			if (KeepEdges(strip, low, high))
+				return;
+			self->owned_edges.clear();
+			self->owned_vertices.clear();
+			/* Out of budget, or wrong with nothing left to add. */
+			if (self->budget == 0 || self->sweeps >= kMaxSweeps
+					|| !AddSites(self->missing, _sites, low, high,
+							self->extra))
+				_give_up = true;
+		}
+	} catch (...) {
+		self->error = std::current_exception();
+	}
+}
+
+/**
+ * Check the edges around the sites of |strip| and keep the ones it owns.
+ * Returns false if any of them is not an edge of the whole diagram, with
+ * the sites that prove it in the strip's |missing| list.
+ */
+bool StripEngine::KeepEdges(size_t strip, double low, double high)
+{
+	Strip* self = _strips[strip];
+	const VoronoiDCEL& diagram = self->engine.diagram();
+	bool everything = low < _box.min_x() && high > _box.max_x();
+	bool right = true;
+
+	for (size_t i = 0; i < diagram.edges().size(); i++) {
+		const DiagramEdge& edge = diagram.edges()[i];
+		int left = self->ids[edge.left_site];
+		int right_site = self->ids[edge.right_site];
+		size_t left_strip = StripOf(_sites[left].x());
+		size_t right_strip = StripOf(_sites[right_site].x());
+
+		if (left_strip != strip && right_strip != strip)
+			continue;
+		if (!everything) {
+			const Point& site = _sites[left];
+			Point ends[2] = { diagram.point(edge.origin),
+					diagram.point(edge.destination) };
+			bool at_infinity[2] = { edge.origin_at_infinity,
+					edge.destination_at_infinity };
+
+			for (int e = 0; e < 2; e++) {
+				if (at_infinity[e]) {
+					if (at_infinity[1 - e] || !isHullEdge(left, right_site))
+						right = false;
+					continue;
+				}
+				double r = std::hypot(ends[e].x() - site.x(),
+						ends[e].y() - site.y());
+				if (ends[e].x() - r > low && ends[e].x() + r < high)
+					continue;
+				size_t found = self->missing.size();
+				if (!FindSitesInCircle(GlobalSites(strip, e == 0
+						? edge.origin : edge.destination), ends[e], r, low,
+						high, &self->budget, self->missing))
+					return false;
+				if (self->missing.size() > found)
+					right = false;
+			}
+		}
+		if (right && std::min(left_strip, right_strip) == strip)
+			self->owned_edges.push_back(i);
+	}
+	if (!right)
+		return false;
+
+	for (size_t i = 0; i < diagram.vertex_count(); i++) {
+		VertexSites sites = GlobalSites(strip, i);
+		size_t owner = std::min(StripOf(_sites[sites.left].x()),
+				std::min(StripOf(_sites[sites.middle].x()),
+						StripOf(_sites[sites.right].x())));
+
+		/* Vertices of the strip's own cells were checked with their edges. */
+		if (owner == strip)
+			self->owned_vertices.push_back(i);
+	}
+	return true;
+}
+
+/**
+ * Append to |found| the sites strictly inside the circle through |sites|,
+ * centered at |center| with about |radius|, but for those with x in
+ * [|low|, |high|), which the strip swept.  Sites on the circle are left
+ * out.  Each site and each cell holding some takes one from |budget|;
+ * returns false if it runs out first, or if another strip gave up.
+ */
+bool StripEngine::FindSitesInCircle(const VertexSites& sites,
+		const Point& center, double radius, double low, double high,
+		size_t* budget, std::vector<int>& found) const
+{
+	const SiteGrid& grid = *_grid;
+	const Point& a = _sites[sites.right];
+	const Point& b = _sites[sites.middle];
+	const Point& c = _sites[sites.left];
+
+	/* The grid only narrows the search; InCircle() decides. */
+	radius *= 1 + 1e-9;
+
+	if (center.y() + radius < _box.min_y() || center.y() - radius > _box.max_y()
+			|| center.x() + radius < _box.min_x()
+			|| center.x() - radius > _box.max_x())
+		return true;
+	size_t last_row = grid.Row(center.y() + radius);
+	for (size_t row = grid.Row(center.y() - radius); row <= last_row; row++) {
+		/* Only the columns the circle reaches within this row. */
+		double bottom = _box.min_y() + row * grid.cell;
+		double top = bottom + grid.cell;
+		double dy = center.y() < bottom ? bottom - center.y()
+				: center.y() > top ? center.y() - top : 0;
+		if (dy > radius)
+			continue;
+		double half = std::sqrt(radius * radius - dy * dy);
+		size_t last = grid.Column(center.x() + half);
+		for (size_t column = grid.Column(center.x() - half); column <= last;
+				column++) {
+			/* Cells all within the strip hold nothing to find. */
+			double left = _box.min_x() + column * grid.cell;
+			if (left >= low && left + grid.cell < high)
+				continue;
+			size_t cell = row * grid.columns + column;
+			if (grid.first[cell] == grid.first[cell + 1])
+				continue;
+			if (*budget == 0 || _give_up)
+				return false;
+			--*budget;
+			for (size_t i = grid.first[cell]; i < grid.first[cell + 1]; i++) {
+				const Point& p = _sites[grid.sites[i]];
+				if (p.x() >= low && p.x() < high)
+					continue;
+				if (*budget == 0)
+					return false;
+				--*budget;
+				if (InCircle(a, b, c, p) > 0)
+					found.push_back(grid.sites[i]);
+			}
+		}
+	}
+	return true;
+}
+
+bool StripEngine::isHullEdge(int a, int b) const
+{
+	return std::binary_search(_hull_edges.begin(), _hull_edges.end(),
+			SitePair(a, b));
+}
+
+size_t StripEngine::StripOf(double x) const
+{
+	return std::upper_bound(_cuts.begin(), _cuts.end(), x) - _cuts.begin();
+}
+
+VertexSites StripEngine::GlobalSites(size_t strip, size_t vertex) const
+{
+	const Strip* self = _strips[strip];
+	const VertexSites& local = self->engine.diagram().vertex_sites()[vertex];
+
+	return VertexSites(self->ids[local.left], self->ids[local.middle],
+			self->ids[local.right]);
+}
+
+/**
+ * Vertex on a seam between strips, keyed by its sites in increasing order.
+ */
+struct SeamVertex {
+	int sites[3];
+	uint32_t index;
+
+	SeamVertex(const VertexSites& vertex, uint32_t index) :
+			index(index)
+	{
+		sites[0] = vertex.left;
+		sites[1] = vertex.middle;
+		sites[2] = vertex.right;
+		std::sort(sites, sites + 3);
+	}
+
+	bool operator<(const SeamVertex& b) const
+	{
+		return std::lexicographical_compare(sites, sites + 3, b.sites,
+				b.sites + 3);
+	}
+};
+
+/**
+ * Append the edges and vertices of every strip to |out|.  An edge owned by
+ * one strip can end at a vertex owned by the next one, which is found by
+ * its sites.  Rays were cut for the box of their own strip, so their open
+ * ends are moved out for the box of the whole diagram, as the sequential
+ * sweep would place them.
+ *
+ * With four or more sites on a circle, strips can pick different vertices
+ * for the same point, and an edge then ends at a vertex no strip owns.
+ * Returns false, with |out| untouched, if that happens.
+ */
+bool StripEngine::Merge(VoronoiDCEL& out)
+{
+	static const uint32_t kNoPoint = -1U;
+	BoundingBox box(_box);
+	std::vector<SeamVertex> seam;
+	uint32_t next = 0;
+
+	/* Vertices first: the ends at infinity follow every one of them. */
+	for (size_t s = 0; s < _strips.size(); s++) {
+		Strip* self = _strips[s];
+		const VoronoiDCEL& diagram = self->engine.diagram();
+		self->merged.assign(diagram.vertex_count(), kNoPoint);
+		for (size_t i = 0; i < self->owned_vertices.size(); i++) {
+			size_t vertex = self->owned_vertices[i];
+			VertexSites sites = GlobalSites(s, vertex);
+			self->merged[vertex] = next++;
+			if (StripOf(_sites[sites.left].x()) != s
+					|| StripOf(_sites[sites.middle].x()) != s
+					|| StripOf(_sites[sites.right].x()) != s)
+				seam.push_back(SeamVertex(sites, self->merged[vertex]));
+		}
+	}
+	std::sort(seam.begin(), seam.end());
+
+	for (size_t s = 0; s < _strips.size(); s++) {
+		Strip* self = _strips[s];
+		const VoronoiDCEL& diagram = self->engine.diagram();
+		for (size_t i = 0; i < self->owned_edges.size(); i++) {
+			const DiagramEdge& edge = diagram.edges()[self->owned_edges[i]];
+			uint32_t ends[2] = { edge.origin, edge.destination };
+			bool at_infinity[2] = { edge.origin_at_infinity,
+					edge.destination_at_infinity };
+			for (int e = 0; e < 2; e++) {
+				if (at_infinity[e] || self->merged[ends[e]] != kNoPoint)
+					continue;
+				SeamVertex key(GlobalSites(s, ends[e]), 0);
+				std::vector<SeamVertex>::const_iterator found =
+						std::lower_bound(seam.begin(), seam.end(), key);
+				if (found == seam.end() || key < *found)
+					return false;
+				self->merged[ends[e]] = found->index;
+			}
+		}
+	}
+
+	for (size_t s = 0; s < _strips.size(); s++) {
+		const Strip* self = _strips[s];
+		const VoronoiDCEL& diagram = self->engine.diagram();
+		for (size_t i = 0; i < self->owned_vertices.size(); i++) {
+			size_t vertex = self->owned_vertices[i];
+			Point at = diagram.point(vertex);
+			box.Extend(at);
+			out.addVertex(at.x(), at.y(), GlobalSites(s, vertex));
+		}
+	}
+
+	for (size_t s = 0; s < _strips.size(); s++) {
+		const Strip* self = _strips[s];
+		const VoronoiDCEL& diagram = self->engine.diagram();
+		for (size_t i = 0; i < self->owned_edges.size(); i++) {
+			const DiagramEdge& edge = diagram.edges()[self->owned_edges[i]];
+			Point o, d;
+			uint32_t origin, destination;
+
+			EdgeEnds(diagram, edge, box, o, d);
+			if (edge.origin_at_infinity)
+				origin = out.addFarPoint(o.x(), o.y());
+			else
+				origin = self->merged[edge.origin];
+			if (edge.destination_at_infinity)
+				destination = out.addFarPoint(d.x(), d.y());
+			else
+				destination = self->merged[edge.destination];
+			out.addEdge(DiagramEdge(origin, destination,
+					self->ids[edge.left_site], self->ids[edge.right_site],
+					edge.origin_at_infinity, edge.destination_at_infinity));
+		}
+	}
+	return true;
+}
+
+}
@@ -0,0 +1,259 @@
+/**
+ *  @file
+ *  @brief Text files of coordinates, as VoronoiDrawer.py reads them.
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <system_error>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <voronoi/text.hh>
+
+namespace voronoi {
+
+const size_t kParallelParseBytes = 1 << 20;
+
+static bool isSpace(char c)
+{
+	return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v'
+			|| c == '\f';
+}
+
+static bool ParsePiece(const char* p, const char* end,
+		std::vector<double>& out)
+{
+	double value;
+
+	while (true) {
+		while (p != end && isSpace(*p))
+			p++;
+		if (p == end)
+			return true;
+		std::from_chars_result parsed = std::from_chars(p, end, value);
+		if (parsed.ec != std::errc() || (parsed.ptr != end
+				&& !isSpace(*parsed.ptr)))
+			return false;
+		out.push_back(value);
+		p = parsed.ptr;
+	}
+}
+
+bool ParseNumbers(const char* begin, const char* end,
+		std::vector<double>& out, unsigned int threads)
+{
+	size_t old_size = out.size();
+	size_t bytes = end - begin;
+
+	if (threads == 0)
+		threads = std::thread::hardware_concurrency();
+	threads = std::max(1u, std::min<unsigned int>(threads,
+			bytes / kParallelParseBytes));
+	if (threads == 1) {
+		/* A guess: coordinates rarely take fewer than eight bytes. */
+		out.reserve(old_size + bytes / 8);
+		if (ParsePiece(begin, end, out))
+			return true;
+		out.resize(old_size);
+		return false;
+	}
+
+	/* Cut after a line end, so no number is split. */
+	std::vector<const char*> cuts(1, begin);
+	for (unsigned int i = 1; i < threads; i++) {
+		const char* cut = std::max(cuts.back(), begin + bytes * i / threads);
+		cut = std::find(cut, end, '\n');
+		cuts.push_back(cut == end ? end : cut + 1);
+	}
+	cuts.push_back(end);
+
+	std::vector<std::vector<double> > pieces(threads);
+	std::vector<char> parsed(threads);
+	std::vector<std::thread> workers;
+	for (unsigned int i = 0; i < threads; i++)
+		workers.push_back(std::thread([&, i]() {
+			pieces[i].reserve((cuts[i + 1] - cuts[i]) / 8);
+			parsed[i] = ParsePiece(cuts[i], cuts[i + 1], pieces[i]);
+		}));
+	for (unsigned int i = 0; i < threads; i++)
+		workers[i].join();
+
+	size_t total = old_size;
+	for (unsigned int i = 0; i < threads; i++) {
+		if (!parsed[i])
+			return false;
+		total += pieces[i].size();
+	}
+	out.reserve(total);
+	for (unsigned int i = 0; i < threads; i++)
+		out.insert(out.end(), pieces[i].begin(), pieces[i].end());
+	return true;
+}
+
+bool ReadNumbers(const char* path, std::vector<double>& out,
+		unsigned int threads)
+{
+	int file = open(path, O_RDONLY);
+	struct stat status;
+
+	if (file < 0)
+		return false;
+	if (fstat(file, &status) != 0) {
+		close(file);
+		return false;
+	}
+	if (status.st_size == 0) {
+		close(file);
+		return true;
+	}
+	void* text = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (text == MAP_FAILED)
+		return false;
+	madvise(text, status.st_size, MADV_SEQUENTIAL);
+	const char* begin = static_cast<const char*>(text);
+	bool parsed = ParseNumbers(begin, begin + status.st_size, out, threads);
+	munmap(text, status.st_size);
+	return parsed;
+}
+
+bool ReadSites(const char* path, std::vector<Point>& sites,
+		unsigned int threads)
+{
+	std::vector<double> numbers;
+
+	if (!ReadNumbers(path, numbers, threads) || numbers.size() % 2 != 0)
+		return false;
+	sites.resize(numbers.size() / 2);
+	for (size_t i = 0; i < sites.size(); i++)
+		sites[i] = Point(numbers[2 * i], numbers[2 * i + 1]);
+	return true;
+}
+
+/*
+ * Formats into a large buffer that goes to the file whenever it fills up.
+ */
+class TextWriter {
+public:
+	explicit TextWriter(const char* path) :
+			_file(fopen(path, "wb")), _buffer(kBufferSize), _used(0),
+			_failed(false)
+	{
+	}
+
+	~TextWriter()
+	{
+		if (_file != NULL)
+			fclose(_file);
+	}
+
+	void Put(double value, char separator)
+	{
+		Reserve();
+		char* at = &_buffer[_used];
+		at = std::to_chars(at, &_buffer[0] + _buffer.size(), value).ptr;
+		*at++ = separator;
+		_used = at - &_buffer[0];
+	}
+
+	void PutCount(size_t count)
+	{
+		Reserve();
+		char* at = &_buffer[_used];
+		at = std::to_chars(at, &_buffer[0] + _buffer.size(), count).ptr;
+		*at++ = '\n';
+		_used = at - &_buffer[0];
+	}
+
+	/**
+	 * Write what is left and close the file.  Returns false if anything
+	 * failed along the way.
+	 */
+	bool Close()
+	{
+		if (_file == NULL)
+			return false;
+		bool written = Flush() && !_failed && ferror(_file) == 0;
+		written = fclose(_file) == 0 && written;
+		_file = NULL;
+		return written;
+	}
+
+private:
+	/* The longest double takes 24 characters. */
+	static const size_t kBufferSize = 1 << 20;
+	static const size_t kLongest = 32;
+
+	void Reserve()
+	{
+		if (_used + kLongest > _buffer.size())
+			Flush();
+	}
+
+	bool Flush()
+	{
+		bool written = _file != NULL
+				&& fwrite(&_buffer[0], 1, _used, _file) == _used;
+		_used = 0;
+		_failed = _failed || !written;
+		return written;
+	}
+
+	FILE* _file;
+	std::vector<char> _buffer;
+	size_t _used;
+	bool _failed; /**< A write failed, even one Close() did not make */
+};
+
+bool WriteNumbers(const char* path, const double* values, size_t count,
+		size_t per_line)
+{
+	TextWriter writer(path);
+
+	for (size_t i = 0; i < count; i++)
+		writer.Put(values[i], i + 1 == count || (i + 1) % per_line == 0
+				? '\n' : ' ');
+	return writer.Close();
+}
+
+bool WriteSites(const char* path, Span<const Point> sites)
+{
+	TextWriter writer(path);
+
+	for (size_t i = 0; i < sites.size(); i++) {
+		writer.Put(sites[i].x(), ' ');
+		writer.Put(sites[i].y(), '\n');
+	}
+	return writer.Close();
+}
+
+bool WriteDrawerFile(const char* path, const VoronoiDCEL& diagram,
+		Span<const Point> sites)
+{
+	TextWriter writer(path);
+	const std::vector<DiagramEdge>& edges = diagram.edges();
+
+	writer.PutCount(edges.size());
+	for (size_t i = 0; i < edges.size(); i++) {
+		Point origin = diagram.point(edges[i].origin);
+		Point destination = diagram.point(edges[i].destination);
+		writer.Put(origin.x(), ' ');
+		writer.Put(origin.y(), ' ');
+		writer.Put(destination.x(), ' ');
+		writer.Put(destination.y(), '\n');
+	}
+	for (size_t i = 0; i < sites.size(); i++) {
+		writer.Put(sites[i].x(), ' ');
+		writer.Put(sites[i].y(), '\n');
+	}
+	return writer.Close();
+}
+
+}
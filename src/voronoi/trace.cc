@@ -0,0 +1,153 @@
+/**
+ *  @file
+ *  @brief 
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <voronoi/trace.hh>
+
+namespace voronoi {
+
+static const char kTraceMagic[8] = { 'V', 'O', 'R', 'T', 'R', 'A', 'C', 'E' };
+static const uint32_t kTraceVersion = 1;
+
+struct TraceHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t record_size;
+	uint64_t count;
+	uint64_t dropped;
+};
+
+thread_local TraceBuffer* current_trace_buffer = NULL;
+
+void SetTraceBuffer(TraceBuffer* buffer)
+{
+	current_trace_buffer = buffer;
+}
+
+TraceBuffer* trace_buffer()
+{
+	return current_trace_buffer;
+}
+
+TraceBuffer::TraceBuffer(size_t capacity) :
+		_written(0)
+{
+	size_t size = 1;
+
+	while (size < capacity)
+		size <<= 1;
+	_records.resize(size);
+	_mask = size - 1;
+}
+
+void TraceBuffer::Clear()
+{
+	_written = 0;
+}
+
+std::vector<TraceRecord> TraceBuffer::records() const
+{
+	uint64_t first = _written > capacity() ? _written - capacity() : 0;
+	std::vector<TraceRecord> out;
+
+	out.reserve(_written - first);
+	for (uint64_t i = first; i < _written; i++)
+		out.push_back(_records[i & _mask]);
+	return out;
+}
+
+size_t TraceBuffer::capacity() const
+{
+	return _records.size();
+}
+
+uint64_t TraceBuffer::dropped() const
+{
+	return _written > capacity() ? _written - capacity() : 0;
+}
+
+bool TraceBuffer::Save(const char* path) const
+{
+	std::vector<TraceRecord> out = records();
+	TraceHeader header;
+	FILE* file = fopen(path, "wb");
+
+	if (file == NULL)
+		return false;
+	memcpy(header.magic, kTraceMagic, sizeof(header.magic));
+	header.version = kTraceVersion;
+	header.record_size = sizeof(TraceRecord);
+	header.count = out.size();
+	header.dropped = dropped();
+
+	bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+	if (ok && !out.empty())
+		ok = fwrite(&out[0], sizeof(TraceRecord), out.size(), file)
+				== out.size();
+	return fclose(file) == 0 && ok;
+}
+
+bool TraceBuffer::Load(const char* path)
+{
+	TraceHeader header;
+	FILE* file = fopen(path, "rb");
+
+	if (file == NULL)
+		return false;
+	bool ok = fread(&header, sizeof(header), 1, file) == 1
+			&& memcmp(header.magic, kTraceMagic, sizeof(kTraceMagic)) == 0
+			&& header.version == kTraceVersion
+			&& header.record_size == sizeof(TraceRecord);
+	if (ok) {
+		std::vector<TraceRecord> in(header.count);
+		if (!in.empty())
+			ok = fread(&in[0], sizeof(TraceRecord), in.size(), file)
+					== in.size();
+		if (ok) {
+			*this = TraceBuffer(in.size());
+			for (size_t i = 0; i < in.size(); i++)
+				_records[i] = in[i];
+			_written = in.size();
+		}
+	}
+	fclose(file);
+	return ok;
+}
+
+std::string TraceBuffer::Format(const TraceRecord& r)
+{
+	std::stringstream ss;
+
+	ss << r.sequence << " ";
+	switch (r.type) {
+	case kTraceSite:
+		ss << "site (" << r.ax << ", " << r.ay << ")";
+		break;
+	case kTraceCircle:
+		ss << "circle event at (" << r.ax << ", " << r.ay
+				<< ") for arc (" << r.bx << ", " << r.by << ")";
+		break;
+	case kTraceFalseAlarm:
+		ss << "false alarm at (" << r.ax << ", " << r.ay << ")";
+		break;
+	case kTraceVertex:
+		ss << "vertex (" << r.ax << ", " << r.ay << ")";
+		break;
+	case kTraceEdge:
+		ss << "edge (" << r.ax << ", " << r.ay << ") -> (" << r.bx << ", "
+				<< r.by << ")";
+		break;
+	default:
+		ss << "unknown record " << r.type;
+	}
+	return ss.str();
+}
+
+}
@@ -6,10 +6,11 @@
  *  @copyright FreeBSD License
  */
 
+#include <cassert>
+#include <cstddef>
 #include <iostream>
-#include <voronoi/diagram.hh>
-#include <voronoi/face.hh>
 #include <voronoi/point.hh>
+#include <voronoi/predicates.hh>
 #include <voronoi/queue.hh>
 #include <voronoi/status.hh>
 #include <voronoi/tree.hh>
@@ -44,67 +45,68 @@ void VoronoiTree::InsertParabola(Point* parabola)
 {
 	Status s(parabola);
 
-	std::cerr << "\033[1m==> InsertParabola(" << s.str() << ")\033[0m\n";
+	if (!EnterSite(parabola))
+		return;
 	if (isEmpty()) {
-		Node* new_root = new Node(s, this);
+		Node* new_root = CreateParabolaNode(parabola);
 		set_root(new_root);
-		new_root->set_color(Node::kBlack);
 		return;
 	}
 	Node* nearest = FindParabola(s);
-
-	std::cerr << "Mais próximo: " << nearest->data()->str() << " (" << nearest
-			<< ")\n";
-
-	if (nearest->data()->hasCircleEvent()) {
-		const Status* data = nearest->data();
-		Point* circle_event = data->circle_event();
-		circle_event->MarkAsFalseAlarm();
-		//nearest->set_data(data);
-		std::cerr << "\033[31;1mEvento de círculo em " << circle_event->str()
-				<< " marcado como falso alarme\n";
+	while (nearest->data()->hasCircleEvent()
+			&& Overdue(parabola, nearest->previous()->previous()->data()->arc,
+					nearest->data(), nearest->next()->next()->data()->arc)) {
+		RemoveParabola(TakeCircleEvent(const_cast<Status*>(
+				nearest->data())));
+		nearest = FindParabola(s);
 	}
-
-	Node* internal_root = CreateBreakpointNode(nearest->data()->arc, s.arc);
-	Node* internal2 = CreateBreakpointNode(s.arc, nearest->data()->arc);
-	Node* leaf_left = CreateParabolaNode(nearest->data()->arc);
-	Node* leaf_middle = CreateParabolaNode(parabola);
-	Node* leaf_right = CreateParabolaNode(nearest->data()->arc);
-	internal_root->set_color(nearest->color());
-
-	if (nearest->isRoot()) {
-		set_root(internal_root);
-	} else {
-		Node* parent = nearest->parent();
-		if (nearest->isLeftChild()) {
-			parent->DetachLeftChild();
-			parent->AttachLeftChild(internal_root);
-		} else {
-			parent->DetachRightChild();
-			parent->AttachRightChild(internal_root);
-		}
+	Point* arc = nearest->data()->arc;
+	Node* before = nearest->previous();
+	Node* after = nearest->next();
+
+	RemoveCircleEvent(const_cast<Status*>(nearest->data()));
+
+	/*
+	 * Only a site of the first row is level with the arc above it.  One a
+	 * rounding error lower splits the arc like any other: the breakpoints
+	 * stay finite.
+	 */
+	if (parabola->y() == arc->y()) {
+		InsertBesideParabola(nearest, parabola);
+		return;
 	}
-	internal_root->InsertRightChild(internal2);
-	internal_root->InsertLeftChild(leaf_left);
-
-	internal2->InsertLeftChild(leaf_middle);
-	internal2->InsertRightChild(leaf_right);
-
-	// Update start edges
-	Point* start = new Point(parabola->x(),
-			nearest->data()->arc->GetYOfParabolaInsersection(parabola));
-
-	Status* ll = const_cast<Status*>(internal2->data());
-	ll->set_start(start);
 
-	Status* lr = const_cast<Status*>(internal_root->data());
-	lr->set_start(start);
-
-	std::cerr << "\033[36;1mAresta começando em " << start->str();
-	std::cerr << " (armazenado em " << ll->str() << " e " << lr->str()
-			<< ")\033[0m\n";
-
-	delete nearest;
+	Node* internal_root = CreateBreakpointNode(arc, s.arc);
+	Node* internal2 = CreateBreakpointNode(s.arc, arc);
+	Node* leaf_left = CreateParabolaNode(arc);
+	Node* leaf_middle = CreateParabolaNode(parabola);
+	Node* leaf_right = CreateParabolaNode(arc);
+
+	/*
+	 * Insert the breakpoints one at a time, each in place of a leaf, so the
+	 * rebalancing only ever sees complete internal nodes.
+	 */
+	Replace(nearest, internal_root);
+	internal_root->AttachLeftChild(leaf_left);
+	internal_root->AttachRightChild(leaf_right);
+	internal_root->PosInsertFixUp();
+
+	Replace(leaf_right, internal2);
+	internal2->AttachLeftChild(leaf_middle);
+	internal2->AttachRightChild(leaf_right);
+	internal2->PosInsertFixUp();
+
+	Link(before, leaf_left);
+	Link(leaf_left, internal_root);
+	Link(internal_root, leaf_middle);
+	Link(leaf_middle, internal2);
+	Link(internal2, leaf_right);
+	Link(leaf_right, after);
+
+	SplitArc(parabola, arc, const_cast<Status*>(internal_root->data()),
+			const_cast<Status*>(internal2->data()));
+
+	DestroyNode(nearest);
 
 	CheckCircle(leaf_left, parabola->y());
 	CheckCircle(leaf_right, parabola->y());
@@ -112,215 +114,194 @@ void VoronoiTree::InsertParabola(Point* parabola)
 	//PrintTree();
 }
 
+/**
+ * Sites on the first row of the sweep have no arc above them to split.  They
+ * come left to right, so the new arc goes right of |nearest|, the last one,
+ * separated by a vertical edge that comes from infinity.
+ */
+void VoronoiTree::InsertBesideParabola(Node* nearest, Point* parabola)
+{
+	Point* arc = nearest->data()->arc;
+	Node* breakpoint = CreateBreakpointNode(arc, parabola);
+	Node* leaf_old = CreateParabolaNode(arc);
+	Node* leaf_new = CreateParabolaNode(parabola);
+
+	assert(nearest->next() == NULL && arc->x() < parabola->x());
+	Replace(nearest, breakpoint);
+	breakpoint->AttachLeftChild(leaf_old);
+	breakpoint->AttachRightChild(leaf_new);
+	breakpoint->PosInsertFixUp();
+	Link(nearest->previous(), leaf_old);
+	Link(leaf_old, breakpoint);
+	Link(breakpoint, leaf_new);
+	DestroyNode(nearest);
+
+	PlaceBeside(const_cast<Status*>(breakpoint->data()));
+
+	CheckCircle(leaf_old, parabola->y());
+}
+
 /**
  * This method should be called only on leaves (parabolas).
  */
 void VoronoiTree::CheckCircle(Node* leaf, double sweepline_y)
 {
-	Node* left_parent = leaf->GetFirstParentAtLeft();
-	Node* right_parent = leaf->GetFirstParentAtRight();
+	Node* left_parent = leaf->previous();
+	Node* right_parent = leaf->next();
 
 	if (left_parent == NULL || right_parent == NULL)
 		return;
 
-	Node* left_neighbor = left_parent->GetPredecessorChild();
-	Node* right_neighbor = right_parent->GetSuccessorChild();
+	Node* left_neighbor = left_parent->previous();
+	Node* right_neighbor = right_parent->next();
 
-	if (left_neighbor == NULL || right_neighbor == NULL)
-		return;
 	if (*left_neighbor->data() == *right_neighbor->data())
 		return;
 
-	Point* a = left_neighbor->data()->arc;
-	Point* b = leaf->data()->arc;
-	Point* c = right_neighbor->data()->arc;
-
-	Point* circle_bottom = new Point();
-	circle_bottom->SetCoordinatesToTheCircleBottom(a, b, c);
-
-	if (circle_bottom->y() >= sweepline_y
-			|| circle_bottom->y() != circle_bottom->y()) {
-		delete circle_bottom;
-		return;
-	}
-
-	Status* data = const_cast<Status*>(leaf->data());
-	data->set_circle_event(circle_bottom);
+	BeachLine::CheckCircle(const_cast<Status*>(leaf->data()), leaf->index(),
+			left_neighbor->data()->arc, right_neighbor->data()->arc,
+			sweepline_y);
+}
 
-	circle_bottom->set_circle_lowest_circle_parabola_node(leaf);
+void VoronoiTree::RemoveParabola(const CircleEvent& taken)
+{
+	CircleEvent event = taken;
+	Node* first = FirstTied(node(event.arc), event);
+
+	if (first != node(event.arc))
+		event = Postpone(event, const_cast<Status*>(node(event.arc)->data()),
+				const_cast<Status*>(first->data()));
+
+	Node* leaf = node(event.arc);
+	Node* left_parent = leaf->previous();
+	Node* right_parent = leaf->next();
+	Node* left_neighbor = left_parent->previous();
+	Node* right_neighbor = right_parent->next();
+
+	/* The event of |leaf| itself was already taken from the queue. */
+	const_cast<Status*>(leaf->data())->set_circle_event_handle(kNoEvent);
+	RemoveCircleEvent(const_cast<Status*>(left_neighbor->data()));
+	RemoveCircleEvent(const_cast<Status*>(right_neighbor->data()));
+
+	/*
+	 * One of the breakpoints around |leaf| is its parent, which goes away
+	 * with it.  The other one now separates the two neighbors and starts a
+	 * new edge at the vertex.
+	 */
+	Node* higher = leaf->parent() == left_parent ? right_parent : left_parent;
+	CloseArc(left_neighbor->data()->arc, leaf->data()->arc,
+			right_neighbor->data()->arc,
+			const_cast<Status*>(left_parent->data()),
+			const_cast<Status*>(right_parent->data()),
+			const_cast<Status*>(higher->data()));
+
+	RemoveLeaf(leaf);
 
-	queue->push(circle_bottom);
+	//PrintTree();
 
-	std::cerr << "\033[1;34mEvento de círculo em " << circle_bottom->str()
-			<< "\033[0m\n";
+	CheckCircle(left_neighbor, event.y);
+	CheckCircle(right_neighbor, event.y);
 }
 
-//static unsigned int getDCELFace(VoronoiDCEL* dcel, const Status* status)
-//{
-//	if (status->hasFace())
-//		return status->face();
-//	if (dcel->getFaces().capacity() == dcel->getFaces().size())
-//		dcel->getFaces().resize(dcel->getFaces().size() + 1);
-//	return dcel->createFace(NULL);
-//}
-//
-//static unsigned int createDCELVertex(VoronoiDCEL* dcel)
-//{
-//	if (dcel->getVertices().capacity() == dcel->getVertices().size())
-//		dcel->getVertices().resize(dcel->getVertices().size() + 1);
-//	return dcel->createVertex();
-//}
-
-void VoronoiTree::RemoveParabola(Point* circle_event)
+/**
+ * Arc to close before |leaf|, whose |event| was just taken, or |leaf|: see
+ * BeachLine::FirstOfTied().
+ */
+Node* VoronoiTree::FirstTied(Node* leaf, const CircleEvent& event)
 {
-	std::cerr << "\033[32;1m==> RemoveParabola(" << circle_event->str()
-			<< ")\033[0m" << std::endl;
-
-	Node* leaf = circle_event->lowest_circle_parabola_node();
-	std::cerr << "Evento de círculo aponta para " << leaf->data()->str() << " ("
-			<< leaf << ")\n";
-
-	Node* left_parent = leaf->GetFirstParentAtLeft();
-	Node* right_parent = leaf->GetFirstParentAtRight();
-	Node* left_neighbor = left_parent->GetPredecessorChild();
-	Node* right_neighbor = right_parent->GetSuccessorChild();
-
-	if (left_neighbor == right_neighbor)
-		std::cerr << "Erro? Parábolas esquerda e direitas são iguais.\n";
-
-	Status* lc = const_cast<Status*>(left_neighbor->data());
-	lc->RemoveCircleEvent();
-
-	Status* rc = const_cast<Status*>(right_neighbor->data());
-	rc->RemoveCircleEvent();
-
-	Node* p = leaf->parent();
-	Status* data = const_cast<Status*>(p->parent()->data());
-	std::cerr << "Breakpoint atualizado de " << p->parent()->data()->str();
-	if (p->isLeftChild()) {
-		if (leaf->isLeftChild())
-			data->i = p->data()->j;
-		else
-			data->i = p->data()->i;
-	} else {
-		if (leaf->isLeftChild())
-			data->j = p->data()->j;
-		else
-			data->j = p->data()->i;
+	Node* first = leaf;
+	Node* last = leaf;
+	Node* arc = leaf;
+
+	if (!queue->hasTied(event))
+		return leaf;
+	for (size_t i = 0; i < kLookAround && arc->previous() != NULL; i++) {
+		arc = arc->previous()->previous();
+		if (IsTied(arc->data(), event))
+			first = arc;
 	}
-	std::cerr << " para " << data->str() << "\n";
-
-	bool is_left = p->isLeftChild();
-	while ((p = p->parent()) != NULL && !p->isRoot()) {
-		Status* data = const_cast<Status*>(p->parent()->data());
-		std::cerr << "-- Breakpoint atualizado de "
-				<< p->parent()->data()->str();
-		if (p->isLeftChild()) {
-			data->i = p->data()->j;
-		} else {
-			data->j = p->data()->i;
-		}
-		std::cerr << " para " << data->str() << "\n";
-		if (p->isLeftChild() != is_left)
-			break;
+	arc = leaf;
+	for (size_t i = 0; i < kLookAround && arc->next() != NULL; i++) {
+		arc = arc->next()->next();
+		if (IsTied(arc->data(), event))
+			last = arc;
 	}
-
-	Point* center = new Point();
-
-	center->SetCoordinatesToTheCircleCenter(left_neighbor->data()->arc,
-			leaf->data()->arc,
-			right_neighbor->data()->arc);
-
-	std::cerr << "\033[35;1mNova aresta: "
-			<< left_parent->data()->start()->str();
-	std::cerr << " ---> " << center->str() << " (" << left_parent
-			<< ")\033[0m\n";
-
-	std::cerr << "\033[35;1mNova aresta: "
-			<< right_parent->data()->start()->str();
-	std::cerr << " ---> " << center->str() << " (" << right_parent
-			<< ")\033[0m\n";
-
-	std::cerr << "\033[33;1mVértice de voronoi no centro do ";
-	std::cerr << "círculo " << left_neighbor->data()->arc->str() << ", "
-			<< leaf->data()->arc->str() << ", "
-			<< right_neighbor->data()->arc->str() << " = " << center->str()
-			<< ", removendo ";
-	std::cerr << leaf->data()->str() << " e " << leaf->parent()->data()->str()
-			<< " " << leaf->parent() << "\033[0m\n";
-
-	std::cerr << "\033[35;1mNova aresta deveria começar aqui.\033[0m\n";
-
-
-	dcel->addVertex(left_parent->data()->start());
-	dcel->addVertex(right_parent->data()->start());
-	dcel->addVertex(center);
-	dcel->addEdge(left_parent->data()->start(), center);
-	dcel->addEdge(right_parent->data()->start(), center);
-
-//	// Adicionar aresta na DCEL
-//	unsigned int face = getDCELFace(dcel, leaf->data());
-//	VoronoiDCEL::Face* fcenter = dcel->getFace(face);
-//
-//	unsigned int left_face = getDCELFace(dcel, left_neighbor->data());
-//	VoronoiDCEL::Face* fleft = dcel->getFace(left_face);
-//
-//	unsigned int right_face = getDCELFace(dcel, right_neighbor->data());
-//	VoronoiDCEL::Face* fright = dcel->getFace(right_face);
-//
-//	unsigned int centervertex = createDCELVertex(dcel);
-//	VoronoiDCEL::Vertex* circlevertex = dcel->getVertex(centervertex);
-//	circlevertex->getData().set_coordinates(center->x(), center->y());
-//
-//	unsigned int v1 = createDCELVertex(dcel), v2 = createDCELVertex(dcel);
-//	VoronoiDCEL::Vertex* leftv = dcel->getVertex(v1);
-//	leftv->getData().set_coordinates(left_parent->data()->start()->x(), left_parent->data()->start()->y());
-//	VoronoiDCEL::Vertex* rightv = dcel->getVertex(v2);
-//	rightv->getData().set_coordinates(right_parent->data()->start()->x(), right_parent->data()->start()->y());
-//
-//	std::cerr << leftv->getData().str() << " -- > " << circlevertex->getData().str() << "\n";
-//	std::cerr << circlevertex->getData().str() << " -- > " << rightv->getData().str() << "\n";
-//
-//	dcel->getHalfEdges().resize(dcel->getHalfEdges().size() + 4);
-//	dcel->createEdge(leftv, fleft, circlevertex, fcenter);
-//	dcel->createEdge(circlevertex, fcenter, rightv, fright);
-//	std::cerr << face << left_face <<  right_face << centervertex << v1 << v2 << std::endl;
-//	std::cerr << dcel->getVertices().size() << std::endl;
-
-	Node* par = leaf;
-	Node* higher = NULL;
-	while (!par->isRoot()) {
-		par = par->parent();
-		if (par == left_parent)
-			higher = left_parent;
-		if (par == right_parent)
-			higher = right_parent;
+	if (first == last)
+		return leaf;
+
+	/* Two more arcs on each side, where there are. */
+	for (int i = 0; i < 2 && first->previous() != NULL; i++)
+		first = first->previous()->previous();
+	for (int i = 0; i < 2 && last->next() != NULL; i++)
+		last = last->next()->next();
+	size_t taken = 0;
+	_tied.clear();
+	for (arc = first; ; arc = arc->next()->next()) {
+		if (arc == leaf)
+			taken = _tied.size();
+		TiedArc tied = { arc->data()->arc, arc == leaf
+				|| IsTied(arc->data(), event) };
+		_tied.push_back(tied);
+		if (arc == last)
+			break;
 	}
-	Status* gpstat = const_cast<Status*>(higher->data());
-	gpstat->set_start(center);
 
-	//delete leaf->data()->start();
-	leaf->SelfDelete();
-	leaf->parent()->SelfDelete();
-	delete leaf->parent();
-	delete leaf;
+	size_t k = FirstOfTied(taken);
+	for (arc = first; k > 0; k--)
+		arc = arc->next()->next();
+	return arc;
+}
 
-	//PrintTree();
+/**
+ * Whether |event| comes before |site|, which the queue could not tell.
+ */
+bool VoronoiTree::EventFirst(const CircleEvent& event,
+		const Point* site) const
+{
+	Node* leaf = node(event.arc);
 
-	CheckCircle(left_neighbor, circle_event->y());
-	CheckCircle(right_neighbor, circle_event->y());
+	return CircleAbove(*leaf->previous()->previous()->data()->arc,
+			*leaf->data()->arc, *leaf->next()->next()->data()->arc,
+			site->y());
 }
 
 void VoronoiTree::FinishEdges()
 {
-	Node* n = root();
+	FinishUpwardEdges();
+	InternalFinishEdges(root());
+	FinishMesh();
+}
 
-	Point* end = new Point(n->data()->start()->x(),
-			n->data()->i->GetYOfParabolaInsersection(n->data()->j));
+void VoronoiTree::Sweep()
+{
+	while (!queue->empty()) {
+		queue->tiedWithSite(_tied_events);
+		size_t first = 0;
+		while (first < _tied_events.size() && !EventFirst(queue->event(
+				_tied_events[first]), queue->site()))
+			first++;
+		if (first < _tied_events.size()) {
+			CircleEvent event = queue->event(_tied_events[first]);
+			queue->erase(_tied_events[first]);
+			RemoveParabola(event);
+		} else if (!_tied_events.empty() || queue->isSiteNext()) {
+			Point* site = queue->site();
+			queue->popSite();
+			InsertParabola(site);
+		} else {
+			/* The queue reuses the event storage on the next push. */
+			CircleEvent event = queue->circle();
+			queue->pop();
+			RemoveParabola(event);
+		}
+	}
+	FinishEdges();
+}
 
-	dcel->addVertex(n->data()->start());
-	dcel->addVertex(end);
-	dcel->addEdge(n->data()->start(), end);
+void VoronoiTree::Reset()
+{
+	Clear();
+	ResetEdges();
 }
 
 void VoronoiTree::PrintTree()
@@ -329,32 +310,55 @@ void VoronoiTree::PrintTree()
 	std::cout << " . ";
 }
 
+void VoronoiTree::CompactDiagram(std::vector<uint32_t>& kept)
+{
+	std::vector<uint32_t> renumber(dcel->vertex_count(), kNoVertex);
+	Node* top = root();
+
+	for (Node* p = top; p != NULL; p = p->NextPreOrder(top))
+		if (!p->isLeaf() && p->data()->start() != kNoVertex)
+			renumber[p->data()->start()] = 0;
+	CompactVertices(renumber, kept);
+	for (Node* p = top; p != NULL; p = p->NextPreOrder(top)) {
+		Status* data = const_cast<Status*>(p->data());
+		if (!p->isLeaf() && data->start() != kNoVertex)
+			data->set_start(renumber[data->start()]);
+	}
+}
+
+const Point* VoronoiTree::ArcAbove(const Point* site) const
+{
+	Status s(const_cast<Point*>(site));
+
+	if (isEmpty())
+		return NULL;
+	return FindParabola(s)->data()->arc;
+}
+
 Node* VoronoiTree::CreateBreakpointNode(Point* i, Point* j)
 {
 	Status status(i, j);
-	return new Node(status, this);
+	return CreateNode(status);
 }
 
 Node* VoronoiTree::CreateParabolaNode(Point* parabola)
 {
 	Status status(parabola);
-	return new Node(status, this);
+	Node* leaf = CreateNode(status);
+
+	/* Leaves stand for the black NIL nodes of the red-black tree. */
+	leaf->set_color(Node::kBlack);
+	return leaf;
 }
 
+/**
+ * Breakpoints still in the tree trace edges that never end.
+ */
 void VoronoiTree::InternalFinishEdges(Node* node)
 {
-	if (node == NULL || node->isLeaf())
-		return;
-
-	Point* end = new Point(node->data()->start()->x(),
-			node->data()->i->GetYOfParabolaInsersection(node->data()->j));
-
-	dcel->addVertex(node->data()->start());
-	dcel->addVertex(end);
-	dcel->addEdge(node->data()->start(), end);
-
-	InternalFinishEdges(node->left_child());
-	InternalFinishEdges(node->right_child());
+	for (Node* p = node; p != NULL; p = p->NextPreOrder(node))
+		if (!p->isLeaf())
+			FinishBreakpoint(p->data());
 }
 
 }
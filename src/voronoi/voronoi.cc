@@ -5,31 +5,18 @@ namespace voronoi {
 
 Voronoi::Voronoi(std::vector<Point*>& points) :
 		sites(points.begin(), points.end()),
-		queue(sites),
 		tree(&queue, &dcel)
 {
-	while (!queue.empty()) {
-		Point* p = queue.top();
-		queue.pop();
-
-		if (p->isCircleEvent())
-			HandleCircleEvent(p);
-		else
-			HandleSiteEvent(p);
-	}
-	tree.FinishEdges();
-}
-
-void Voronoi::HandleSiteEvent(Point* p)
-{
-	tree.InsertParabola(p);
-}
-
-void Voronoi::HandleCircleEvent(Point* p)
-{
-	if (!p->isFalseAlarm())
-		tree.RemoveParabola(p);
-	delete p;
+	std::vector<Point*> pointers;
+
+	/* The sweep tells the sites apart by their offset in one array. */
+	for (size_t i = 0; i < sites.size(); i++)
+		site_copies.push_back(*sites[i]);
+	for (size_t i = 0; i < site_copies.size(); i++)
+		pointers.push_back(&site_copies[i]);
+	queue.Reset(pointers);
+	tree.set_sites(site_copies.data());
+	tree.Sweep();
 }
 
 
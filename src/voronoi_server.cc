@@ -0,0 +1,58 @@
+/**
+ *  @file
+ *  @brief Serve diagrams on a UNIX socket until SIGINT or SIGTERM.
+ *  @date 18/10/2026
+ *  @author Paulo Urio
+ *  @copyright FreeBSD License
+ */
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <pthread.h>
+#include <voronoi/server.hh>
+
+static void Serve(voronoi::DiagramServer* server)
+{
+	server->Run();
+}
+
+int main(int argc, char** argv)
+{
+	using namespace voronoi;
+
+	if (argc < 2 || argc > 6) {
+		std::cerr << "Usage: " << argv[0] << " <socket> [threads]"
+				<< " [batch window in us] [max sites] [max connections]"
+				<< std::endl;
+		return 2;
+	}
+
+	/* Every thread inherits the mask; only sigwait() below sees them. */
+	sigset_t signals;
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+	DiagramServer server(argc > 2 ? atoi(argv[2]) : 0,
+			argc > 3 ? atoi(argv[3]) : 100,
+			argc > 4 ? atol(argv[4]) : DiagramServer::kDefaultMaxSites,
+			argc > 5 ? atol(argv[5]) : DiagramServer::kDefaultMaxConnections);
+	if (!server.Listen(argv[1])) {
+		std::cerr << argv[1] << ": cannot listen" << std::endl;
+		return 1;
+	}
+	std::thread serving(Serve, &server);
+
+	int received;
+	sigwait(&signals, &received);
+	server.Stop();
+	serving.join();
+
+	ServerStats stats = server.stats();
+	std::cerr << stats.requests << " requests in " << stats.batches
+			<< " batches, largest " << stats.largest_batch << ", "
+			<< stats.refused << " connections refused" << std::endl;
+	return 0;
+}
@@ -0,0 +1,82 @@
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <voronoi/voronoi.hh>
+
+using voronoi::BatchEngine;
+using voronoi::Engine;
+using voronoi::Point;
+using voronoi::Span;
+using voronoi::VoronoiDCEL;
+
+static std::vector<std::vector<Point> > RandomInputs(size_t count)
+{
+	std::vector<std::vector<Point> > inputs(count);
+
+	srand(3);
+	for (size_t i = 0; i < count; i++) {
+		size_t sites = 2 + rand() % 200;
+		for (size_t j = 0; j < sites; j++)
+			inputs[i].push_back(Point(rand() / (RAND_MAX / 1000.0),
+					rand() / (RAND_MAX / 1000.0)));
+	}
+	return inputs;
+}
+
+static void ExpectSameEdges(const VoronoiDCEL& a, const VoronoiDCEL& b)
+{
+	ASSERT_EQ(a.edges().size(), b.edges().size());
+	for (size_t i = 0; i < a.edges().size(); i++) {
+		EXPECT_EQ(a.edges()[i].origin, b.edges()[i].origin)
+				<< "Edge " << i << " starts elsewhere.";
+		EXPECT_EQ(a.edges()[i].destination, b.edges()[i].destination)
+				<< "Edge " << i << " ends elsewhere.";
+	}
+	/* Same bits, so that runs producing NaN still compare equal. */
+	ASSERT_EQ(a.coordinates().size(), b.coordinates().size());
+	EXPECT_EQ(0, memcmp(a.coordinates().data(), b.coordinates().data(),
+			a.coordinates().size() * sizeof(double)));
+}
+
+TEST(BatchCheckTest, MatchesSequentialRuns)
+{
+	LOG(INFO) << "Starting batch check test.";
+	std::vector<std::vector<Point> > inputs = RandomInputs(300);
+	std::vector<VoronoiDCEL> outputs;
+	Engine engine;
+
+	voronoi::ComputeBatch(inputs, outputs, 4);
+	ASSERT_EQ(inputs.size(), outputs.size());
+	for (size_t i = 0; i < inputs.size(); i++) {
+		engine.compute(Span<const Point>(inputs[i]));
+		ExpectSameEdges(engine.diagram(), outputs[i]);
+	}
+	LOG(INFO) << "Finishing batch check test.";
+}
+
+TEST(BatchCheckTest, ReusesOutputs)
+{
+	LOG(INFO) << "Starting batch reuse check test.";
+	std::vector<std::vector<Point> > inputs = RandomInputs(50);
+	std::vector<Span<const Point> > spans(inputs.begin(), inputs.end());
+	std::vector<VoronoiDCEL> first, second;
+	BatchEngine batch(3);
+
+	EXPECT_EQ(3U, batch.threads());
+	batch.Compute(spans, first);
+	batch.Compute(spans, second);
+	batch.Compute(spans, second);
+	ASSERT_EQ(first.size(), second.size());
+	for (size_t i = 0; i < first.size(); i++)
+		ExpectSameEdges(first[i], second[i]);
+
+	spans.clear();
+	batch.Compute(spans, second);
+	EXPECT_TRUE(second.empty());
+	LOG(INFO) << "Finishing batch reuse check test.";
+}
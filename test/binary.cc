@@ -0,0 +1,120 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <voronoi/voronoi.hh>
+
+using voronoi::DiagramEdge;
+using voronoi::Engine;
+using voronoi::Point;
+using voronoi::Span;
+using voronoi::VoronoiDCEL;
+
+static std::string ReadFile(const char* path)
+{
+	std::string bytes;
+	char buffer[1 << 16];
+	FILE* file = fopen(path, "rb");
+	size_t read;
+
+	if (file == NULL)
+		return bytes;
+	while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+		bytes.append(buffer, read);
+	fclose(file);
+	return bytes;
+}
+
+TEST(BinaryTest, WritesTheSameFileTwice)
+{
+	LOG(INFO) << "Starting binary diagram file test.";
+	const char* first_path = "binary_check_1.bin";
+	const char* second_path = "binary_check_2.bin";
+	std::vector<Point> sites;
+	Engine engine;
+
+	srand(43);
+	for (int i = 0; i < 3000; i++)
+		sites.push_back(Point(rand() / (RAND_MAX / 1000.0),
+				rand() / (RAND_MAX / 1000.0)));
+	const VoronoiDCEL& diagram = engine.compute(Span<const Point>(sites));
+	std::vector<uint32_t> first;
+	std::vector<int32_t> neighbors;
+	voronoi::FindNeighbors(diagram, sites.size(), first, neighbors);
+
+	ASSERT_TRUE(voronoi::WriteDiagramFile(first_path, diagram, sites.size(),
+			first, neighbors));
+	Engine again;
+	ASSERT_TRUE(voronoi::WriteDiagramFile(second_path,
+			again.compute(Span<const Point>(sites)), sites.size(), first,
+			neighbors));
+	std::string bytes = ReadFile(first_path);
+	EXPECT_EQ(bytes, ReadFile(second_path));
+
+	/* Header, then the arrays in order. */
+	ASSERT_GE(bytes.size(), 8 * sizeof(uint64_t));
+	uint64_t header[8];
+	memcpy(header, bytes.data(), sizeof(header));
+	EXPECT_EQ(0, memcmp(header, voronoi::kDiagramMagic, sizeof(header[0])));
+	EXPECT_EQ(sites.size(), header[1]);
+	EXPECT_EQ(diagram.point_count(), header[2]);
+	EXPECT_EQ(diagram.vertex_count(), header[3]);
+	EXPECT_EQ(diagram.edges().size(), header[4]);
+	EXPECT_EQ(neighbors.size(), header[5]);
+	EXPECT_EQ(0u, header[6]);
+	EXPECT_EQ(0u, header[7]);
+	size_t edges_at = sizeof(header) + header[2] * 2 * sizeof(double)
+			+ header[3] * 3 * sizeof(int32_t);
+	size_t first_at = edges_at + header[4] * 20;
+	size_t neighbors_at = first_at + (header[1] + 1) * sizeof(uint32_t);
+	ASSERT_EQ(neighbors_at + header[5] * sizeof(int32_t), bytes.size());
+
+	const char* p = bytes.data() + edges_at;
+	for (size_t i = 0; i < header[4]; i++, p += 20) {
+		const DiagramEdge& edge = diagram.edges()[i];
+		uint32_t ends[2];
+		int32_t cells[2];
+		memcpy(ends, p, sizeof(ends));
+		memcpy(cells, p + 8, sizeof(cells));
+		ASSERT_EQ(edge.origin, ends[0]);
+		ASSERT_EQ(edge.destination, ends[1]);
+		ASSERT_EQ(edge.left_site, cells[0]);
+		ASSERT_EQ(edge.right_site, cells[1]);
+		ASSERT_EQ(edge.origin_at_infinity, p[16] != 0);
+		ASSERT_EQ(edge.destination_at_infinity, p[17] != 0);
+		ASSERT_EQ(0, p[18]);
+		ASSERT_EQ(0, p[19]);
+	}
+
+	/* Each edge makes its two cells neighbors of each other. */
+	std::vector<uint32_t> read_first(header[1] + 1);
+	std::vector<int32_t> read_neighbors(header[5]);
+	memcpy(read_first.data(), bytes.data() + first_at,
+			read_first.size() * sizeof(uint32_t));
+	memcpy(read_neighbors.data(), bytes.data() + neighbors_at,
+			read_neighbors.size() * sizeof(int32_t));
+	EXPECT_EQ(0u, read_first[0]);
+	EXPECT_EQ(2 * header[4], read_first[header[1]]);
+	for (size_t i = 0; i < diagram.edges().size(); i++) {
+		int left = diagram.edges()[i].left_site;
+		int right = diagram.edges()[i].right_site;
+		EXPECT_THAT(std::vector<int32_t>(
+				read_neighbors.begin() + read_first[left],
+				read_neighbors.begin() + read_first[left + 1]),
+				testing::Contains(right));
+		EXPECT_THAT(std::vector<int32_t>(
+				read_neighbors.begin() + read_first[right],
+				read_neighbors.begin() + read_first[right + 1]),
+				testing::Contains(left));
+	}
+	remove(first_path);
+	remove(second_path);
+	LOG(INFO) << "Finishing binary diagram file test.";
+}
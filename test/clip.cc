@@ -0,0 +1,110 @@
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <voronoi/voronoi.hh>
+
+using voronoi::BoundingBox;
+using voronoi::ClippedDiagram;
+using voronoi::Engine;
+using voronoi::Point;
+using voronoi::Span;
+
+static bool Inside(const BoundingBox& box, const Point& p)
+{
+	return p.x() >= box.min_x() && p.x() <= box.max_x()
+			&& p.y() >= box.min_y() && p.y() <= box.max_y();
+}
+
+static double Cross(const Point& a, const Point& b, const Point& c)
+{
+	return (b.x() - a.x()) * (c.y() - a.y()) - (b.y() - a.y()) * (c.x() - a.x());
+}
+
+/*
+ * Cells must tile the rectangle: convex, counterclockwise, inside it, with
+ * every site inside the rectangle inside its own cell.
+ */
+static void ExpectTiling(const std::vector<Point>& sites,
+		const BoundingBox& box, ClippedDiagram& clipped)
+{
+	Engine engine;
+	double area = 0;
+	double expected = (box.max_x() - box.min_x()) * (box.max_y() - box.min_y());
+
+	clipped.Clip(engine.compute(Span<const Point>(sites)),
+			Span<const Point>(sites), box);
+	for (size_t i = 0; i < clipped.edges().size(); i++) {
+		ASSERT_TRUE(Inside(box, clipped.origin(i))) << "Edge " << i << ".";
+		ASSERT_TRUE(Inside(box, clipped.destination(i))) << "Edge " << i << ".";
+	}
+
+	ASSERT_EQ(sites.size(), clipped.cell_count());
+	for (size_t c = 0; c < clipped.cell_count(); c++) {
+		std::vector<Point> cell = clipped.Cell(c);
+		double tolerance = 1e-9 * expected;
+
+		for (size_t i = 0; i < cell.size(); i++) {
+			const Point& next = cell[(i + 1) % cell.size()];
+			ASSERT_TRUE(Inside(box, cell[i])) << "Cell " << c << ".";
+			ASSERT_GE(Cross(cell[i], next, cell[(i + 2) % cell.size()]),
+					-tolerance) << "Cell " << c << " is not convex.";
+			if (Inside(box, sites[c])) {
+				ASSERT_GE(Cross(cell[i], next, sites[c]), -tolerance)
+						<< "Site " << c << " outside its cell.";
+			}
+		}
+		if (Inside(box, sites[c])) {
+			EXPECT_FALSE(cell.empty()) << "Cell " << c << " is missing.";
+		}
+		area += clipped.CellArea(c);
+	}
+	EXPECT_NEAR(expected, area, 1e-9 * expected);
+}
+
+TEST(ClipCheckTest, RandomSites)
+{
+	LOG(INFO) << "Starting random clip check test.";
+	std::vector<Point> sites;
+	ClippedDiagram clipped;
+
+	srand(11);
+	for (size_t i = 0; i < 1000; i++)
+		sites.push_back(Point(rand() % 100000 / 100.0,
+				rand() % 100000 / 100.0));
+	ExpectTiling(sites, BoundingBox(100, 200, 900, 700), clipped);
+	/* Far wider than the ends at infinity of the sweep: rays must reach. */
+	ExpectTiling(sites, BoundingBox(-1e5, -1e5, 1e5, 1e5), clipped);
+	/* Off to one side, so that only rays and lines cross it. */
+	ExpectTiling(sites, BoundingBox(2000, -50, 3000, 1050), clipped);
+	LOG(INFO) << "Finishing random clip check test.";
+}
+
+TEST(ClipCheckTest, DegenerateSites)
+{
+	LOG(INFO) << "Starting degenerate clip check test.";
+	std::vector<Point> sites;
+	ClippedDiagram clipped;
+
+	/* Axis-parallel edges, some of them on the sides of the rectangle. */
+	for (int y = 0; y < 10; y++)
+		for (int x = 0; x < 10; x++)
+			sites.push_back(Point(x, y));
+	ExpectTiling(sites, BoundingBox(0.5, 0.5, 8.5, 8.5), clipped);
+	for (size_t c = 0; c < sites.size(); c++) {
+		bool inner = sites[c].x() >= 1 && sites[c].x() <= 8
+				&& sites[c].y() >= 1 && sites[c].y() <= 8;
+		EXPECT_NEAR(inner ? 1.0 : 0.0, clipped.CellArea(c), 1e-9);
+	}
+
+	/* Parallel lines only. */
+	sites.clear();
+	for (int i = 0; i < 5; i++)
+		sites.push_back(Point(i * 3, 0));
+	ExpectTiling(sites, BoundingBox(-10, -10, 20, 10), clipped);
+	LOG(INFO) << "Finishing degenerate clip check test.";
+}
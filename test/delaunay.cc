@@ -0,0 +1,73 @@
+#include <cstdlib>
+#include <vector>
+
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <voronoi/voronoi.hh>
+
+using voronoi::DelaunayDCEL;
+using voronoi::Engine;
+using voronoi::Point;
+using voronoi::Span;
+
+static void ExpectDelaunay(const std::vector<Point>& sites, size_t hull)
+{
+	Engine engine;
+	DelaunayDCEL triangulation;
+
+	engine.compute(Span<const Point>(sites));
+	voronoi::BuildDelaunay(engine.diagram(), Span<const Point>(sites),
+			triangulation);
+	ASSERT_NO_THROW(triangulation.checkAllFaces());
+
+	/* A triangulation of n sites with h on the hull. */
+	EXPECT_EQ(sites.size(), triangulation.getNumVertices());
+	EXPECT_EQ(2 * sites.size() - 2 - hull, triangulation.getNumFaces());
+	EXPECT_EQ(3 * sites.size() - 3 - hull,
+			triangulation.getNumHalfEdges() / 2);
+
+	for (size_t f = 0; f < triangulation.getNumFaces(); f++) {
+		DelaunayDCEL::HalfEdge* edge = triangulation.getFace(f)->getBoundary();
+		const Point& a = edge->getOrigin()->getData();
+		const Point& b = edge->getNext()->getOrigin()->getData();
+		const Point& c = edge->getNext()->getNext()->getOrigin()->getData();
+		ASSERT_GT(voronoi::Orientation(a, b, c), 0) << "Face " << f
+				<< " is not ccw.";
+		for (size_t i = 0; i < sites.size(); i++)
+			ASSERT_LE(voronoi::InCircle(a, b, c, sites[i]), 0) << "Site " << i
+					<< " inside the circle of face " << f << ".";
+	}
+}
+
+TEST(DelaunayCheckTest, RandomSites)
+{
+	LOG(INFO) << "Starting random Delaunay check test.";
+	std::vector<Point> sites;
+
+	/* The four corners make the hull. */
+	sites.push_back(Point(0, 0));
+	sites.push_back(Point(1000, 0));
+	sites.push_back(Point(1000, 1000));
+	sites.push_back(Point(0, 1000));
+	srand(7);
+	for (size_t i = 0; i < 400; i++)
+		sites.push_back(Point(1 + rand() % 99800 / 100.0,
+				1 + rand() % 99800 / 100.0));
+	ExpectDelaunay(sites, 4);
+	LOG(INFO) << "Finishing random Delaunay check test.";
+}
+
+TEST(DelaunayCheckTest, GridSites)
+{
+	LOG(INFO) << "Starting grid Delaunay check test.";
+	std::vector<Point> sites;
+
+	/* Every square of the grid has four sites on a circle. */
+	for (int y = 0; y < 12; y++)
+		for (int x = 0; x < 12; x++)
+			sites.push_back(Point(x * 10, y * 10));
+	ExpectDelaunay(sites, 44);
+	LOG(INFO) << "Finishing grid Delaunay check test.";
+}
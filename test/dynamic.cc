@@ -0,0 +1,131 @@
+#include <cstdlib>
+#include <vector>
+
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <voronoi/voronoi.hh>
+
+using voronoi::DynamicDiagram;
+using voronoi::Engine;
+using voronoi::Point;
+using voronoi::Span;
+using voronoi::VoronoiDCEL;
+
+static double frand(double fmin, double fmax)
+{
+	double f = (double) rand() / RAND_MAX;
+	return fmin + f * (fmax - fmin);
+}
+
+/*
+ * Compare |dynamic| with a sweep over its sites.  Its ids are renumbered
+ * first, in order, the way the sweep numbers what is left.
+ */
+static void ExpectSameAsSweep(const DynamicDiagram& dynamic)
+{
+	std::vector<Point> sites;
+	std::vector<int> renumber(dynamic.site_count(), -1);
+	for (size_t i = 0; i < dynamic.site_count(); i++)
+		if (dynamic.has_site(i)) {
+			renumber[i] = sites.size();
+			sites.push_back(dynamic.site(i));
+		}
+
+	VoronoiDCEL exported, renumbered;
+	dynamic.Export(exported);
+	for (size_t i = 0; i < exported.point_count(); i++) {
+		Point p = exported.point(i);
+		if (i < exported.vertex_count()) {
+			const voronoi::VertexSites& s = exported.vertex_sites()[i];
+			renumbered.addVertex(p.x(), p.y(), voronoi::VertexSites(
+					renumber[s.left], renumber[s.middle], renumber[s.right]));
+		} else {
+			renumbered.addFarPoint(p.x(), p.y());
+		}
+	}
+	for (size_t i = 0; i < exported.edges().size(); i++) {
+		voronoi::DiagramEdge e = exported.edges()[i];
+		e.left_site = renumber[e.left_site];
+		e.right_site = renumber[e.right_site];
+		renumbered.addEdge(e);
+	}
+
+	Engine engine;
+	engine.compute(Span<const Point>(sites));
+	EXPECT_TRUE(voronoi::EquivalentDiagrams(renumbered, engine.diagram(),
+			1e-9));
+}
+
+TEST(DynamicCheckTest, InsertAndRemove)
+{
+	LOG(INFO) << "Starting dynamic diagram check test.";
+	std::vector<Point> sites;
+	DynamicDiagram dynamic;
+
+	srand(23);
+	for (size_t i = 0; i < 1500; i++)
+		sites.push_back(Point(frand(0, 1000), frand(0, 1000)));
+	ASSERT_TRUE(dynamic.Build(Span<const Point>(sites)));
+	ExpectSameAsSweep(dynamic);
+
+	/* Some of them land outside the hull. */
+	for (size_t i = 0; i < 500; i++) {
+		int id = dynamic.InsertSite(Point(frand(-100, 1100),
+				frand(-100, 1100)));
+		ASSERT_EQ((int) (1500 + i), id);
+		ASSERT_FALSE(dynamic.changed_sites().empty());
+	}
+	ExpectSameAsSweep(dynamic);
+
+	for (size_t i = 0; i < 700; i++) {
+		int id = rand() % dynamic.site_count();
+		if (dynamic.has_site(id))
+			ASSERT_TRUE(dynamic.RemoveSite(id));
+		else
+			ASSERT_FALSE(dynamic.RemoveSite(id));
+	}
+	ExpectSameAsSweep(dynamic);
+
+	int live = 0;
+	while (!dynamic.has_site(live))
+		live++;
+	EXPECT_EQ(DynamicDiagram::kNoSite, dynamic.InsertSite(dynamic.site(live)));
+	LOG(INFO) << "Finishing dynamic diagram check test.";
+}
+
+TEST(DynamicCheckTest, HullAndDegenerateCases)
+{
+	LOG(INFO) << "Starting dynamic diagram hull test.";
+	std::vector<Point> sites;
+	DynamicDiagram dynamic;
+
+	sites.push_back(Point(0, 0));
+	sites.push_back(Point(10, 0));
+	EXPECT_FALSE(dynamic.Build(Span<const Point>(sites)));
+	EXPECT_EQ(DynamicDiagram::kNoSite, dynamic.InsertSite(Point(5, 5)));
+
+	sites.push_back(Point(5, 8));
+	ASSERT_TRUE(dynamic.Build(Span<const Point>(sites)));
+	EXPECT_EQ(DynamicDiagram::kNoSite, dynamic.InsertSite(Point(10, 0)));
+
+	/* On a hull side, then beyond it, then on its line past the end. */
+	EXPECT_EQ(3, dynamic.InsertSite(Point(5, 0)));
+	EXPECT_EQ(4, dynamic.InsertSite(Point(5, -7)));
+	EXPECT_EQ(5, dynamic.InsertSite(Point(20, 0)));
+	ExpectSameAsSweep(dynamic);
+
+	EXPECT_TRUE(dynamic.RemoveSite(4));
+	EXPECT_FALSE(dynamic.RemoveSite(4));
+	ExpectSameAsSweep(dynamic);
+
+	/* Only (0, 0), (5, 0), (10, 0) and (20, 0) would be left. */
+	EXPECT_FALSE(dynamic.RemoveSite(2));
+	EXPECT_EQ(6, dynamic.InsertSite(Point(7, 3)));
+	EXPECT_TRUE(dynamic.RemoveSite(2));
+	EXPECT_FALSE(dynamic.RemoveSite(6));
+	EXPECT_TRUE(dynamic.RemoveSite(0));
+	ExpectSameAsSweep(dynamic);
+	LOG(INFO) << "Finishing dynamic diagram hull test.";
+}
@@ -0,0 +1,274 @@
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <voronoi/voronoi.hh>
+
+using voronoi::Engine;
+using voronoi::Point;
+using voronoi::Span;
+using voronoi::VoronoiDCEL;
+
+/* Count heap allocations made by this test binary. */
+static size_t allocations = 0;
+
+void* operator new(size_t size)
+{
+	allocations++;
+	void* p = malloc(size == 0 ? 1 : size);
+	if (p == NULL)
+		throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	free(p);
+}
+
+static std::vector<Point> RandomSites(size_t count, unsigned int seed)
+{
+	std::vector<Point> sites;
+
+	srand(seed);
+	for (size_t i = 0; i < count; i++)
+		sites.push_back(Point(rand() % 10000 / 10.0, rand() % 10000 / 10.0));
+	return sites;
+}
+
+static void ExpectSameDiagram(const VoronoiDCEL& a, const VoronoiDCEL& b)
+{
+	ASSERT_EQ(a.edges().size(), b.edges().size());
+	for (size_t i = 0; i < a.edges().size(); i++) {
+		EXPECT_EQ(a.edges()[i].origin, b.edges()[i].origin);
+		EXPECT_EQ(a.edges()[i].destination, b.edges()[i].destination);
+	}
+	EXPECT_EQ(a.coordinates(), b.coordinates());
+}
+
+/*
+ * Count the vertices of |diagram| that are not clockwise or whose circle
+ * holds a site, with exact predicates.
+ */
+static size_t BadVertices(const VoronoiDCEL& diagram,
+		const std::vector<Point>& sites)
+{
+	size_t bad = 0;
+
+	for (size_t v = 0; v < diagram.vertex_count(); v++) {
+		voronoi::VertexSites vertex = diagram.vertex_sites()[v];
+		const Point& a = sites[vertex.left];
+		const Point& b = sites[vertex.middle];
+		const Point& c = sites[vertex.right];
+		if (voronoi::Orientation(a, b, c) >= 0) {
+			bad++;
+			continue;
+		}
+		for (size_t i = 0; i < sites.size(); i++) {
+			if (sites[i] == a || sites[i] == b || sites[i] == c)
+				continue;
+			if (voronoi::InCircle(c, b, a, sites[i]) > 0) {
+				bad++;
+				break;
+			}
+		}
+	}
+	return bad;
+}
+
+static bool HasEdge(const VoronoiDCEL& diagram, int a, int b)
+{
+	for (size_t i = 0; i < diagram.edges().size(); i++) {
+		const voronoi::DiagramEdge& edge = diagram.edges()[i];
+		if ((edge.left_site == a && edge.right_site == b)
+				|| (edge.left_site == b && edge.right_site == a))
+			return true;
+	}
+	return false;
+}
+
+/*
+ * Sites of a small lattice, exact copies among them, some moved by one
+ * unit in the last place.
+ */
+static std::vector<Point> NudgedLattice(unsigned int seed)
+{
+	std::vector<Point> sites;
+
+	srand(seed);
+	for (int i = 0; i < 60; i++) {
+		double x = rand() % 8 + 1, y = rand() % 8 + 1;
+		int nudge = rand() % 4;
+		if (nudge == 1)
+			x = std::nextafter(x, rand() % 2 ? 0 : 1e9);
+		else if (nudge == 2)
+			y = std::nextafter(y, rand() % 2 ? 0 : 1e9);
+		sites.push_back(Point(x, y));
+	}
+	return sites;
+}
+
+template <class Backend>
+static void ExpectNearlyLevelSites()
+{
+	/* The third site splits the first arc an ulp below the first row. */
+	std::vector<Point> sites;
+	sites.push_back(Point(0, 1));
+	sites.push_back(Point(2, 1));
+	sites.push_back(Point(1, std::nextafter(1.0, 0.0)));
+	voronoi::BasicEngine<Backend> engine;
+
+	const VoronoiDCEL& diagram = engine.compute(Span<const Point>(sites));
+	EXPECT_TRUE(HasEdge(diagram, 0, 1));
+	EXPECT_TRUE(HasEdge(diagram, 0, 2));
+	EXPECT_TRUE(HasEdge(diagram, 1, 2));
+	EXPECT_EQ(0U, BadVertices(diagram, sites));
+}
+
+template <class Backend>
+static void ExpectEmptyCircles()
+{
+	voronoi::BasicEngine<Backend> engine;
+
+	for (unsigned int seed = 0; seed < 200; seed++) {
+		std::vector<Point> sites = NudgedLattice(seed);
+		EXPECT_EQ(0U, BadVertices(engine.compute(Span<const Point>(sites)),
+				sites)) << "Seed " << seed << ".";
+	}
+
+	/* A copy of every site changes nothing. */
+	std::vector<Point> sites = RandomSites(500, 3);
+	std::vector<Point> doubled(sites);
+	doubled.insert(doubled.end(), sites.begin(), sites.end());
+	size_t vertices = engine.compute(Span<const Point>(sites)).vertex_count();
+	const VoronoiDCEL& diagram = engine.compute(Span<const Point>(doubled));
+	EXPECT_EQ(vertices, diagram.vertex_count());
+	EXPECT_EQ(0U, BadVertices(diagram, doubled));
+}
+
+TEST(EngineCheckTest, RunsAreRepeatable)
+{
+	LOG(INFO) << "Starting engine repeatability check test.";
+	std::vector<Point> sites = RandomSites(500, 7);
+	Engine engine;
+
+	VoronoiDCEL first;
+	engine.compute(Span<const Point>(sites));
+	EXPECT_FALSE(engine.diagram().edges().empty());
+	EXPECT_EQ(500U, engine.stats().sites);
+	first = engine.TakeDiagram();
+	EXPECT_TRUE(engine.diagram().edges().empty());
+
+	engine.compute(Span<const Point>(sites));
+	ExpectSameDiagram(first, engine.diagram());
+
+	engine.reset();
+	EXPECT_TRUE(engine.diagram().edges().empty());
+	engine.Recycle(std::move(first));
+	engine.compute(Span<const Point>(sites));
+	EXPECT_FALSE(engine.diagram().edges().empty());
+	LOG(INFO) << "Finishing engine repeatability check test.";
+}
+
+TEST(EngineCheckTest, SteadyStateDoesNotAllocate)
+{
+	LOG(INFO) << "Starting engine allocation check test.";
+	std::vector<Point> sites = RandomSites(2000, 11);
+	Engine engine;
+
+	engine.reserve(sites.size());
+	engine.compute(Span<const Point>(sites));
+
+	size_t before = allocations;
+	for (int i = 0; i < 5; i++)
+		engine.compute(Span<const Point>(sites));
+	EXPECT_EQ(before, allocations) << "Warm runs must reuse the buffers.";
+	LOG(INFO) << "Finishing engine allocation check test.";
+}
+
+TEST(EngineCheckTest, FloatCopyKeepsTopology)
+{
+	LOG(INFO) << "Starting float diagram check test.";
+	std::vector<Point> sites = RandomSites(500, 13);
+	Engine engine;
+	voronoi::FloatCopyDCEL narrow;
+
+	const VoronoiDCEL& diagram = engine.compute(Span<const Point>(sites));
+	narrow.Assign(diagram);
+	ASSERT_EQ(diagram.edges().size(), narrow.edges().size());
+	for (size_t i = 0; i < diagram.edges().size(); i++) {
+		EXPECT_EQ(diagram.edges()[i].origin, narrow.edges()[i].origin);
+		EXPECT_EQ(diagram.edges()[i].left_site, narrow.edges()[i].left_site);
+	}
+	EXPECT_EQ(diagram.vertex_count(), narrow.vertex_count());
+	ASSERT_EQ(diagram.point_count(), narrow.point_count());
+	for (size_t i = 0; i < diagram.point_count(); i++) {
+		EXPECT_FLOAT_EQ(diagram.point(i).x(), narrow.point(i).x());
+		EXPECT_FLOAT_EQ(diagram.point(i).y(), narrow.point(i).y());
+	}
+	EXPECT_EQ(diagram.coordinates().size() * sizeof(float),
+			narrow.coordinates().size() * sizeof(double) / 2);
+	LOG(INFO) << "Finishing float diagram check test.";
+}
+
+TEST(EngineCheckTest, FlatBackendMatchesTree)
+{
+	LOG(INFO) << "Starting flat beach line check test.";
+	std::vector<Point> sites = RandomSites(2000, 17);
+	std::vector<Point> row, column;
+	Engine engine;
+	voronoi::FlatEngine flat;
+
+	EXPECT_TRUE(voronoi::EquivalentDiagrams(engine.compute(Span<const Point>(
+			sites)), flat.compute(Span<const Point>(sites)), 1e-9));
+	EXPECT_EQ(engine.stats().circle_events, flat.stats().circle_events);
+
+	/* The first row is all there is: every arc goes in beside another. */
+	for (int x = 0; x < 20; x++) {
+		row.push_back(Point(x * 10, 5));
+		column.push_back(Point(5, x * 10));
+	}
+	EXPECT_TRUE(voronoi::EquivalentDiagrams(engine.compute(Span<const Point>(
+			row)), flat.compute(Span<const Point>(row)), 1e-9));
+	EXPECT_TRUE(voronoi::EquivalentDiagrams(engine.compute(Span<const Point>(
+			column)), flat.compute(Span<const Point>(column)), 1e-9));
+	LOG(INFO) << "Finishing flat beach line check test.";
+}
+
+TEST(EngineCheckTest, NearlyLevelSites)
+{
+	LOG(INFO) << "Starting nearly level sites check test.";
+	ExpectNearlyLevelSites<voronoi::VoronoiTree>();
+	LOG(INFO) << "Finishing nearly level sites check test.";
+}
+
+TEST(EngineCheckTest, DuplicateSitesKeepCirclesEmpty)
+{
+	LOG(INFO) << "Starting duplicate sites check test.";
+	ExpectEmptyCircles<voronoi::VoronoiTree>();
+	LOG(INFO) << "Finishing duplicate sites check test.";
+}
+
+TEST(EngineCheckTest, FlatNearlyLevelSites)
+{
+	LOG(INFO) << "Starting flat nearly level sites check test.";
+	ExpectNearlyLevelSites<voronoi::FlatBeachLine>();
+	LOG(INFO) << "Finishing flat nearly level sites check test.";
+}
+
+TEST(EngineCheckTest, FlatDuplicateSitesKeepCirclesEmpty)
+{
+	LOG(INFO) << "Starting flat duplicate sites check test.";
+	ExpectEmptyCircles<voronoi::FlatBeachLine>();
+	LOG(INFO) << "Finishing flat duplicate sites check test.";
+}
@@ -0,0 +1,85 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <voronoi/voronoi.hh>
+
+using voronoi::BoundingBox;
+using voronoi::ClippedDiagram;
+using voronoi::Engine;
+using voronoi::Point;
+using voronoi::Span;
+
+static double frand(double fmin, double fmax)
+{
+	double f = (double) rand() / RAND_MAX;
+	return fmin + f * (fmax - fmin);
+}
+
+static std::string ReadFile(const char* path)
+{
+	std::ifstream file(path, std::ios::binary);
+	std::stringstream text;
+	text << file.rdbuf();
+	return text.str();
+}
+
+static size_t Count(const std::string& text, const std::string& word)
+{
+	size_t count = 0;
+	for (size_t at = text.find(word); at != std::string::npos;
+			at = text.find(word, at + 1))
+		count++;
+	return count;
+}
+
+TEST(ExportTest, SameOnAnyNumberOfThreads)
+{
+	LOG(INFO) << "Starting export test.";
+	const char* path = "export_check.txt";
+	std::vector<Point> sites;
+	Engine engine;
+	ClippedDiagram clipped;
+	BoundingBox box(0, 0, 1000, 1000);
+
+	/* Several rounds of chunks, and sites whose cells miss the box. */
+	srand(43);
+	for (size_t i = 0; i < 3 * voronoi::kExportChunk; i++)
+		sites.push_back(Point(frand(-100, 1100), frand(-100, 1100)));
+	engine.compute(Span<const Point>(sites));
+	clipped.Clip(engine.diagram(), Span<const Point>(sites), box);
+
+	size_t cells = 0;
+	for (size_t i = 0; i < clipped.cell_count(); i++)
+		if (clipped.cell_offsets()[i] != clipped.cell_offsets()[i + 1])
+			cells++;
+	ASSERT_LT(cells, sites.size());
+
+	ASSERT_TRUE(voronoi::WriteGeoJson(path, clipped, 1));
+	std::string single = ReadFile(path);
+	ASSERT_TRUE(voronoi::WriteGeoJson(path, clipped, 3));
+	EXPECT_EQ(single, ReadFile(path));
+	EXPECT_EQ(0u, single.find("{\"type\":\"FeatureCollection\",\"features\":"
+			"[\n{\"type\":\"Feature\""));
+	EXPECT_EQ(cells, Count(single, "\"Feature\""));
+	EXPECT_EQ(cells - 1, Count(single, "}}\n,{"));
+
+	ASSERT_TRUE(voronoi::WriteSvg(path, clipped, box,
+			Span<const Point>(sites), 1));
+	single = ReadFile(path);
+	ASSERT_TRUE(voronoi::WriteSvg(path, clipped, box,
+			Span<const Point>(sites), 3));
+	EXPECT_EQ(single, ReadFile(path));
+	EXPECT_EQ(clipped.edges().size(), Count(single, "L"));
+	EXPECT_EQ(sites.size(), Count(single, "h0"));
+	remove(path);
+	EXPECT_FALSE(voronoi::WriteGeoJson("does/not/exist", clipped));
+	LOG(INFO) << "Finishing export test.";
+}
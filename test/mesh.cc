@@ -0,0 +1,112 @@
+#include <cstdlib>
+#include <vector>
+
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <voronoi/voronoi.hh>
+
+using voronoi::Engine;
+using voronoi::HalfEdgeDiagram;
+using voronoi::Point;
+using voronoi::Span;
+
+typedef HalfEdgeDiagram::HalfEdge HalfEdge;
+
+template <class EngineType>
+static void ExpectMesh(const std::vector<Point>& sites)
+{
+	EngineType engine;
+
+	engine.set_build_mesh(true);
+	engine.compute(Span<const Point>(sites));
+	const HalfEdgeDiagram& mesh = engine.mesh();
+	size_t finite = engine.diagram().vertex_count();
+
+	ASSERT_NO_THROW(mesh.checkAllFaces());
+	ASSERT_EQ(sites.size(), mesh.getNumFaces());
+	ASSERT_GE(mesh.getNumVertices(), finite);
+	/* Euler's formula, with the outside as one more face. */
+	EXPECT_EQ(2U, mesh.getNumVertices() + sites.size() + 1
+			- mesh.getNumHalfEdges() / 2);
+	EXPECT_LE(mesh.getNumVertices(), 2 * sites.size());
+	EXPECT_LE(mesh.getNumHalfEdges(), 6 * sites.size());
+
+	for (size_t i = 0; i < finite; i++) {
+		EXPECT_EQ(engine.diagram().point(i).x(),
+				mesh.getVertex(i)->getData().x());
+		EXPECT_EQ(engine.diagram().point(i).y(),
+				mesh.getVertex(i)->getData().y());
+	}
+
+	/* Each site is on the left of every Voronoi edge around its cell. */
+	for (size_t f = 0; f < mesh.getNumFaces(); f++) {
+		const Point& site = sites[f];
+		const HalfEdge* start = mesh.getFaces()[f].getBoundary();
+		const HalfEdge* edge = start;
+		do {
+			if (edge->getTwin()->getFace() == NULL) {
+				edge = edge->getNext();
+				continue;
+			}
+			const Point& a = edge->getOrigin()->getData();
+			const Point& b = edge->getTwin()->getOrigin()->getData();
+			double cross = (b.x() - a.x()) * (site.y() - a.y())
+					- (b.y() - a.y()) * (site.x() - a.x());
+			double scale = (std::abs(b.x() - a.x()) + std::abs(b.y() - a.y()))
+					* (std::abs(site.x() - a.x()) + std::abs(site.y() - a.y()));
+			EXPECT_GE(cross, -1e-9 * scale) << "Site " << f
+					<< " on the right of its cell.";
+			edge = edge->getNext();
+		} while (edge != start);
+	}
+}
+
+TEST(MeshCheckTest, RandomSites)
+{
+	LOG(INFO) << "Starting random mesh check test.";
+	std::vector<Point> sites;
+
+	srand(11);
+	for (size_t i = 0; i < 1000; i++)
+		sites.push_back(Point(rand() % 100000 / 100.0,
+				rand() % 100000 / 100.0));
+	ExpectMesh<Engine>(sites);
+	LOG(INFO) << "Finishing random mesh check test.";
+}
+
+TEST(MeshCheckTest, DegenerateSites)
+{
+	LOG(INFO) << "Starting degenerate mesh check test.";
+	std::vector<Point> grid, row, column;
+
+	for (int y = 0; y < 10; y++)
+		for (int x = 0; x < 10; x++)
+			grid.push_back(Point(x * 10, y * 10));
+	for (int x = 0; x < 10; x++) {
+		row.push_back(Point(x * 10, 5));
+		column.push_back(Point(5, x * 10));
+	}
+	ExpectMesh<Engine>(grid);
+	ExpectMesh<Engine>(row);
+	ExpectMesh<Engine>(column);
+	LOG(INFO) << "Finishing degenerate mesh check test.";
+}
+
+TEST(MeshCheckTest, FlatBackend)
+{
+	LOG(INFO) << "Starting flat beach line mesh check test.";
+	std::vector<Point> sites, grid;
+
+	srand(13);
+	for (size_t i = 0; i < 1000; i++)
+		sites.push_back(Point(rand() % 100000 / 100.0,
+				rand() % 100000 / 100.0));
+	for (int y = 0; y < 10; y++)
+		for (int x = 0; x < 10; x++)
+			grid.push_back(Point(x * 10, y * 10));
+	ExpectMesh<voronoi::FlatEngine>(sites);
+	ExpectMesh<voronoi::FlatEngine>(grid);
+	LOG(INFO) << "Finishing flat beach line mesh check test.";
+}
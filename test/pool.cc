@@ -0,0 +1,71 @@
+#include <cstddef>
+
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <voronoi/pool.hh>
+#include <voronoi/voronoi.hh>
+
+using voronoi::NodeIndex;
+using voronoi::NodePool;
+
+TEST(NodePoolTest, ReusesFreedSlots)
+{
+	LOG(INFO) << "Starting node pool check test.";
+	NodePool<double> pool;
+
+	NodeIndex a = pool.Allocate();
+	NodeIndex b = pool.Allocate();
+	NodeIndex c = pool.Allocate();
+	EXPECT_EQ(3U, pool.size()) << "Wrong number of live slots.";
+	EXPECT_TRUE(pool.at(a) + 1 == pool.at(b)) << "Slots are not contiguous.";
+
+	pool.Free(b);
+	EXPECT_EQ(2U, pool.size()) << "Free did not release the slot.";
+	EXPECT_EQ(b, pool.Allocate()) << "Freed slot was not reused.";
+
+	pool.Free(a);
+	pool.Free(c);
+	EXPECT_EQ(c, pool.Allocate()) << "Free list is not LIFO.";
+	EXPECT_EQ(a, pool.Allocate()) << "Free list is not LIFO.";
+	LOG(INFO) << "Finishing node pool check test.";
+}
+
+TEST(NodePoolTest, ClearKeepsCapacity)
+{
+	LOG(INFO) << "Starting node pool clear test.";
+	NodePool<double> pool;
+
+	for (int i = 0; i < 5000; i++)
+		*pool.at(pool.Allocate()) = i;
+	size_t capacity = pool.capacity();
+	EXPECT_GE(capacity, 5000U) << "Pool did not grow.";
+	EXPECT_EQ(4999.0, *pool.at(4999)) << "Block addressing is wrong.";
+
+	pool.Clear();
+	EXPECT_EQ(0U, pool.size()) << "Clear left live slots.";
+	EXPECT_EQ(capacity, pool.capacity()) << "Clear released memory.";
+	EXPECT_EQ(0U, pool.Allocate()) << "Clear did not rewind the pool.";
+	LOG(INFO) << "Finishing node pool clear test.";
+}
+
+TEST(NodePoolTest, TreeNodesComeFromPool)
+{
+	LOG(INFO) << "Starting tree pool test.";
+	voronoi::VoronoiQueue queue;
+	voronoi::VoronoiDCEL dcel;
+	voronoi::VoronoiTree tree(&queue, &dcel);
+	voronoi::Point a(2, 5), b(5, 4);
+
+	tree.InsertParabola(&a);
+	EXPECT_EQ(1U, tree.size()) << "Root was not allocated.";
+	tree.InsertParabola(&b);
+	EXPECT_EQ(5U, tree.size()) << "Split must leave 2 breakpoints and 3 arcs.";
+	EXPECT_FALSE(tree.isEmpty());
+
+	tree.Clear();
+	EXPECT_TRUE(tree.isEmpty()) << "Clear left a root behind.";
+	EXPECT_EQ(0U, tree.size()) << "Clear left nodes behind.";
+	LOG(INFO) << "Finishing tree pool test.";
+}
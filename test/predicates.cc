@@ -0,0 +1,118 @@
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <voronoi/voronoi.hh>
+
+using voronoi::Engine;
+using voronoi::Point;
+using voronoi::Span;
+
+/* One unit in the last place of 0.5, the step of the grid below. */
+static const double kStep = 1.0 / (1LL << 53);
+
+/*
+ * Orientation of a, b and c on the grid 0.5 + k * kStep, done in integers.
+ */
+static int ExactSign(const long long a[2], const long long b[2],
+		const long long c[2])
+{
+	__int128 det = static_cast<__int128>(a[0] - c[0]) * (b[1] - c[1])
+			- static_cast<__int128>(a[1] - c[1]) * (b[0] - c[0]);
+	return det > 0 ? 1 : det < 0 ? -1 : 0;
+}
+
+static int Sign(double value)
+{
+	return value > 0 ? 1 : value < 0 ? -1 : 0;
+}
+
+TEST(PredicatesCheckTest, OrientationNearALine)
+{
+	LOG(INFO) << "Starting orientation check test.";
+	/* The classic failure: points next to the line through b and c. */
+	long long b[2] = { 12LL << 53, 12LL << 53 };
+	long long c[2] = { 24LL << 53, 24LL << 53 };
+	Point pb(12, 12), pc(24, 24);
+
+	voronoi::ResetPredicateStats();
+	for (long long i = 0; i < 64; i++) {
+		for (long long j = 0; j < 64; j++) {
+			long long a[2] = { (1LL << 52) + i, (1LL << 52) + j };
+			Point pa(0.5 + i * kStep, 0.5 + j * kStep);
+			ASSERT_EQ(ExactSign(a, b, c), Sign(voronoi::Orientation(pa, pb,
+					pc))) << "Point " << i << ", " << j << ".";
+		}
+	}
+	const voronoi::PredicateStats& stats = voronoi::predicate_stats();
+	EXPECT_EQ(64U * 64U, stats.orientations);
+	EXPECT_GT(stats.exact_orientations, 0U) << "The filter decided them all.";
+	LOG(INFO) << "Finishing orientation check test.";
+}
+
+TEST(PredicatesCheckTest, InCircleNearACircle)
+{
+	LOG(INFO) << "Starting incircle check test.";
+	Point a(1, 0), b(0, 1), c(-1, 0);
+
+	voronoi::ResetPredicateStats();
+	EXPECT_EQ(0, Sign(voronoi::InCircle(a, b, c, Point(0, -1))));
+	EXPECT_EQ(1, Sign(voronoi::InCircle(a, b, c, Point(0, -1 + kStep))));
+	EXPECT_EQ(-1, Sign(voronoi::InCircle(a, b, c, Point(0, -1 - 2 * kStep))));
+	EXPECT_EQ(1, Sign(voronoi::InCircle(a, b, c, Point(0, 0))));
+	EXPECT_EQ(-1, Sign(voronoi::InCircle(c, b, a, Point(0, 0))));
+
+	/* Shifted far from the origin, where the filter has no bits to spare. */
+	Point d(1e6 + 1, 1e6), e(1e6, 1e6 + 1), f(1e6 - 1, 1e6);
+	EXPECT_EQ(0, Sign(voronoi::InCircle(d, e, f, Point(1e6, 1e6 - 1))));
+	EXPECT_EQ(6U, voronoi::predicate_stats().incircles);
+	EXPECT_GE(voronoi::predicate_stats().exact_incircles, 2U);
+	LOG(INFO) << "Finishing incircle check test.";
+}
+
+TEST(PredicatesCheckTest, SnappedSites)
+{
+	LOG(INFO) << "Starting snapped sites check test.";
+	std::vector<Point> sites;
+	Engine engine;
+
+	/*
+	 * Columns of sites with the same x and rows nudged by one unit in the
+	 * last place, the first one included: every circle event is nearly
+	 * degenerate.
+	 */
+	for (unsigned int seed = 0; seed < 20; seed++) {
+		srand(seed);
+		sites.clear();
+		for (int y = 0; y < 30; y++) {
+			for (int x = 0; x < 30; x++) {
+				double nudged = 1000 + y;
+				if (rand() % 3 != 0)
+					nudged = std::nextafter(nudged, rand() % 2 ? 0 : 1e9);
+				sites.push_back(Point(1000 + x, nudged));
+			}
+		}
+		voronoi::ResetPredicateStats();
+		voronoi::DelaunayDCEL triangulation;
+		ASSERT_NO_THROW(voronoi::BuildDelaunay(engine.compute(
+				Span<const Point>(sites)), Span<const Point>(sites),
+				triangulation)) << "Seed " << seed << ".";
+		ASSERT_NO_THROW(triangulation.checkAllFaces()) << "Seed " << seed
+				<< ".";
+		EXPECT_GT(voronoi::predicate_stats().exact_orientations, 0U);
+
+		for (size_t f = 0; f < triangulation.getNumFaces(); f++) {
+			voronoi::DelaunayDCEL::HalfEdge* edge =
+					triangulation.getFace(f)->getBoundary();
+			ASSERT_GT(voronoi::Orientation(edge->getOrigin()->getData(),
+					edge->getNext()->getOrigin()->getData(),
+					edge->getNext()->getNext()->getOrigin()->getData()), 0)
+					<< "Face " << f << " of seed " << seed << ".";
+		}
+	}
+	LOG(INFO) << "Finishing snapped sites check test.";
+}
@@ -0,0 +1,124 @@
+#include <cstdlib>
+#include <vector>
+
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <voronoi/voronoi.hh>
+
+using voronoi::CircleEvent;
+using voronoi::Point;
+using voronoi::VoronoiQueue;
+
+static void FreeSites(std::vector<Point*>& sites)
+{
+	for (size_t i = 0; i < sites.size(); i++)
+		delete sites[i];
+}
+
+static void ExpectDescending(VoronoiQueue& queue, size_t count)
+{
+	double last = queue.top().y();
+
+	for (size_t i = 0; i < count; i++) {
+		ASSERT_FALSE(queue.empty()) << "Queue ran out of events.";
+		EXPECT_LE(queue.top().y(), last) << "Event " << i << " out of order.";
+		last = queue.top().y();
+		queue.pop();
+	}
+	EXPECT_TRUE(queue.empty()) << "Queue has events left.";
+}
+
+TEST(QueueCheckTest, MergesSitesAndEvents)
+{
+	LOG(INFO) << "Starting queue check test.";
+	std::vector<Point*> sites;
+	sites.push_back(new Point(2, 5));
+	sites.push_back(new Point(6, 1));
+	sites.push_back(new Point(3, 3));
+	sites.push_back(new Point(7, 2));
+
+	VoronoiQueue queue(sites);
+	CircleEvent low = { 0, 0.5, voronoi::kNullNode };
+	CircleEvent high = { 1, 4, voronoi::kNullNode };
+	queue.push(low);
+	queue.push(high);
+	EXPECT_EQ(6U, queue.size());
+
+	EXPECT_TRUE(queue.isSiteNext());
+	EXPECT_EQ(sites[0], queue.site());
+	queue.pop();
+	EXPECT_FALSE(queue.isSiteNext()) << "Circle event must go before lower sites.";
+	EXPECT_EQ(4.0, queue.circle().y);
+	EXPECT_EQ(1.0, queue.top().x());
+	queue.pop();
+	EXPECT_EQ(3.0, queue.top().y());
+	queue.pop();
+	EXPECT_EQ(2.0, queue.top().y());
+	queue.pop();
+	EXPECT_EQ(1.0, queue.top().y());
+	queue.pop();
+	EXPECT_EQ(0.5, queue.top().y());
+	queue.pop();
+	EXPECT_TRUE(queue.empty());
+
+	FreeSites(sites);
+	LOG(INFO) << "Finishing queue check test.";
+}
+
+TEST(QueueCheckTest, ParallelSortKeepsOrder)
+{
+	LOG(INFO) << "Starting parallel sort check test.";
+	std::vector<Point*> sites;
+	size_t count = VoronoiQueue::kParallelSortThreshold * 2 + 7;
+
+	srand(42);
+	for (size_t i = 0; i < count; i++)
+		sites.push_back(new Point(rand() % 1000, rand() % 1000));
+
+	VoronoiQueue queue(sites);
+	EXPECT_EQ(count, queue.size());
+	ExpectDescending(queue, count);
+
+	FreeSites(sites);
+	LOG(INFO) << "Finishing parallel sort check test.";
+}
+
+TEST(QueueCheckTest, EraseRemovesPendingEvents)
+{
+	LOG(INFO) << "Starting queue erase check test.";
+	VoronoiQueue queue;
+	std::vector<CircleEvent> events;
+	std::vector<voronoi::EventHandle> handles;
+
+	for (int i = 0; i < 100; i++) {
+		CircleEvent event = { 0, static_cast<double>((i * 37) % 100),
+				voronoi::kNullNode };
+		events.push_back(event);
+	}
+	for (size_t i = 0; i < events.size(); i++)
+		handles.push_back(queue.push(events[i]));
+
+	/* Drop every event with an odd y. */
+	for (size_t i = 0; i < events.size(); i++) {
+		if (static_cast<int>(events[i].y) % 2 == 0)
+			continue;
+		EXPECT_EQ(events[i].y, queue.event(handles[i]).y);
+		queue.erase(handles[i]);
+	}
+	EXPECT_EQ(50U, queue.size());
+
+	double expected = 98;
+	while (!queue.empty()) {
+		EXPECT_EQ(expected, queue.top().y()) << "Erase broke the heap.";
+		queue.pop();
+		expected -= 2;
+	}
+
+	const voronoi::QueueStats& stats = queue.stats();
+	EXPECT_EQ(100U, stats.circle_events);
+	EXPECT_EQ(50U, stats.removed);
+	EXPECT_EQ(100U, stats.peak_size);
+	LOG(INFO) << "Finishing queue erase check test.";
+}
@@ -0,0 +1,294 @@
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <voronoi/voronoi.hh>
+
+using voronoi::DiagramClient;
+using voronoi::DiagramServer;
+using voronoi::Engine;
+using voronoi::Point;
+using voronoi::ServerReply;
+using voronoi::ServerRequest;
+using voronoi::Span;
+using voronoi::VoronoiDCEL;
+
+static const char* kSocket = "server_check.sock";
+
+/* Every fourth input is large enough to go in a shared file. */
+static std::vector<std::vector<Point> > RandomInputs(size_t count)
+{
+	std::vector<std::vector<Point> > inputs(count);
+
+	srand(5);
+	for (size_t i = 0; i < count; i++) {
+		size_t sites = i % 4 == 3 ? 6000 : rand() % 200;
+		for (size_t j = 0; j < sites; j++)
+			inputs[i].push_back(Point(rand() / (RAND_MAX / 1000.0),
+					rand() / (RAND_MAX / 1000.0)));
+	}
+	return inputs;
+}
+
+static void Serve(DiagramServer* server)
+{
+	server->Run();
+}
+
+static void Ask(const std::vector<std::vector<Point> >* inputs,
+		std::vector<VoronoiDCEL>* outputs, int* failures)
+{
+	DiagramClient client;
+
+	if (!client.Connect(kSocket)) {
+		++*failures;
+		return;
+	}
+	outputs->resize(inputs->size());
+	for (size_t i = 0; i < inputs->size(); i++) {
+		if (client.Compute((*inputs)[i]))
+			client.CopyTo((*outputs)[i]);
+		else
+			++*failures;
+	}
+}
+
+TEST(ServerCheckTest, MatchesEngine)
+{
+	LOG(INFO) << "Starting server check test.";
+	std::vector<std::vector<Point> > inputs = RandomInputs(24);
+	const size_t clients = 4;
+	std::vector<std::vector<VoronoiDCEL> > outputs(clients);
+	std::vector<int> failures(clients);
+	std::vector<std::thread> threads;
+	DiagramServer server(2, 2000);
+
+	ASSERT_TRUE(server.Listen(kSocket));
+	std::thread serving(Serve, &server);
+	for (size_t i = 0; i < clients; i++)
+		threads.push_back(std::thread(Ask, &inputs, &outputs[i],
+				&failures[i]));
+	for (size_t i = 0; i < clients; i++)
+		threads[i].join();
+	server.Stop();
+	serving.join();
+
+	Engine engine;
+	for (size_t i = 0; i < inputs.size(); i++) {
+		engine.compute(Span<const Point>(inputs[i]));
+		const VoronoiDCEL& expected = engine.diagram();
+		for (size_t j = 0; j < clients; j++) {
+			EXPECT_EQ(0, failures[j]);
+			const VoronoiDCEL& served = outputs[j][i];
+			ASSERT_EQ(expected.edges().size(), served.edges().size());
+			ASSERT_EQ(expected.coordinates().size(),
+					served.coordinates().size());
+			EXPECT_EQ(expected.vertex_count(), served.vertex_count());
+			EXPECT_EQ(0, memcmp(expected.coordinates().data(),
+					served.coordinates().data(),
+					expected.coordinates().size() * sizeof(double)));
+			/* Every byte of the edges, reserved ones included. */
+			EXPECT_EQ(0, memcmp(expected.edges().data(),
+					served.edges().data(), expected.edges().size()
+							* sizeof(voronoi::DiagramEdge)));
+			for (size_t k = 0; k < expected.edges().size(); k++) {
+				EXPECT_EQ(expected.edges()[k].origin,
+						served.edges()[k].origin);
+				EXPECT_EQ(expected.edges()[k].destination,
+						served.edges()[k].destination);
+				EXPECT_EQ(expected.edges()[k].left_site,
+						served.edges()[k].left_site);
+			}
+		}
+	}
+
+	voronoi::ServerStats stats = server.stats();
+	EXPECT_EQ(clients * inputs.size(), stats.requests);
+	EXPECT_LE(stats.batches, stats.requests);
+	EXPECT_LE(stats.largest_batch, DiagramServer::kMaxBatch);
+	LOG(INFO) << "Finishing server check test.";
+}
+
+TEST(ServerCheckTest, StopsWithIdleClients)
+{
+	LOG(INFO) << "Starting server stop check test.";
+	std::vector<Point> sites = RandomInputs(1)[0];
+	DiagramServer server(1);
+	DiagramClient client;
+
+	ASSERT_TRUE(server.Listen(kSocket));
+	std::thread serving(Serve, &server);
+	ASSERT_TRUE(client.Connect(kSocket));
+	ASSERT_TRUE(client.Compute(sites));
+	EXPECT_EQ(1U, server.stats().requests);
+
+	server.Stop();
+	serving.join();
+	EXPECT_FALSE(client.Compute(sites));
+	EXPECT_EQ(0U, client.edge_count());
+	LOG(INFO) << "Finishing server stop check test.";
+}
+
+TEST(ServerCheckTest, RefusesRequestsOverTheCap)
+{
+	LOG(INFO) << "Starting server cap check test.";
+	std::vector<Point> inputs = RandomInputs(4)[3];
+	std::vector<Point> few(inputs.begin(), inputs.begin() + 500);
+	std::vector<Point> many(inputs.begin(), inputs.begin() + 2000);
+	DiagramServer server(1, 100, 1000);
+	DiagramClient inline_client, file_client, client;
+
+	ASSERT_TRUE(server.Listen(kSocket));
+	std::thread serving(Serve, &server);
+	ASSERT_TRUE(inline_client.Connect(kSocket));
+	EXPECT_FALSE(inline_client.Compute(many));
+	ASSERT_TRUE(file_client.Connect(kSocket));
+	EXPECT_FALSE(file_client.Compute(inputs));
+	ASSERT_TRUE(client.Connect(kSocket));
+	EXPECT_TRUE(client.Compute(few));
+	EXPECT_GT(client.edge_count(), 0U);
+
+	server.Stop();
+	serving.join();
+	LOG(INFO) << "Finishing server cap check test.";
+}
+
+TEST(ServerCheckTest, RefusesConnectionsOverTheCap)
+{
+	LOG(INFO) << "Starting server connection cap check test.";
+	std::vector<Point> sites = RandomInputs(3)[2];
+	DiagramServer server(1, 100, DiagramServer::kDefaultMaxSites, 2);
+	DiagramClient first, second, third;
+
+	ASSERT_TRUE(server.Listen(kSocket));
+	std::thread serving(Serve, &server);
+	ASSERT_TRUE(first.Connect(kSocket));
+	ASSERT_TRUE(first.Compute(sites));
+	ASSERT_TRUE(second.Connect(kSocket));
+	ASSERT_TRUE(second.Compute(sites));
+	ASSERT_TRUE(third.Connect(kSocket));
+	EXPECT_FALSE(third.Compute(sites));
+
+	/* The ones already served keep going. */
+	EXPECT_TRUE(first.Compute(sites));
+	EXPECT_TRUE(second.Compute(sites));
+	EXPECT_EQ(1U, server.stats().refused);
+
+	server.Stop();
+	serving.join();
+	LOG(INFO) << "Finishing server connection cap check test.";
+}
+
+static int ConnectTo(const char* path)
+{
+	struct sockaddr_un address;
+	int socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, path);
+	if (connect(socket, reinterpret_cast<struct sockaddr*>(&address),
+			sizeof(address)) != 0) {
+		close(socket);
+		return -1;
+	}
+	return socket;
+}
+
+/* Send |request| with |file|, if any, and read the reply and its file. */
+static bool Exchange(int socket, const ServerRequest& request, int file,
+		ServerReply* reply, int* reply_file)
+{
+	char control[CMSG_SPACE(sizeof(int))];
+	struct iovec piece;
+	struct msghdr message;
+
+	memset(control, 0, sizeof(control));
+	memset(&message, 0, sizeof(message));
+	piece.iov_base = const_cast<ServerRequest*>(&request);
+	piece.iov_len = sizeof(request);
+	message.msg_iov = &piece;
+	message.msg_iovlen = 1;
+	if (file >= 0) {
+		message.msg_control = control;
+		message.msg_controllen = sizeof(control);
+		struct cmsghdr* rights = CMSG_FIRSTHDR(&message);
+		rights->cmsg_level = SOL_SOCKET;
+		rights->cmsg_type = SCM_RIGHTS;
+		rights->cmsg_len = CMSG_LEN(sizeof(int));
+		memcpy(CMSG_DATA(rights), &file, sizeof(int));
+	}
+	if (sendmsg(socket, &message, 0) != sizeof(request))
+		return false;
+
+	*reply_file = -1;
+	piece.iov_base = reply;
+	piece.iov_len = sizeof(*reply);
+	message.msg_control = control;
+	message.msg_controllen = sizeof(control);
+	if (recvmsg(socket, &message, MSG_WAITALL) != sizeof(*reply))
+		return false;
+	struct cmsghdr* rights = CMSG_FIRSTHDR(&message);
+	if (rights != NULL && rights->cmsg_type == SCM_RIGHTS)
+		memcpy(reply_file, CMSG_DATA(rights), sizeof(int));
+	return true;
+}
+
+TEST(ServerCheckTest, SealsSharedFiles)
+{
+	LOG(INFO) << "Starting server seals check test.";
+	std::vector<Point> sites = RandomInputs(4)[3];
+	size_t bytes = sites.size() * sizeof(Point);
+	DiagramServer server(1);
+	ServerRequest request = { voronoi::kServerMagic, voronoi::kSitesInFile,
+			sites.size() };
+	ServerReply reply;
+	int reply_file;
+
+	ASSERT_TRUE(server.Listen(kSocket));
+	std::thread serving(Serve, &server);
+
+	/* Sites the client could still truncate are refused. */
+	int file = memfd_create("unsealed", MFD_CLOEXEC);
+	ASSERT_GE(file, 0);
+	ASSERT_EQ(0, ftruncate(file, bytes));
+	ASSERT_EQ(static_cast<ssize_t>(bytes), pwrite(file, sites.data(), bytes,
+			0));
+	int socket = ConnectTo(kSocket);
+	ASSERT_GE(socket, 0);
+	ASSERT_TRUE(Exchange(socket, request, file, &reply, &reply_file));
+	EXPECT_EQ(voronoi::kReplyFailed, reply.status);
+	EXPECT_LT(reply_file, 0);
+	close(socket);
+	close(file);
+
+	/* The reply file cannot be resized under the server. */
+	file = memfd_create("sealed", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+	ASSERT_EQ(0, ftruncate(file, bytes));
+	ASSERT_EQ(static_cast<ssize_t>(bytes), pwrite(file, sites.data(), bytes,
+			0));
+	ASSERT_EQ(0, fcntl(file, F_ADD_SEALS, F_SEAL_SHRINK));
+	socket = ConnectTo(kSocket);
+	ASSERT_TRUE(Exchange(socket, request, file, &reply, &reply_file));
+	EXPECT_EQ(voronoi::kReplyOk, reply.status);
+	ASSERT_GE(reply_file, 0);
+	EXPECT_NE(0, ftruncate(reply_file, 0));
+	EXPECT_NE(0, ftruncate(reply_file, 1 << 30));
+	close(reply_file);
+	close(socket);
+	close(file);
+
+	server.Stop();
+	serving.join();
+	LOG(INFO) << "Finishing server seals check test.";
+}
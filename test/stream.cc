@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <voronoi/voronoi.hh>
+
+using voronoi::Engine;
+using voronoi::Point;
+using voronoi::Span;
+using voronoi::StreamEdge;
+using voronoi::StreamingSweep;
+using voronoi::VertexSites;
+using voronoi::VoronoiDCEL;
+
+static double frand(double fmin, double fmax)
+{
+	double f = (double) rand() / RAND_MAX;
+	return fmin + f * (fmax - fmin);
+}
+
+static bool SweepOrder(const Point& a, const Point& b)
+{
+	if (a.y() != b.y())
+		return a.y() > b.y();
+	return a.x() < b.x();
+}
+
+/* Puts the reported diagram back together. */
+struct Collector {
+	VoronoiDCEL diagram;
+	size_t points;
+	size_t edges;
+
+	Collector() :
+			points(0), edges(0)
+	{
+	}
+
+	void OnPoint(uint64_t id, const Point& at, const VertexSites& sites)
+	{
+		EXPECT_EQ(points++, id);
+		if (sites.left >= 0)
+			diagram.addVertex(at.x(), at.y(), sites);
+		else
+			diagram.addFarPoint(at.x(), at.y());
+	}
+
+	void OnEdge(const StreamEdge& edge)
+	{
+		/* Both ends were reported before. */
+		EXPECT_LT(edge.origin, points);
+		EXPECT_LT(edge.destination, points);
+		diagram.addEdge(voronoi::DiagramEdge(edge.origin, edge.destination,
+				edge.left_site, edge.right_site, edge.origin_at_infinity,
+				edge.destination_at_infinity));
+		edges++;
+	}
+};
+
+static StreamingSweep* CreateSweep(Collector* collector)
+{
+	using namespace std::placeholders;
+	return new StreamingSweep(std::bind(&Collector::OnPoint, collector, _1,
+			_2, _3), std::bind(&Collector::OnEdge, collector, _1));
+}
+
+TEST(StreamTest, SameAsEngine)
+{
+	LOG(INFO) << "Starting streaming sweep test.";
+	std::vector<Point> sites;
+	Collector collector;
+	StreamingSweep* stream = CreateSweep(&collector);
+
+	srand(31);
+	for (size_t i = 0; i < 20000; i++)
+		sites.push_back(Point(frand(0, 1000), frand(0, 1000)));
+	/* A first row and a column. */
+	for (size_t i = 0; i < 10; i++) {
+		sites.push_back(Point(100 * i + 0.5, 1001));
+		sites.push_back(Point(-5, 99.5 * i));
+	}
+	std::sort(sites.begin(), sites.end(), SweepOrder);
+
+	for (size_t i = 0; i < sites.size(); i++)
+		ASSERT_EQ((int) i, stream->AddSite(sites[i]));
+	EXPECT_EQ(StreamingSweep::kNoSite, stream->AddSite(sites.back()));
+	EXPECT_EQ(StreamingSweep::kNoSite, stream->AddSite(Point(0, 2000)));
+	stream->Finish();
+	EXPECT_EQ(StreamingSweep::kNoSite, stream->AddSite(Point(0, -2000)));
+
+	Engine engine;
+	engine.compute(Span<const Point>(sites));
+	EXPECT_TRUE(voronoi::EquivalentDiagrams(collector.diagram,
+			engine.diagram(), 1e-9));
+
+	stream->Reset();
+	collector = Collector();
+	for (size_t i = 0; i < 100; i++)
+		stream->AddSite(sites[i]);
+	stream->Finish();
+	engine.compute(Span<const Point>(&sites[0], 100));
+	EXPECT_TRUE(voronoi::EquivalentDiagrams(collector.diagram,
+			engine.diagram(), 1e-9));
+	delete stream;
+	LOG(INFO) << "Finishing streaming sweep test.";
+}
+
+TEST(StreamTest, MemoryFollowsTheBeachLine)
+{
+	LOG(INFO) << "Starting streaming memory test.";
+	Collector collector;
+	StreamingSweep* stream = CreateSweep(&collector);
+	size_t beach_line = 0;
+	size_t held = 0;
+
+	/* A long band: the beach line stays small however many sites come. */
+	srand(37);
+	for (size_t i = 0; i < 200000; i++) {
+		stream->AddSite(Point(frand(0, 100), -0.01 * i));
+		beach_line = std::max(beach_line, stream->beach_line_size());
+		held = std::max(held, stream->held_points() + stream->held_sites());
+	}
+	stream->Finish();
+	EXPECT_GT(collector.edges, 500000u);
+	EXPECT_LT(beach_line, 4000u);
+	EXPECT_LT(held, 8 * beach_line + 2 * StreamingSweep::kMinCompaction);
+	delete stream;
+	LOG(INFO) << "Finishing streaming memory test.";
+}
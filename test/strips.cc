@@ -0,0 +1,169 @@
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <voronoi/voronoi.hh>
+
+using voronoi::Engine;
+using voronoi::Point;
+using voronoi::Span;
+using voronoi::StripEngine;
+using voronoi::StripStats;
+using voronoi::VoronoiDCEL;
+
+static double frand(double fmin, double fmax)
+{
+	return fmin + rand() / (double) RAND_MAX * (fmax - fmin);
+}
+
+static StripStats ExpectSameAsSweep(const std::vector<Point>& sites,
+		unsigned int threads)
+{
+	Engine sequential;
+	StripEngine strips(threads);
+	VoronoiDCEL out;
+
+	sequential.compute(Span<const Point>(sites));
+	strips.Compute(Span<const Point>(sites), out);
+	EXPECT_EQ(threads, strips.stats().strips);
+	EXPECT_GE(strips.stats().sweeps, threads);
+	EXPECT_EQ(sequential.diagram().edges().size(), out.edges().size());
+	EXPECT_EQ(sequential.diagram().vertex_count(), out.vertex_count());
+	EXPECT_TRUE(voronoi::EquivalentDiagrams(sequential.diagram(), out, 1e-9))
+			<< "Strips do not match the sequential sweep.";
+	return strips.stats();
+}
+
+TEST(StripCheckTest, UniformSites)
+{
+	LOG(INFO) << "Starting uniform strip check test.";
+	std::vector<Point> sites;
+
+	srand(5);
+	for (int i = 0; i < 20000; i++)
+		sites.push_back(Point(frand(0, 1000), frand(0, 1000)));
+	EXPECT_FALSE(ExpectSameAsSweep(sites, 1).sequential);
+	EXPECT_FALSE(ExpectSameAsSweep(sites, 4).sequential);
+	EXPECT_FALSE(ExpectSameAsSweep(sites, 7).sequential);
+	LOG(INFO) << "Finishing uniform strip check test.";
+}
+
+TEST(StripCheckTest, ClusteredSites)
+{
+	LOG(INFO) << "Starting clustered strip check test.";
+	std::vector<Point> sites;
+
+	/* Dense clusters far apart force the halos to grow. */
+	srand(6);
+	for (int i = 0; i < 10000; i++) {
+		double cx = (i % 5) * 1000.0, cy = (i % 3) * 50.0;
+		double angle = frand(0, 2 * M_PI), radius = frand(0, 10);
+		sites.push_back(Point(cx + radius * std::cos(angle),
+				cy + radius * std::sin(angle)));
+	}
+	sites.push_back(Point(2500, 5000));
+	EXPECT_FALSE(ExpectSameAsSweep(sites, 4).sequential);
+	EXPECT_FALSE(ExpectSameAsSweep(sites, 7).sequential);
+	LOG(INFO) << "Finishing clustered strip check test.";
+}
+
+/*
+ * Inputs the strips cannot certify cheaply: every circle holds most of the
+ * sites, or many of them.  These must still come out right, in about the
+ * time of one sweep.
+ */
+TEST(StripCheckTest, SitesOnACircle)
+{
+	LOG(INFO) << "Starting strip check test on a circle.";
+	std::vector<Point> sites;
+
+	for (int i = 0; i < 2500; i++) {
+		double angle = 2 * M_PI * i / 2500;
+		sites.push_back(Point(1000 * std::cos(angle), 1000 * std::sin(angle)));
+	}
+	ExpectSameAsSweep(sites, 4);
+	LOG(INFO) << "Finishing strip check test on a circle.";
+}
+
+TEST(StripCheckTest, SitesInColumns)
+{
+	LOG(INFO) << "Starting strip check test in columns.";
+	std::vector<Point> sites;
+
+	srand(8);
+	for (int i = 0; i < 10000; i++)
+		sites.push_back(Point((i % 4) * 100.0, frand(0, 1000)));
+	ExpectSameAsSweep(sites, 4);
+	LOG(INFO) << "Finishing strip check test in columns.";
+}
+
+TEST(StripCheckTest, SitesOnALattice)
+{
+	LOG(INFO) << "Starting strip check test on a lattice.";
+	std::vector<Point> sites;
+
+	for (int x = 0; x < 200; x++)
+		for (int y = 0; y < 200; y++)
+			sites.push_back(Point(x, y));
+	ExpectSameAsSweep(sites, 4);
+	LOG(INFO) << "Finishing strip check test on a lattice.";
+}
+
+TEST(StripCheckTest, ReplacesTheOutput)
+{
+	LOG(INFO) << "Starting strip output replace test.";
+	std::vector<Point> first, second, circle;
+	Engine sequential;
+	StripEngine strips(2);
+	VoronoiDCEL out;
+
+	srand(9);
+	for (int i = 0; i < 5000; i++) {
+		first.push_back(Point(frand(0, 1000), frand(0, 1000)));
+		second.push_back(Point(frand(0, 500), frand(0, 2000)));
+	}
+	for (int i = 0; i < 1000; i++) {
+		double angle = 2 * M_PI * i / 1000;
+		circle.push_back(Point(std::cos(angle), std::sin(angle)));
+	}
+	strips.Compute(Span<const Point>(first), out);
+	strips.Compute(Span<const Point>(second), out);
+	sequential.compute(Span<const Point>(second));
+	EXPECT_TRUE(voronoi::EquivalentDiagrams(sequential.diagram(), out, 1e-9));
+
+	/* The sequential fallback replaces it too. */
+	strips.Compute(Span<const Point>(circle), out);
+	EXPECT_TRUE(strips.stats().sequential);
+	sequential.compute(Span<const Point>(circle));
+	EXPECT_TRUE(voronoi::EquivalentDiagrams(sequential.diagram(), out, 1e-9));
+	LOG(INFO) << "Finishing strip output replace test.";
+}
+
+TEST(StripCheckTest, EngineSelectsStrips)
+{
+	LOG(INFO) << "Starting strip engine selection test.";
+	std::vector<Point> sites;
+	Engine sequential, parallel;
+
+	srand(7);
+	for (size_t i = 0; i < Engine::kMinStripSites + 100; i++)
+		sites.push_back(Point(frand(-50, 50), frand(-5, 5)));
+	parallel.set_algorithm(voronoi::kStripSweep, 3);
+	EXPECT_EQ(voronoi::kStripSweep, parallel.algorithm());
+	sequential.compute(Span<const Point>(sites));
+	parallel.compute(Span<const Point>(sites));
+	EXPECT_TRUE(voronoi::EquivalentDiagrams(sequential.diagram(),
+			parallel.diagram(), 1e-9));
+
+	/* Small inputs are not worth splitting. */
+	sites.resize(100);
+	sequential.compute(Span<const Point>(sites));
+	parallel.compute(Span<const Point>(sites));
+	EXPECT_TRUE(voronoi::EquivalentDiagrams(sequential.diagram(),
+			parallel.diagram(), 0));
+	LOG(INFO) << "Finishing strip engine selection test.";
+}
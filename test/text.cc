@@ -0,0 +1,78 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <voronoi/voronoi.hh>
+
+using voronoi::Point;
+using voronoi::Span;
+
+static double frand(double fmin, double fmax)
+{
+	double f = (double) rand() / RAND_MAX;
+	return fmin + f * (fmax - fmin);
+}
+
+TEST(TextTest, ParsesNumbers)
+{
+	LOG(INFO) << "Starting text parse test.";
+	const char* text = "  1 -2.5\n3e2\t.5 \r\n-0 1e-300\n";
+	std::vector<double> numbers(1, 7);
+
+	ASSERT_TRUE(voronoi::ParseNumbers(text, text + strlen(text), numbers));
+	ASSERT_EQ(7u, numbers.size());
+	EXPECT_EQ(7, numbers[0]);
+	EXPECT_EQ(-2.5, numbers[2]);
+	EXPECT_EQ(300, numbers[3]);
+	EXPECT_EQ(0.5, numbers[4]);
+	EXPECT_EQ(1e-300, numbers[6]);
+
+	const char* bad[] = { "1 2 x", "1,2", "1 2.5.5", "+1", "1e999" };
+	for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+		EXPECT_FALSE(voronoi::ParseNumbers(bad[i], bad[i] + strlen(bad[i]),
+				numbers)) << bad[i];
+		EXPECT_EQ(7u, numbers.size());
+	}
+	LOG(INFO) << "Finishing text parse test.";
+}
+
+TEST(TextTest, RoundTrip)
+{
+	LOG(INFO) << "Starting text round trip test.";
+	const char* path = "text_check.txt";
+	std::vector<Point> sites, loaded;
+
+	/* Enough to be parsed on several threads. */
+	srand(41);
+	for (size_t i = 0; i < 200000; i++)
+		sites.push_back(Point(frand(-1e6, 1e6), frand(0, 1) * 1e-3));
+	sites.push_back(Point(0.1, 1.0 / 3));
+
+	ASSERT_TRUE(voronoi::WriteSites(path, Span<const Point>(sites)));
+	ASSERT_TRUE(voronoi::ReadSites(path, loaded, 4));
+	ASSERT_EQ(sites.size(), loaded.size());
+	for (size_t i = 0; i < sites.size(); i++)
+		ASSERT_TRUE(sites[i].x() == loaded[i].x()
+				&& sites[i].y() == loaded[i].y()) << i;
+
+	std::vector<double> odd(3, 1.5);
+	ASSERT_TRUE(voronoi::WriteNumbers(path, &odd[0], odd.size(), 2));
+	EXPECT_FALSE(voronoi::ReadSites(path, loaded));
+	remove(path);
+	EXPECT_FALSE(voronoi::ReadSites("does/not/exist", loaded));
+
+	/* Every write fails there, the first ones long before Close(). */
+	FILE* full = fopen("/dev/full", "wb");
+	if (full != NULL) {
+		fclose(full);
+		EXPECT_FALSE(voronoi::WriteSites("/dev/full", Span<const Point>(
+				sites)));
+	}
+	LOG(INFO) << "Finishing text round trip test.";
+}
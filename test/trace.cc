@@ -0,0 +1,74 @@
+#include <cstdio>
+#include <vector>
+
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <voronoi/trace.hh>
+#include <voronoi/voronoi.hh>
+
+using voronoi::TraceBuffer;
+using voronoi::TraceRecord;
+
+TEST(TraceCheckTest, RingKeepsNewestRecords)
+{
+	LOG(INFO) << "Starting trace ring check test.";
+	TraceBuffer trace(5);
+	EXPECT_EQ(8U, trace.capacity()) << "Capacity must be a power of two.";
+
+	for (int i = 0; i < 20; i++)
+		trace.Record(voronoi::kTraceSite, i, -i, 0, 0);
+
+	std::vector<TraceRecord> records = trace.records();
+	ASSERT_EQ(8U, records.size());
+	EXPECT_EQ(12U, trace.dropped());
+	EXPECT_EQ(12.0, records.front().ax) << "Oldest record is wrong.";
+	EXPECT_EQ(19.0, records.back().ax) << "Newest record is wrong.";
+	EXPECT_EQ(19U, records.back().sequence);
+	LOG(INFO) << "Finishing trace ring check test.";
+}
+
+TEST(TraceCheckTest, SaveAndLoadRoundTrip)
+{
+	LOG(INFO) << "Starting trace file check test.";
+	const char* path = "trace_check.bin";
+	TraceBuffer trace(16), loaded;
+
+	trace.Record(voronoi::kTraceEdge, 1, 2, 3, 4);
+	trace.Record(voronoi::kTraceFalseAlarm, 5, 6, 0, 0);
+	ASSERT_TRUE(trace.Save(path)) << "Could not write the trace.";
+	ASSERT_TRUE(loaded.Load(path)) << "Could not read the trace back.";
+	remove(path);
+
+	std::vector<TraceRecord> records = loaded.records();
+	ASSERT_EQ(2U, records.size());
+	EXPECT_EQ("0 edge (1, 2) -> (3, 4)", TraceBuffer::Format(records[0]));
+	EXPECT_EQ("1 false alarm at (5, 6)", TraceBuffer::Format(records[1]));
+	EXPECT_FALSE(loaded.Load("does/not/exist")) << "Loaded a missing file.";
+	LOG(INFO) << "Finishing trace file check test.";
+}
+
+TEST(TraceCheckTest, SweepRecordsOnlyWhenAttached)
+{
+	LOG(INFO) << "Starting sweep trace check test.";
+	TraceBuffer trace;
+	std::vector<voronoi::Point*> sites;
+	sites.push_back(new voronoi::Point(2, 5));
+	sites.push_back(new voronoi::Point(5, 4));
+	sites.push_back(new voronoi::Point(3, 3));
+
+	voronoi::SetTraceBuffer(&trace);
+	voronoi::Voronoi traced(sites);
+	voronoi::SetTraceBuffer(NULL);
+
+#ifdef VORONOI_TRACE
+	std::vector<TraceRecord> records = trace.records();
+	ASSERT_FALSE(records.empty()) << "Sweep left no trace.";
+	EXPECT_EQ(voronoi::kTraceSite, records.front().type);
+	EXPECT_EQ(5.0, records.front().ay) << "Sweep must start at the top.";
+#else
+	EXPECT_TRUE(trace.records().empty()) << "Trace points are compiled in.";
+#endif
+	LOG(INFO) << "Finishing sweep trace check test.";
+}
@@ -14,3 +14,99 @@ TEST(TreeCheckTest, UnitTestingFrameworkWorks)
 
 	LOG(INFO) << "Finishing Voronoi's  Tree check test.";
 }
+
+static int CountNode(int* count, const voronoi::Node* node)
+{
+	(void) node;
+	return (*count)++;
+}
+
+TEST(TreeCheckTest, WalksWithoutRecursion)
+{
+	LOG(INFO) << "Starting Voronoi's Tree walk test.";
+
+	/* A diagonal keeps every site on the beach line. */
+	std::vector<voronoi::Point> sites;
+	for (int i = 0; i < 50000; i++)
+		sites.push_back(voronoi::Point(i, i));
+	std::vector<voronoi::Point*> pointers;
+	for (size_t i = 0; i < sites.size(); i++)
+		pointers.push_back(&sites[i]);
+
+	voronoi::VoronoiQueue queue(pointers);
+	voronoi::VoronoiDCEL dcel;
+	voronoi::VoronoiTree tree(&queue, &dcel);
+	tree.set_sites(&sites[0]);
+	while (queue.isSiteNext()) {
+		voronoi::Point* site = queue.site();
+		queue.pop();
+		tree.InsertParabola(site);
+	}
+
+	int count = 0;
+	tree.root()->WalkPreOrder(std::tr1::bind(CountNode, &count,
+			std::tr1::placeholders::_1));
+	EXPECT_EQ(tree.RBTree<voronoi::Status>::size(), (size_t) count);
+
+	int id = 1;
+	tree.root()->UpdateNodeIDs(&id);
+	voronoi::Node* node = tree.root();
+	while (node->left_child() != NULL)
+		node = node->left_child();
+	int previous = 0;
+	for (; node != NULL; node = node->NextInOrder()) {
+		EXPECT_EQ(previous + 1, node->id());
+		previous = node->id();
+	}
+	EXPECT_EQ(count, previous);
+
+	LOG(INFO) << "Finishing Voronoi's Tree walk test.";
+}
+
+TEST(TreeCheckTest, LinksFollowTheTreeOrder)
+{
+	LOG(INFO) << "Starting Voronoi's Tree links test.";
+
+	std::vector<voronoi::Point> sites;
+	srand(5);
+	for (int i = 0; i < 5000; i++)
+		sites.push_back(voronoi::Point(rand() % 100000 / 100.0,
+				rand() % 100000 / 100.0));
+	std::vector<voronoi::Point*> pointers;
+	for (size_t i = 0; i < sites.size(); i++)
+		pointers.push_back(&sites[i]);
+
+	/* Stop half way, with arcs both inserted and removed. */
+	voronoi::VoronoiQueue queue(pointers);
+	voronoi::VoronoiDCEL dcel;
+	voronoi::VoronoiTree tree(&queue, &dcel);
+	tree.set_sites(&sites[0]);
+	for (size_t events = 0; events < sites.size() * 2; events++) {
+		if (queue.isSiteNext()) {
+			voronoi::Point* site = queue.site();
+			queue.pop();
+			tree.InsertParabola(site);
+		} else {
+			voronoi::CircleEvent event = queue.circle();
+			queue.pop();
+			tree.RemoveParabola(event);
+		}
+	}
+
+	voronoi::Node* node = tree.root();
+	while (node->left_child() != NULL)
+		node = node->left_child();
+	EXPECT_TRUE(node->previous() == NULL);
+	size_t count = 0;
+	for (; node != NULL; node = node->NextInOrder()) {
+		voronoi::Node* next = node->NextInOrder();
+		EXPECT_TRUE(node->next() == next);
+		if (next != NULL) {
+			EXPECT_TRUE(next->previous() == node);
+		}
+		count++;
+	}
+	EXPECT_EQ(tree.RBTree<voronoi::Status>::size(), count);
+
+	LOG(INFO) << "Finishing Voronoi's Tree links test.";
+}
@@ -19,9 +19,8 @@ static double frand(double fmin, double fmax)
 
 int main(void)
 {
-	VoronoiQueue queue;
-	VoronoiDCEL dcel;
-	VoronoiTree tree(&queue, &dcel);
+	std::vector<Point> points;
+	std::vector<Point*> sites;
 
 /*	Point* a = new Point(2, 5);
 	Point* b = new Point(5, 4);
@@ -29,31 +28,42 @@ int main(void)
 	Point* d = new Point(7, 2);
 	Point* e = new Point(6, 1);
 
-	queue.push(a);
-	queue.push(b);
-	queue.push(c);
-	queue.push(d);
-	queue.push(e);
+	sites.push_back(a);
+	sites.push_back(b);
+	sites.push_back(c);
+	sites.push_back(d);
+	sites.push_back(e);
 */
 	srand(time(NULL));
 	for (int i = 0; i < 500; i++)
-		queue.push(new Point(frand(0, 20), frand(0, 20)));
+		points.push_back(Point(frand(0, 20), frand(0, 20)));
+	for (size_t i = 0; i < points.size(); i++)
+		sites.push_back(&points[i]);
 
-	while (!queue.empty()) {
-		Point* x = queue.top();
-		queue.pop();
+	VoronoiQueue queue(sites);
+	VoronoiDCEL dcel;
+	VoronoiTree tree(&queue, &dcel);
 
-		if (x->isCircleEvent()) {
-			if (!x->isFalseAlarm())
-				tree.RemoveParabola(x);
-			delete x;
-		} else {
+	tree.set_sites(points.data());
+	while (!queue.empty()) {
+		if (queue.isSiteNext()) {
+			Point* x = queue.site();
+			queue.pop();
 			tree.InsertParabola(x);
+		} else {
+			CircleEvent event = queue.circle();
+			queue.pop();
+			tree.RemoveParabola(event);
 		}
 	}
 
 	tree.PrintTree();
 
+	const QueueStats& stats = queue.stats();
+	std::cerr << stats.circle_events << " circle events, " << stats.removed
+			<< " removed before the top, at most " << stats.peak_size
+			<< " pending\n";
+
 //	dcel.clear();
 
 //	delete a;